@@ -7,6 +7,8 @@
 #   FFTW_FOUND					... true if fftw is found on the system
 #   FFTW_LIBRARIES				... full path to fftw library
 #   FFTW_INCLUDES				... fftw include directory
+#   FFTW_THREADS_FOUND			... true if the fftw threads library is found
+#   FFTW_THREADS_LIBRARY		... full path to the fftw threads library
 #
 # The following variables will be checked by the function
 #   FFTW_USE_STATIC_LIBS		... if true, only static libraries are found
@@ -74,3 +76,19 @@ endif (FFTW_USE_STATIC_LIBS AND NOT MSVC)
   mark_as_advanced(FFTW_INCLUDE_DIRS FFTW_LIBRARIES)
 
 endif (FFTW_LIBRARIES AND FFTW_INCLUDE_DIRS)
+
+# The thread support is a separate, optional library
+find_library(FFTW_THREADS_LIBRARY
+  NAMES
+    fftw3_threads
+    libfftw3_threads${LIBFFTW_LIB_SUFFIX}
+  PATHS
+    /usr/lib
+    /usr/local/lib
+    /opt/local/lib
+    /sw/lib
+)
+if (FFTW_THREADS_LIBRARY)
+  set(FFTW_THREADS_FOUND TRUE)
+endif (FFTW_THREADS_LIBRARY)
+mark_as_advanced(FFTW_THREADS_LIBRARY)
@@ -69,6 +69,8 @@ endif()
 
 
 target_link_libraries(${PROJECT_NAME} "${CMAKE_BINARY_DIR}/fftw/libfftw3-3.lib")
+# The prebuilt dlls contain the thread support
+target_compile_definitions(${PROJECT_NAME} PRIVATE HAVE_FFTW_THREADS)
 target_include_directories(${PROJECT_NAME} PRIVATE "${CMAKE_BINARY_DIR}/fftw")
 
 file(COPY "${CMAKE_BINARY_DIR}/fftw/fftw3.h" DESTINATION "${CMAKE_SOURCE_DIR}/src")
@@ -1,6 +1,14 @@
 // SPDX-License-Identifier: GPL-2.0+
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <QFileDialog>
+
 #include "DsoConfigAnalysisPage.h"
+#include "sispinbox.h"
+#include "viewconstants.h"
 
 DsoConfigAnalysisPage::DsoConfigAnalysisPage(DsoSettings *settings, QWidget *parent)
     : QWidget(parent), settings(settings) {
@@ -39,6 +47,50 @@ DsoConfigAnalysisPage::DsoConfigAnalysisPage(DsoSettings *settings, QWidget *par
     minimumMagnitudeLayout->addWidget(minimumMagnitudeSpinBox);
     minimumMagnitudeLayout->addWidget(minimumMagnitudeUnitLabel);
 
+    lengthLabel = new QLabel(tr("FFT length"));
+    lengthComboBox = new QComboBox();
+    for (Dso::SpectrumLength length : Dso::SpectrumLengthEnum)
+        lengthComboBox->addItem(Dso::spectrumLengthString(length));
+    lengthComboBox->setCurrentIndex((int)settings->post.spectrumLength);
+
+    threadThresholdLabel = new QLabel(tr("Multithreaded FFT from"));
+    threadThresholdComboBox = new QComboBox();
+    threadThresholdComboBox->addItem(tr("Auto"), 0u);
+    for (unsigned length = 1 << 14; length <= 1 << 22; length *= 2)
+        threadThresholdComboBox->addItem(tr("%L1 samples").arg(length), length);
+    threadThresholdComboBox->addItem(tr("Off"), std::numeric_limits<unsigned>::max());
+    threadThresholdComboBox->setCurrentIndex(
+        std::max(0, threadThresholdComboBox->findData(settings->post.spectrumThreadThreshold)));
+
+    segmentLabel = new QLabel(tr("Welch segment length"));
+    segmentComboBox = new QComboBox();
+    segmentComboBox->addItem(tr("Off"), 0u);
+    for (unsigned segment = 256; segment <= 65536; segment *= 2)
+        segmentComboBox->addItem(QString::number(segment), segment);
+    segmentComboBox->setCurrentIndex(std::max(0, segmentComboBox->findData(settings->post.spectrumSegment)));
+
+    overlapLabel = new QLabel(tr("Welch segment overlap"));
+    overlapSpinBox = new QSpinBox();
+    overlapSpinBox->setMinimum(0);
+    overlapSpinBox->setMaximum(90);
+    overlapSpinBox->setSuffix(tr(" %"));
+    overlapSpinBox->setValue((int)std::lround(settings->post.spectrumOverlap * 100));
+
+    zoomCheckBox = new QCheckBox(tr("Zoom-FFT of the band between the markers"));
+    zoomCheckBox->setChecked(settings->post.spectrumZoom);
+
+    averagingLabel = new QLabel(tr("Averaging"));
+    averagingComboBox = new QComboBox();
+    for (Dso::SpectrumAveraging averaging : Dso::SpectrumAveragingEnum)
+        averagingComboBox->addItem(Dso::spectrumAveragingString(averaging));
+    averagingComboBox->setCurrentIndex((int)settings->post.spectrumAveraging);
+
+    averagesLabel = new QLabel(tr("Averages"));
+    averagesSpinBox = new QSpinBox();
+    averagesSpinBox->setMinimum(1);
+    averagesSpinBox->setMaximum(1000);
+    averagesSpinBox->setValue(settings->post.spectrumAverages);
+
     spectrumLayout = new QGridLayout();
     spectrumLayout->addWidget(windowFunctionLabel, 0, 0);
     spectrumLayout->addWidget(windowFunctionComboBox, 0, 1);
@@ -46,12 +98,294 @@ DsoConfigAnalysisPage::DsoConfigAnalysisPage(DsoSettings *settings, QWidget *par
     spectrumLayout->addLayout(referenceLevelLayout, 1, 1);
     spectrumLayout->addWidget(minimumMagnitudeLabel, 2, 0);
     spectrumLayout->addLayout(minimumMagnitudeLayout, 2, 1);
+    spectrumLayout->addWidget(lengthLabel, 3, 0);
+    spectrumLayout->addWidget(lengthComboBox, 3, 1);
+    spectrumLayout->addWidget(threadThresholdLabel, 4, 0);
+    spectrumLayout->addWidget(threadThresholdComboBox, 4, 1);
+    spectrumLayout->addWidget(segmentLabel, 5, 0);
+    spectrumLayout->addWidget(segmentComboBox, 5, 1);
+    spectrumLayout->addWidget(overlapLabel, 6, 0);
+    spectrumLayout->addWidget(overlapSpinBox, 6, 1);
+    spectrumLayout->addWidget(zoomCheckBox, 7, 0, 1, 2);
+    spectrumLayout->addWidget(averagingLabel, 8, 0);
+    spectrumLayout->addWidget(averagingComboBox, 8, 1);
+    spectrumLayout->addWidget(averagesLabel, 9, 0);
+    spectrumLayout->addWidget(averagesSpinBox, 9, 1);
 
     spectrumGroup = new QGroupBox(tr("Spectrum"));
     spectrumGroup->setLayout(spectrumLayout);
 
+    frequencyEstimatorLabel = new QLabel(tr("Measurement method"));
+    frequencyEstimatorComboBox = new QComboBox();
+    for (Dso::FrequencyEstimator estimator : Dso::FrequencyEstimatorEnum)
+        frequencyEstimatorComboBox->addItem(Dso::frequencyEstimatorString(estimator));
+    frequencyEstimatorComboBox->setCurrentIndex((int)settings->post.frequencyEstimator);
+
+    harmonicsLabel = new QLabel(tr("Highest harmonic (THD)"));
+    harmonicsSpinBox = new QSpinBox();
+    harmonicsSpinBox->setMinimum(0);
+    harmonicsSpinBox->setMaximum(50);
+    harmonicsSpinBox->setSpecialValueText(tr("Off"));
+    harmonicsSpinBox->setValue((int)settings->post.harmonics);
+
+    frequencyLayout = new QGridLayout();
+    frequencyLayout->addWidget(frequencyEstimatorLabel, 0, 0);
+    frequencyLayout->addWidget(frequencyEstimatorComboBox, 0, 1);
+    frequencyLayout->addWidget(harmonicsLabel, 1, 0);
+    frequencyLayout->addWidget(harmonicsSpinBox, 1, 1);
+
+    frequencyGroup = new QGroupBox(tr("Frequency"));
+    frequencyGroup->setLayout(frequencyLayout);
+
+    filterLayout = new QGridLayout();
+    filterLayout->addWidget(new QLabel(tr("Type")), 0, 1);
+    filterLayout->addWidget(new QLabel(tr("Design")), 0, 2);
+    filterLayout->addWidget(new QLabel(tr("Cutoff")), 0, 3);
+    filterLayout->addWidget(new QLabel(tr("Upper edge")), 0, 4);
+    filterLayout->addWidget(new QLabel(tr("Taps")), 0, 5);
+    filterLayout->addWidget(new QLabel(tr("Order")), 0, 6);
+    for (ChannelID channel = 0; channel < settings->post.filter.size(); ++channel) {
+        const DsoSettingsFilter &filter = settings->post.filter[channel];
+        FilterRow row;
+        row.nameLabel = new QLabel(settings->scope.voltage[channel].name);
+        row.typeComboBox = new QComboBox();
+        for (Dso::FilterType type : Dso::FilterTypeEnum) row.typeComboBox->addItem(Dso::filterTypeString(type));
+        row.typeComboBox->setCurrentIndex((int)filter.type);
+        row.designComboBox = new QComboBox();
+        for (Dso::FilterDesign design : Dso::FilterDesignEnum)
+            row.designComboBox->addItem(Dso::filterDesignString(design));
+        row.designComboBox->setCurrentIndex((int)filter.design);
+        row.lowSiSpinBox = new SiSpinBox(UNIT_HERTZ);
+        row.lowSiSpinBox->setMinimum(1e-3);
+        row.lowSiSpinBox->setMaximum(100e6);
+        row.lowSiSpinBox->setValue(filter.low);
+        row.highSiSpinBox = new SiSpinBox(UNIT_HERTZ);
+        row.highSiSpinBox->setMinimum(1e-3);
+        row.highSiSpinBox->setMaximum(100e6);
+        row.highSiSpinBox->setValue(filter.high);
+        row.tapsSpinBox = new QSpinBox();
+        row.tapsSpinBox->setMinimum(3);
+        row.tapsSpinBox->setMaximum(4095);
+        row.tapsSpinBox->setSingleStep(2);
+        row.tapsSpinBox->setValue((int)filter.taps);
+        row.orderSpinBox = new QSpinBox();
+        row.orderSpinBox->setMinimum(2);
+        row.orderSpinBox->setMaximum(16);
+        row.orderSpinBox->setSingleStep(2);
+        row.orderSpinBox->setValue((int)filter.order);
+        row.coefficientsLineEdit = new QLineEdit(filter.coefficients);
+        row.coefficientsLineEdit->setPlaceholderText(tr("Custom taps, e.g. 0.25, 0.5, 0.25"));
+
+        const int layoutRow = 1 + (int)channel * 2;
+        filterLayout->addWidget(row.nameLabel, layoutRow, 0);
+        filterLayout->addWidget(row.typeComboBox, layoutRow, 1);
+        filterLayout->addWidget(row.designComboBox, layoutRow, 2);
+        filterLayout->addWidget(row.lowSiSpinBox, layoutRow, 3);
+        filterLayout->addWidget(row.highSiSpinBox, layoutRow, 4);
+        filterLayout->addWidget(row.tapsSpinBox, layoutRow, 5);
+        filterLayout->addWidget(row.orderSpinBox, layoutRow, 6);
+        filterLayout->addWidget(row.coefficientsLineEdit, layoutRow + 1, 1, 1, 6);
+        filterRows.push_back(row);
+    }
+
+    filterGroup = new QGroupBox(tr("Filter"));
+    filterGroup->setLayout(filterLayout);
+
+    mathChannelsLabel = new QLabel(tr("Math channels (after restart)"));
+    mathChannelsSpinBox = new QSpinBox();
+    mathChannelsSpinBox->setMinimum(1);
+    mathChannelsSpinBox->setMaximum(MATH_CHANNELS_MAX);
+    mathChannelsSpinBox->setValue((int)settings->scope.mathChannels);
+
+    mathLayout = new QGridLayout();
+    mathLayout->addWidget(mathChannelsLabel, 0, 0);
+    mathLayout->addWidget(mathChannelsSpinBox, 0, 1);
+
+    mathGroup = new QGroupBox(tr("Math"));
+    mathGroup->setLayout(mathLayout);
+
+    histogramLabel = new QLabel(tr("Amplitude histogram"));
+    histogramComboBox = new QComboBox();
+    for (Dso::HistogramMode mode : Dso::HistogramModeEnum) histogramComboBox->addItem(Dso::histogramModeString(mode));
+    histogramComboBox->setCurrentIndex((int)settings->post.histogram);
+
+    histogramLayout = new QGridLayout();
+    histogramLayout->addWidget(histogramLabel, 0, 0);
+    histogramLayout->addWidget(histogramComboBox, 0, 1);
+
+    histogramGroup = new QGroupBox(tr("Histogram"));
+    histogramGroup->setLayout(histogramLayout);
+
+    const DsoSettingsMask &mask = settings->post.mask;
+    maskModeComboBox = new QComboBox();
+    for (Dso::MaskMode mode : Dso::MaskModeEnum) maskModeComboBox->addItem(Dso::maskModeString(mode));
+    maskModeComboBox->setCurrentIndex((int)mask.mode);
+    maskChannelComboBox = new QComboBox();
+    for (const DsoSettingsScopeVoltage &voltage : settings->scope.voltage) maskChannelComboBox->addItem(voltage.name);
+    maskChannelComboBox->setCurrentIndex((int)mask.channel);
+    maskTimeToleranceSpinBox = new QDoubleSpinBox();
+    maskTimeToleranceSpinBox->setRange(0.0, DIVS_TIME / 2);
+    maskTimeToleranceSpinBox->setSingleStep(0.05);
+    maskTimeToleranceSpinBox->setSuffix(tr(" div"));
+    maskTimeToleranceSpinBox->setValue(mask.timeTolerance);
+    maskVoltageToleranceSpinBox = new QDoubleSpinBox();
+    maskVoltageToleranceSpinBox->setRange(0.0, DIVS_VOLTAGE / 2);
+    maskVoltageToleranceSpinBox->setSingleStep(0.05);
+    maskVoltageToleranceSpinBox->setSuffix(tr(" div"));
+    maskVoltageToleranceSpinBox->setValue(mask.voltageTolerance);
+    maskPolygonsLineEdit = new QLineEdit(mask.polygons);
+    maskPolygonsLineEdit->setPlaceholderText(tr("x,y x,y x,y; x,y x,y x,y"));
+    maskPolygonsLineEdit->setToolTip(tr("Forbidden regions, the corners in divisions from the center of the screen, "
+                                        "a semicolon starts the next polygon"));
+    maskActionComboBox = new QComboBox();
+    for (Dso::MaskAction action : Dso::MaskActionEnum) maskActionComboBox->addItem(Dso::maskActionString(action));
+    maskActionComboBox->setCurrentIndex((int)mask.action);
+    maskFolderLineEdit = new QLineEdit(mask.folder);
+    maskFolderButton = new QPushButton(tr("..."));
+    connect(maskFolderButton, &QPushButton::clicked, [this]() {
+        const QString folder =
+            QFileDialog::getExistingDirectory(this, tr("Folder for the failed frames"), maskFolderLineEdit->text());
+        if (!folder.isEmpty()) maskFolderLineEdit->setText(folder);
+    });
+
+    maskLayout = new QGridLayout();
+    maskLayout->addWidget(new QLabel(tr("Mask")), 0, 0);
+    maskLayout->addWidget(maskModeComboBox, 0, 1, 1, 2);
+    maskLayout->addWidget(new QLabel(tr("Channel")), 1, 0);
+    maskLayout->addWidget(maskChannelComboBox, 1, 1, 1, 2);
+    maskLayout->addWidget(new QLabel(tr("Horizontal tolerance")), 2, 0);
+    maskLayout->addWidget(maskTimeToleranceSpinBox, 2, 1, 1, 2);
+    maskLayout->addWidget(new QLabel(tr("Vertical tolerance")), 3, 0);
+    maskLayout->addWidget(maskVoltageToleranceSpinBox, 3, 1, 1, 2);
+    maskLayout->addWidget(new QLabel(tr("Polygons")), 4, 0);
+    maskLayout->addWidget(maskPolygonsLineEdit, 4, 1, 1, 2);
+    maskLayout->addWidget(new QLabel(tr("On failure")), 5, 0);
+    maskLayout->addWidget(maskActionComboBox, 5, 1, 1, 2);
+    maskLayout->addWidget(new QLabel(tr("Folder")), 6, 0);
+    maskLayout->addWidget(maskFolderLineEdit, 6, 1);
+    maskLayout->addWidget(maskFolderButton, 6, 2);
+
+    maskGroup = new QGroupBox(tr("Mask test"));
+    maskGroup->setLayout(maskLayout);
+
+    const DsoSettingsDecoder &decoder = settings->post.decoder;
+    decoderProtocolComboBox = new QComboBox();
+    for (Dso::Protocol protocol : Dso::ProtocolEnum) decoderProtocolComboBox->addItem(Dso::protocolString(protocol));
+    decoderProtocolComboBox->setCurrentIndex((int)decoder.protocol);
+    decoderDataComboBox = new QComboBox();
+    decoderClockComboBox = new QComboBox();
+    for (const DsoSettingsScopeVoltage &voltage : settings->scope.voltage) {
+        decoderDataComboBox->addItem(voltage.name);
+        decoderClockComboBox->addItem(voltage.name);
+    }
+    decoderDataComboBox->setCurrentIndex((int)decoder.dataChannel);
+    decoderClockComboBox->setCurrentIndex((int)decoder.clockChannel);
+    decoderAutomaticCheckBox = new QCheckBox(tr("Automatic"));
+    decoderAutomaticCheckBox->setToolTip(tr("The threshold lies in the middle between top and base of each channel"));
+    decoderAutomaticCheckBox->setChecked(decoder.automaticThreshold);
+    decoderThresholdSiSpinBox = new SiSpinBox(UNIT_VOLTS);
+    decoderThresholdSiSpinBox->setMinimum(-1000.0);
+    decoderThresholdSiSpinBox->setMaximum(1000.0);
+    decoderThresholdSiSpinBox->setValue(decoder.threshold);
+    decoderThresholdSiSpinBox->setEnabled(!decoder.automaticThreshold);
+    connect(decoderAutomaticCheckBox, &QCheckBox::toggled,
+            [this](bool checked) { decoderThresholdSiSpinBox->setEnabled(!checked); });
+    decoderBaudRateSpinBox = new QSpinBox();
+    decoderBaudRateSpinBox->setRange(50, 100000000);
+    decoderBaudRateSpinBox->setSuffix(tr(" Bd"));
+    decoderBaudRateSpinBox->setValue((int)decoder.baudRate);
+    decoderDataBitsSpinBox = new QSpinBox();
+    decoderDataBitsSpinBox->setRange(5, 9);
+    decoderDataBitsSpinBox->setValue((int)decoder.dataBits);
+    decoderParityComboBox = new QComboBox();
+    for (Dso::Parity parity : Dso::ParityEnum) decoderParityComboBox->addItem(Dso::parityString(parity));
+    decoderParityComboBox->setCurrentIndex((int)decoder.parity);
+    decoderStopBitsSpinBox = new QSpinBox();
+    decoderStopBitsSpinBox->setRange(1, 2);
+    decoderStopBitsSpinBox->setValue((int)decoder.stopBits);
+    decoderInvertedCheckBox = new QCheckBox(tr("Idle low"));
+    decoderInvertedCheckBox->setChecked(decoder.uartInverted);
+    decoderEdgeComboBox = new QComboBox();
+    decoderEdgeComboBox->addItem(tr("Rising edge"));
+    decoderEdgeComboBox->addItem(tr("Falling edge"));
+    decoderEdgeComboBox->setCurrentIndex(decoder.spiRisingEdge ? 0 : 1);
+    decoderBitOrderComboBox = new QComboBox();
+    decoderBitOrderComboBox->addItem(tr("MSB first"));
+    decoderBitOrderComboBox->addItem(tr("LSB first"));
+    decoderBitOrderComboBox->setCurrentIndex(decoder.spiMsbFirst ? 0 : 1);
+    decoderWordBitsSpinBox = new QSpinBox();
+    decoderWordBitsSpinBox->setRange(4, 32);
+    decoderWordBitsSpinBox->setSuffix(tr(" bits"));
+    decoderWordBitsSpinBox->setValue((int)decoder.spiWordBits);
+
+    decoderLayout = new QGridLayout();
+    decoderLayout->addWidget(new QLabel(tr("Protocol")), 0, 0);
+    decoderLayout->addWidget(decoderProtocolComboBox, 0, 1, 1, 2);
+    decoderLayout->addWidget(new QLabel(tr("Data, SDA")), 1, 0);
+    decoderLayout->addWidget(decoderDataComboBox, 1, 1, 1, 2);
+    decoderLayout->addWidget(new QLabel(tr("Clock, SCL")), 2, 0);
+    decoderLayout->addWidget(decoderClockComboBox, 2, 1, 1, 2);
+    decoderLayout->addWidget(new QLabel(tr("Threshold")), 3, 0);
+    decoderLayout->addWidget(decoderAutomaticCheckBox, 3, 1);
+    decoderLayout->addWidget(decoderThresholdSiSpinBox, 3, 2);
+    decoderLayout->addWidget(new QLabel(tr("UART baud rate")), 4, 0);
+    decoderLayout->addWidget(decoderBaudRateSpinBox, 4, 1);
+    decoderLayout->addWidget(decoderInvertedCheckBox, 4, 2);
+    decoderLayout->addWidget(new QLabel(tr("UART data bits")), 5, 0);
+    decoderLayout->addWidget(decoderDataBitsSpinBox, 5, 1, 1, 2);
+    decoderLayout->addWidget(new QLabel(tr("UART parity")), 6, 0);
+    decoderLayout->addWidget(decoderParityComboBox, 6, 1, 1, 2);
+    decoderLayout->addWidget(new QLabel(tr("UART stop bits")), 7, 0);
+    decoderLayout->addWidget(decoderStopBitsSpinBox, 7, 1, 1, 2);
+    decoderLayout->addWidget(new QLabel(tr("SPI sampling")), 8, 0);
+    decoderLayout->addWidget(decoderEdgeComboBox, 8, 1);
+    decoderLayout->addWidget(decoderBitOrderComboBox, 8, 2);
+    decoderLayout->addWidget(new QLabel(tr("SPI word")), 9, 0);
+    decoderLayout->addWidget(decoderWordBitsSpinBox, 9, 1, 1, 2);
+
+    decoderGroup = new QGroupBox(tr("Protocol decoder"));
+    decoderGroup->setLayout(decoderLayout);
+
+    const DsoSettingsDatalogger &datalogger = settings->post.datalogger;
+    dataloggerCheckBox = new QCheckBox(tr("Log the measurements of the used channels"));
+    dataloggerCheckBox->setChecked(datalogger.enabled);
+    dataloggerFileLabel = new QLabel(tr("Log file"));
+    dataloggerFileLineEdit = new QLineEdit(datalogger.file);
+    dataloggerFileLineEdit->setPlaceholderText(tr("Only the trend, no file"));
+    dataloggerFileButton = new QPushButton(tr("..."));
+    dataloggerMeasurementList = new QListWidget();
+    for (Dso::Measurement measurement : Dso::MeasurementEnum) {
+        QListWidgetItem *item = new QListWidgetItem(Dso::measurementString(measurement), dataloggerMeasurementList);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState((datalogger.measurements & Dso::measurementBit(measurement)) ? Qt::Checked
+                                                                                          : Qt::Unchecked);
+    }
+    connect(dataloggerFileButton, &QPushButton::clicked, [this]() {
+        const QString fileName = QFileDialog::getSaveFileName(this, tr("Log file"), dataloggerFileLineEdit->text(),
+                                                              tr("Comma-Separated Values (*.csv)"), nullptr,
+                                                              QFileDialog::DontConfirmOverwrite);
+        if (!fileName.isEmpty()) dataloggerFileLineEdit->setText(fileName);
+    });
+
+    dataloggerLayout = new QGridLayout();
+    dataloggerLayout->addWidget(dataloggerCheckBox, 0, 0, 1, 3);
+    dataloggerLayout->addWidget(dataloggerFileLabel, 1, 0);
+    dataloggerLayout->addWidget(dataloggerFileLineEdit, 1, 1);
+    dataloggerLayout->addWidget(dataloggerFileButton, 1, 2);
+    dataloggerLayout->addWidget(dataloggerMeasurementList, 2, 0, 1, 3);
+
+    dataloggerGroup = new QGroupBox(tr("Datalogger"));
+    dataloggerGroup->setLayout(dataloggerLayout);
+
     mainLayout = new QVBoxLayout();
     mainLayout->addWidget(spectrumGroup);
+    mainLayout->addWidget(frequencyGroup);
+    mainLayout->addWidget(filterGroup);
+    mainLayout->addWidget(mathGroup);
+    mainLayout->addWidget(histogramGroup);
+    mainLayout->addWidget(maskGroup);
+    mainLayout->addWidget(decoderGroup);
+    mainLayout->addWidget(dataloggerGroup);
     mainLayout->addStretch(1);
 
     setLayout(mainLayout);
@@ -62,4 +396,59 @@ void DsoConfigAnalysisPage::saveSettings() {
     settings->post.spectrumWindow = (Dso::WindowFunction)windowFunctionComboBox->currentIndex();
     settings->post.spectrumReference = referenceLevelSpinBox->value();
     settings->post.spectrumLimit = minimumMagnitudeSpinBox->value();
+    settings->post.spectrumLength = (Dso::SpectrumLength)lengthComboBox->currentIndex();
+    settings->post.spectrumThreadThreshold = threadThresholdComboBox->currentData().toUInt();
+    settings->post.spectrumSegment = segmentComboBox->currentData().toUInt();
+    settings->post.spectrumOverlap = overlapSpinBox->value() / 100.0;
+    settings->post.spectrumZoom = zoomCheckBox->isChecked();
+    settings->post.spectrumAveraging = (Dso::SpectrumAveraging)averagingComboBox->currentIndex();
+    settings->post.spectrumAverages = (unsigned)averagesSpinBox->value();
+    settings->post.frequencyEstimator = (Dso::FrequencyEstimator)frequencyEstimatorComboBox->currentIndex();
+    settings->post.harmonics = (unsigned)harmonicsSpinBox->value();
+    for (ChannelID channel = 0; channel < filterRows.size(); ++channel) {
+        const FilterRow &row = filterRows[channel];
+        DsoSettingsFilter &filter = settings->post.filter[channel];
+        filter.type = (Dso::FilterType)row.typeComboBox->currentIndex();
+        filter.design = (Dso::FilterDesign)row.designComboBox->currentIndex();
+        filter.low = row.lowSiSpinBox->value();
+        filter.high = row.highSiSpinBox->value();
+        filter.taps = (unsigned)row.tapsSpinBox->value() | 1u;
+        filter.order = (unsigned)row.orderSpinBox->value() & ~1u;
+        filter.coefficients = row.coefficientsLineEdit->text().trimmed();
+    }
+    settings->scope.mathChannels = (unsigned)mathChannelsSpinBox->value();
+    settings->post.histogram = (Dso::HistogramMode)histogramComboBox->currentIndex();
+
+    DsoSettingsMask &mask = settings->post.mask;
+    mask.mode = (Dso::MaskMode)maskModeComboBox->currentIndex();
+    mask.channel = (unsigned)maskChannelComboBox->currentIndex();
+    mask.timeTolerance = maskTimeToleranceSpinBox->value();
+    mask.voltageTolerance = maskVoltageToleranceSpinBox->value();
+    mask.polygons = maskPolygonsLineEdit->text().trimmed();
+    mask.action = (Dso::MaskAction)maskActionComboBox->currentIndex();
+    mask.folder = maskFolderLineEdit->text().trimmed();
+
+    DsoSettingsDecoder &decoder = settings->post.decoder;
+    decoder.protocol = (Dso::Protocol)decoderProtocolComboBox->currentIndex();
+    decoder.dataChannel = (unsigned)decoderDataComboBox->currentIndex();
+    decoder.clockChannel = (unsigned)decoderClockComboBox->currentIndex();
+    decoder.automaticThreshold = decoderAutomaticCheckBox->isChecked();
+    decoder.threshold = decoderThresholdSiSpinBox->value();
+    decoder.baudRate = (unsigned)decoderBaudRateSpinBox->value();
+    decoder.dataBits = (unsigned)decoderDataBitsSpinBox->value();
+    decoder.parity = (Dso::Parity)decoderParityComboBox->currentIndex();
+    decoder.stopBits = (unsigned)decoderStopBitsSpinBox->value();
+    decoder.uartInverted = decoderInvertedCheckBox->isChecked();
+    decoder.spiRisingEdge = decoderEdgeComboBox->currentIndex() == 0;
+    decoder.spiMsbFirst = decoderBitOrderComboBox->currentIndex() == 0;
+    decoder.spiWordBits = (unsigned)decoderWordBitsSpinBox->value();
+
+    DsoSettingsDatalogger &datalogger = settings->post.datalogger;
+    datalogger.enabled = dataloggerCheckBox->isChecked();
+    datalogger.file = dataloggerFileLineEdit->text().trimmed();
+    datalogger.measurements = 0;
+    for (Dso::Measurement measurement : Dso::MeasurementEnum) {
+        if (dataloggerMeasurementList->item((int)measurement)->checkState() == Qt::Checked)
+            datalogger.measurements |= Dso::measurementBit(measurement);
+    }
 }
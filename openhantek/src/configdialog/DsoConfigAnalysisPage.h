@@ -11,9 +11,16 @@
 #include <QGroupBox>
 #include <QHBoxLayout>
 #include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QPushButton>
 #include <QSpinBox>
 #include <QVBoxLayout>
 
+#include <vector>
+
+class SiSpinBox;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// \class DsoConfigAnalysisPage                                   configpages.h
 /// \brief Config page for the data analysis.
@@ -45,4 +52,90 @@ class DsoConfigAnalysisPage : public QWidget {
     QDoubleSpinBox *minimumMagnitudeSpinBox;
     QLabel *minimumMagnitudeUnitLabel;
     QHBoxLayout *minimumMagnitudeLayout;
+
+    QLabel *lengthLabel;
+    QComboBox *lengthComboBox;
+
+    QLabel *threadThresholdLabel;
+    QComboBox *threadThresholdComboBox;
+
+    QLabel *segmentLabel;
+    QComboBox *segmentComboBox;
+    QLabel *overlapLabel;
+    QSpinBox *overlapSpinBox;
+
+    QCheckBox *zoomCheckBox;
+
+    QLabel *averagingLabel;
+    QComboBox *averagingComboBox;
+    QLabel *averagesLabel;
+    QSpinBox *averagesSpinBox;
+
+    QGroupBox *frequencyGroup;
+    QGridLayout *frequencyLayout;
+    QLabel *frequencyEstimatorLabel;
+    QComboBox *frequencyEstimatorComboBox;
+    QLabel *harmonicsLabel;
+    QSpinBox *harmonicsSpinBox;
+
+    /// \brief The filter settings of a physical channel.
+    struct FilterRow {
+        QLabel *nameLabel;
+        QComboBox *typeComboBox;
+        QComboBox *designComboBox;
+        SiSpinBox *lowSiSpinBox;
+        SiSpinBox *highSiSpinBox;
+        QSpinBox *tapsSpinBox;
+        QSpinBox *orderSpinBox;
+        QLineEdit *coefficientsLineEdit;
+    };
+
+    QGroupBox *filterGroup;
+    QGridLayout *filterLayout;
+    std::vector<FilterRow> filterRows;
+
+    QGroupBox *mathGroup;
+    QGridLayout *mathLayout;
+    QLabel *mathChannelsLabel;
+    QSpinBox *mathChannelsSpinBox;
+
+    QGroupBox *histogramGroup;
+    QGridLayout *histogramLayout;
+    QLabel *histogramLabel;
+    QComboBox *histogramComboBox;
+
+    QGroupBox *maskGroup;
+    QGridLayout *maskLayout;
+    QComboBox *maskModeComboBox;
+    QComboBox *maskChannelComboBox;
+    QDoubleSpinBox *maskTimeToleranceSpinBox;
+    QDoubleSpinBox *maskVoltageToleranceSpinBox;
+    QLineEdit *maskPolygonsLineEdit;
+    QComboBox *maskActionComboBox;
+    QLineEdit *maskFolderLineEdit;
+    QPushButton *maskFolderButton;
+
+    QGroupBox *decoderGroup;
+    QGridLayout *decoderLayout;
+    QComboBox *decoderProtocolComboBox;
+    QComboBox *decoderDataComboBox;
+    QComboBox *decoderClockComboBox;
+    QCheckBox *decoderAutomaticCheckBox;
+    SiSpinBox *decoderThresholdSiSpinBox;
+    QSpinBox *decoderBaudRateSpinBox;
+    QSpinBox *decoderDataBitsSpinBox;
+    QComboBox *decoderParityComboBox;
+    QSpinBox *decoderStopBitsSpinBox;
+    QCheckBox *decoderInvertedCheckBox;
+    QComboBox *decoderEdgeComboBox;
+    QComboBox *decoderBitOrderComboBox;
+    QSpinBox *decoderWordBitsSpinBox;
+
+    QGroupBox *dataloggerGroup;
+    QGridLayout *dataloggerLayout;
+    QCheckBox *dataloggerCheckBox;
+    QLabel *dataloggerFileLabel;
+    QLineEdit *dataloggerFileLineEdit;
+    QPushButton *dataloggerFileButton;
+    QListWidget *dataloggerMeasurementList; ///< The logged measurements are checked
 };
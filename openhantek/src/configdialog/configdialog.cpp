@@ -133,6 +133,7 @@ void DsoConfigDialog::apply() {
     this->colorsPage->saveSettings();
     this->filesPage->saveSettings();
     this->scopePage->saveSettings();
+    emit applied();
 }
 
 /// \brief Change the config page.
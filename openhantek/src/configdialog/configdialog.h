@@ -31,6 +31,9 @@ class DsoConfigDialog : public QDialog {
 
     void changePage(QListWidgetItem *current, QListWidgetItem *previous);
 
+  signals:
+    void applied(); ///< The settings of the pages have been saved
+
   private:
     void createIcons();
 
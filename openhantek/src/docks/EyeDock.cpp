@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+
+#include <QCheckBox>
+#include <QCloseEvent>
+#include <QComboBox>
+
+#include "EyeDock.h"
+#include "dockwindows.h"
+
+#include "eyeplot.h"
+#include "sispinbox.h"
+#include "utils/printutils.h"
+#include "viewsettings.h"
+
+template<typename... Args> struct SELECT {
+    template<typename C, typename R>
+    static constexpr auto OVERLOAD_OF( R (C::*pmf)(Args...) ) -> decltype(pmf) {
+        return pmf;
+    }
+};
+
+EyeDock::EyeDock(const DsoSettingsScope *scope, DsoSettingsPostProcessing *postprocessing,
+                 const DsoSettingsView *view, QWidget *parent, Qt::WindowFlags flags)
+    : QDockWidget(tr("Eye diagram"), parent, flags), postprocessing(postprocessing), view(view) {
+    DsoSettingsEye &eye = postprocessing->eye;
+
+    channelComboBox = new QComboBox();
+    for (ChannelID channel = 0; channel < scope->voltage.size(); ++channel)
+        channelComboBox->addItem(scope->voltage[channel].name);
+    if (eye.channel >= scope->voltage.size()) eye.channel = 0;
+    channelComboBox->setCurrentIndex((int)eye.channel);
+
+    recoverCheckBox = new QCheckBox(tr("Recovered"));
+    recoverCheckBox->setToolTip(tr("Recover the bit rate from the crossings of the signal"));
+    recoverCheckBox->setChecked(eye.recoverBitRate);
+
+    bitRateSiSpinBox = new SiSpinBox(UNIT_HERTZ);
+    bitRateSiSpinBox->setMinimum(1.0);
+    bitRateSiSpinBox->setMaximum(100e6);
+    bitRateSiSpinBox->setValue(eye.bitRate);
+    bitRateSiSpinBox->setEnabled(!eye.recoverBitRate);
+
+    intervalsComboBox = new QComboBox();
+    intervalsComboBox->addItem(tr("1 UI"));
+    intervalsComboBox->addItem(tr("2 UI"));
+    intervalsComboBox->setCurrentIndex(eye.unitIntervals > 1 ? 1 : 0);
+
+    // The persistence in frames, the decay only supports powers of two
+    persistenceComboBox = new QComboBox();
+    persistenceComboBox->addItem(tr("Infinite"), 0u);
+    for (unsigned frames = 2; frames <= 256; frames *= 2)
+        persistenceComboBox->addItem(tr("%L1 frames").arg(frames), frames);
+    persistenceComboBox->setCurrentIndex(std::max(persistenceComboBox->findData(eye.persistence), 0));
+
+    plot = new EyePlot(&view->screen);
+
+    dockLayout = new QGridLayout();
+    dockLayout->setColumnStretch(0, 1);
+    dockLayout->addWidget(channelComboBox, 0, 0);
+    dockLayout->addWidget(recoverCheckBox, 0, 1);
+    dockLayout->addWidget(bitRateSiSpinBox, 0, 2);
+    dockLayout->addWidget(intervalsComboBox, 0, 3);
+    dockLayout->addWidget(persistenceComboBox, 0, 4);
+    dockLayout->addWidget(plot, 1, 0, 1, 5);
+
+    dockWidget = new QWidget();
+    SetupDockWidget(this, dockWidget, dockLayout);
+    // The plot takes all the space it gets
+    dockWidget->setSizePolicy(QSizePolicy(QSizePolicy::Preferred, QSizePolicy::Expanding));
+
+    connect(channelComboBox, SELECT<int>::OVERLOAD_OF(&QComboBox::currentIndexChanged),
+            [postprocessing](int index) { postprocessing->eye.channel = (unsigned)std::max(index, 0); });
+    connect(recoverCheckBox, &QCheckBox::toggled, [this, postprocessing](bool checked) {
+        postprocessing->eye.recoverBitRate = checked;
+        bitRateSiSpinBox->setEnabled(!checked);
+    });
+    connect(bitRateSiSpinBox, SELECT<double>::OVERLOAD_OF(&QDoubleSpinBox::valueChanged),
+            [postprocessing](double value) { postprocessing->eye.bitRate = value; });
+    connect(intervalsComboBox, SELECT<int>::OVERLOAD_OF(&QComboBox::currentIndexChanged),
+            [postprocessing](int index) { postprocessing->eye.unitIntervals = index > 0 ? 2 : 1; });
+    connect(persistenceComboBox, SELECT<int>::OVERLOAD_OF(&QComboBox::currentIndexChanged), [this, postprocessing]() {
+        postprocessing->eye.persistence = persistenceComboBox->currentData().toUInt();
+    });
+    // Folding the frames costs time, it is only done while the eye is visible
+    connect(this, &QDockWidget::visibilityChanged,
+            [postprocessing](bool visible) { postprocessing->eye.enabled = visible; });
+}
+
+void EyeDock::showData(std::shared_ptr<PPresult> data) {
+    if (!isVisible()) return;
+    const EyeDiagram &eye = data->eye;
+    plot->setData(eye, eye.channel < view->screen.voltage.size() ? view->screen.voltage[eye.channel]
+                                                                 : view->screen.text);
+}
+
+/// \brief Don't close the dock, just hide it
+/// \param event The close event that should be handled.
+void EyeDock::closeEvent(QCloseEvent *event) {
+    this->hide();
+
+    event->accept();
+}
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <memory>
+
+#include <QDockWidget>
+#include <QGridLayout>
+
+#include "post/postprocessingsettings.h"
+#include "post/ppresult.h"
+#include "scopesettings.h"
+
+class QCheckBox;
+class QComboBox;
+
+class EyePlot;
+class SiSpinBox;
+struct DsoSettingsView;
+
+/// \brief Dock window for the eye diagram of a serial signal.
+/// The eye is only accumulated while the dock is shown, the settings take effect with the next frame.
+class EyeDock : public QDockWidget {
+    Q_OBJECT
+
+  public:
+    /// \brief Initializes the eye diagram docking window.
+    /// \param scope The scope settings, for the channel names.
+    /// \param postprocessing The post processing settings, the eye settings are changed here.
+    /// \param view The view settings, for the colors.
+    /// \param parent The parent widget.
+    /// \param flags Flags for the window manager.
+    EyeDock(const DsoSettingsScope *scope, DsoSettingsPostProcessing *postprocessing, const DsoSettingsView *view,
+            QWidget *parent, Qt::WindowFlags flags = 0);
+
+  public slots:
+    /// \brief Shows the eye diagram of a new frame.
+    void showData(std::shared_ptr<PPresult> data);
+
+  protected:
+    void closeEvent(QCloseEvent *event);
+
+    QGridLayout *dockLayout; ///< The main layout for the dock window
+    QWidget *dockWidget;     ///< The main widget for the dock window
+
+    QComboBox *channelComboBox;     ///< Select the folded channel
+    QCheckBox *recoverCheckBox;     ///< Recover the bit rate from the signal
+    SiSpinBox *bitRateSiSpinBox;    ///< The configured bit rate
+    QComboBox *intervalsComboBox;   ///< Select one or two unit intervals
+    QComboBox *persistenceComboBox; ///< Select the frames until old hits fade
+    EyePlot *plot;
+
+    DsoSettingsPostProcessing *postprocessing;
+    const DsoSettingsView *view;
+};
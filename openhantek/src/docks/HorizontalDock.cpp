@@ -5,7 +5,9 @@
 #include <QComboBox>
 #include <QDockWidget>
 #include <QLabel>
+#include <QPushButton>
 #include <QSignalBlocker>
+#include <QSpinBox>
 #include <QCoreApplication>
 
 #include <cmath>
@@ -55,6 +57,17 @@ HorizontalDock::HorizontalDock(DsoSettingsScope *scope, QWidget *parent, Qt::Win
     for (Dso::GraphFormat format: Dso::GraphFormatEnum)
         this->formatComboBox->addItem(Dso::graphFormatString(format));
 
+    this->segmentsLabel = new QLabel(tr("Segments"));
+    this->segmentsSpinBox = new QSpinBox();
+    this->segmentsSpinBox->setRange(0, 1000);
+    this->segmentsSpinBox->setSpecialValueText(tr("Off"));
+
+    this->segmentLabel = new QLabel(tr("Segment"));
+    this->segmentSpinBox = new QSpinBox();
+    this->segmentSpinBox->setEnabled(false);
+    this->replayButton = new QPushButton(tr("Replay"));
+    this->replayButton->setEnabled(false);
+
     this->dockLayout = new QGridLayout();
     this->dockLayout->setColumnMinimumWidth(0, 64);
     this->dockLayout->setColumnStretch(1, 1);
@@ -68,6 +81,11 @@ HorizontalDock::HorizontalDock(DsoSettingsScope *scope, QWidget *parent, Qt::Win
     this->dockLayout->addWidget(this->recordLengthComboBox, 3, 1);
     this->dockLayout->addWidget(this->formatLabel, 4, 0);
     this->dockLayout->addWidget(this->formatComboBox, 4, 1);
+    this->dockLayout->addWidget(this->segmentsLabel, 5, 0);
+    this->dockLayout->addWidget(this->segmentsSpinBox, 5, 1);
+    this->dockLayout->addWidget(this->segmentLabel, 6, 0);
+    this->dockLayout->addWidget(this->segmentSpinBox, 6, 1);
+    this->dockLayout->addWidget(this->replayButton, 7, 1);
 
     this->dockWidget = new QWidget();
     SetupDockWidget(this, dockWidget, dockLayout);
@@ -78,6 +96,13 @@ HorizontalDock::HorizontalDock(DsoSettingsScope *scope, QWidget *parent, Qt::Win
     connect(this->frequencybaseSiSpinBox, SELECT<double>::OVERLOAD_OF(&QDoubleSpinBox::valueChanged), this, &HorizontalDock::frequencybaseSelected);
     connect(this->recordLengthComboBox, SELECT<int>::OVERLOAD_OF(&QComboBox::currentIndexChanged), this, &HorizontalDock::recordLengthSelected);
     connect(this->formatComboBox, SELECT<int>::OVERLOAD_OF(&QComboBox::currentIndexChanged), this, &HorizontalDock::formatSelected);
+    connect(this->segmentsSpinBox, SELECT<int>::OVERLOAD_OF(&QSpinBox::valueChanged), [this](int segments) {
+        this->scope->horizontal.segments = (unsigned)segments;
+        emit segmentsChanged((unsigned)segments);
+    });
+    connect(this->segmentSpinBox, SELECT<int>::OVERLOAD_OF(&QSpinBox::valueChanged),
+            [this](int segment) { emit segmentSelected((unsigned)segment - 1); });
+    connect(this->replayButton, &QPushButton::clicked, this, &HorizontalDock::replayRequested);
 
     // Set values
     this->setSamplerate(scope->horizontal.samplerate);
@@ -85,6 +110,7 @@ HorizontalDock::HorizontalDock(DsoSettingsScope *scope, QWidget *parent, Qt::Win
     this->setFrequencybase(scope->horizontal.frequencybase);
     // this->setRecordLength(scope->horizontal.recordLength);
     this->setFormat(scope->horizontal.format);
+    this->segmentsSpinBox->setValue((int)scope->horizontal.segments);
 }
 
 /// \brief Don't close the dock, just hide it.
@@ -212,3 +238,13 @@ void HorizontalDock::formatSelected(int index) {
     scope->horizontal.format = (Dso::GraphFormat)index;
     emit formatChanged(scope->horizontal.format);
 }
+
+void HorizontalDock::setSegmentsCaptured(unsigned count, unsigned capacity) {
+    QSignalBlocker blocker(segmentSpinBox);
+    segmentSpinBox->setRange(count ? 1 : 0, (int)count);
+    segmentSpinBox->setSuffix(tr(" / %1").arg(capacity));
+    // Browsing starts when the sequence is complete
+    segmentSpinBox->setEnabled(count && count == capacity);
+    segmentSpinBox->setValue(1);
+    replayButton->setEnabled(count && count == capacity);
+}
@@ -12,6 +12,8 @@
 class QLabel;
 class QCheckBox;
 class QComboBox;
+class QPushButton;
+class QSpinBox;
 
 class SiSpinBox;
 
@@ -59,6 +61,10 @@ class HorizontalDock : public QDockWidget {
     /// \param mode The mode value the spin box should accept.
     /// \param steps The steps value the spin box should accept.
     void setSamplerateSteps(int mode, QList<double> sampleSteps);
+    /// \brief Updates the segment selection after segments have been captured.
+    /// \param count The number of captured segments.
+    /// \param capacity The number of segments per sequence.
+    void setSegmentsCaptured(unsigned count, unsigned capacity);
 
   protected:
     void closeEvent(QCloseEvent *event);
@@ -76,6 +82,11 @@ class HorizontalDock : public QDockWidget {
     QComboBox *recordLengthComboBox;   ///< Selects the record length for aquisitions
     QComboBox *formatComboBox;         ///< Selects the way the sampled data is
                                        /// interpreted and shown
+    QLabel *segmentsLabel;             ///< The label for the segment count spinbox
+    QLabel *segmentLabel;              ///< The label for the segment selection spinbox
+    QSpinBox *segmentsSpinBox;         ///< Selects the segments per sequence, 0 for live acquisitions
+    QSpinBox *segmentSpinBox;          ///< Selects the captured segment that is shown
+    QPushButton *replayButton;         ///< Shows all captured segments one after another
 
     DsoSettingsScope *scope; ///< The settings provided by the parent class
     QList<double> timebaseSteps;     ///< Steps for the timebase spinbox
@@ -95,4 +106,7 @@ class HorizontalDock : public QDockWidget {
     void timebaseChanged(double timebase);                ///< The timebase has been changed
     void recordLengthChanged(unsigned long recordLength); ///< The recordd length has been changed
     void formatChanged(Dso::GraphFormat format);          ///< The viewing format has been changed
+    void segmentsChanged(unsigned segments);              ///< The segments per sequence have been changed
+    void segmentSelected(unsigned index);                 ///< A captured segment should be shown
+    void replayRequested();                               ///< All captured segments should be shown
 };
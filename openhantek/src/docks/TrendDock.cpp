@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+
+#include <QCloseEvent>
+#include <QComboBox>
+#include <QDateTime>
+#include <QTimer>
+
+#include "TrendDock.h"
+#include "dockwindows.h"
+
+#include "post/datalogger.h"
+#include "trendplot.h"
+#include "viewsettings.h"
+
+template<typename... Args> struct SELECT {
+    template<typename C, typename R>
+    static constexpr auto OVERLOAD_OF( R (C::*pmf)(Args...) ) -> decltype(pmf) {
+        return pmf;
+    }
+};
+
+TrendDock::TrendDock(const DsoSettingsScope *scope, const DsoSettingsView *view, const TrendStore *trend,
+                     QWidget *parent, Qt::WindowFlags flags)
+    : QDockWidget(tr("Trend"), parent, flags), scope(scope), view(view), trend(trend) {
+
+    channelComboBox = new QComboBox();
+    for (ChannelID channel = 0; channel < scope->voltage.size(); ++channel)
+        channelComboBox->addItem(scope->voltage[channel].name);
+
+    measurementComboBox = new QComboBox();
+    for (Dso::Measurement measurement : Dso::MeasurementEnum)
+        measurementComboBox->addItem(Dso::measurementString(measurement), QVariant((int)measurement));
+    measurementComboBox->setCurrentIndex((int)Dso::Measurement::PEAK_TO_PEAK);
+
+    // The ranges in seconds
+    rangeComboBox = new QComboBox();
+    rangeComboBox->addItem(tr("10 minutes"), 600.0);
+    rangeComboBox->addItem(tr("1 hour"), 3600.0);
+    rangeComboBox->addItem(tr("6 hours"), 6 * 3600.0);
+    rangeComboBox->addItem(tr("1 day"), 24 * 3600.0);
+    rangeComboBox->addItem(tr("1 week"), 7 * 24 * 3600.0);
+    rangeComboBox->addItem(tr("4 weeks"), 28 * 24 * 3600.0);
+    rangeComboBox->setCurrentIndex(1);
+
+    plot = new TrendPlot(&view->screen);
+
+    dockLayout = new QGridLayout();
+    dockLayout->setColumnStretch(1, 1);
+    dockLayout->addWidget(channelComboBox, 0, 0);
+    dockLayout->addWidget(measurementComboBox, 0, 1);
+    dockLayout->addWidget(rangeComboBox, 0, 2);
+    dockLayout->addWidget(plot, 1, 0, 1, 3);
+
+    dockWidget = new QWidget();
+    SetupDockWidget(this, dockWidget, dockLayout);
+    // The plot takes all the space it gets
+    dockWidget->setSizePolicy(QSizePolicy(QSizePolicy::Preferred, QSizePolicy::Expanding));
+
+    connect(channelComboBox, SELECT<int>::OVERLOAD_OF(&QComboBox::currentIndexChanged), this, &TrendDock::refresh);
+    connect(measurementComboBox, SELECT<int>::OVERLOAD_OF(&QComboBox::currentIndexChanged), this,
+            &TrendDock::refresh);
+    connect(rangeComboBox, SELECT<int>::OVERLOAD_OF(&QComboBox::currentIndexChanged), this, &TrendDock::refresh);
+
+    refreshTimer = new QTimer(this);
+    connect(refreshTimer, &QTimer::timeout, this, &TrendDock::refresh);
+    refreshTimer->start(1000);
+}
+
+void TrendDock::refresh() {
+    // Nothing is read from the store while the dock is hidden
+    if (!isVisible() || channelComboBox->currentIndex() < 0) return;
+
+    const ChannelID channel = (ChannelID)channelComboBox->currentIndex();
+    const Dso::Measurement measurement = (Dso::Measurement)measurementComboBox->currentData().toInt();
+    const double to = QDateTime::currentMSecsSinceEpoch() / 1000.0;
+    const double from = to - rangeComboBox->currentData().toDouble();
+
+    // At most one bucket per pixel, this selects the coarsest level that is needed
+    unsigned level = 0;
+    std::vector<TrendStore::Bucket> buckets =
+        trend->query(Datalogger::seriesIndex(channel, measurement), from, to, (unsigned)std::max(plot->width(), 1),
+                     &level);
+    plot->setData(std::move(buckets), TrendStore::width(level), from, to, measurement,
+                  view->screen.voltage[channel]);
+}
+
+/// \brief Don't close the dock, just hide it
+/// \param event The close event that should be handled.
+void TrendDock::closeEvent(QCloseEvent *event) {
+    this->hide();
+
+    event->accept();
+}
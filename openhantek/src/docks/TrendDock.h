@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <QDockWidget>
+#include <QGridLayout>
+
+#include "scopesettings.h"
+
+class QComboBox;
+class QTimer;
+
+class TrendPlot;
+class TrendStore;
+struct DsoSettingsView;
+
+/// \brief Dock window for the long-term trend of the logged measurements.
+/// It shows one measurement of one channel over a selectable range, the plot is refreshed every second.
+class TrendDock : public QDockWidget {
+    Q_OBJECT
+
+  public:
+    /// \brief Initializes the trend docking window.
+    /// \param scope The scope settings, for the channel names.
+    /// \param view The view settings, for the colors.
+    /// \param trend The store of the datalogger.
+    /// \param parent The parent widget.
+    /// \param flags Flags for the window manager.
+    TrendDock(const DsoSettingsScope *scope, const DsoSettingsView *view, const TrendStore *trend, QWidget *parent,
+              Qt::WindowFlags flags = 0);
+
+  public slots:
+    /// \brief Reads the selected range from the store and plots it.
+    void refresh();
+
+  protected:
+    void closeEvent(QCloseEvent *event);
+
+    QGridLayout *dockLayout; ///< The main layout for the dock window
+    QWidget *dockWidget;     ///< The main widget for the dock window
+
+    QComboBox *channelComboBox;     ///< Select the channel
+    QComboBox *measurementComboBox; ///< Select the measurement
+    QComboBox *rangeComboBox;       ///< Select the shown time range
+    TrendPlot *plot;
+    QTimer *refreshTimer;
+
+    const DsoSettingsScope *scope;
+    const DsoSettingsView *view;
+    const TrendStore *trend;
+};
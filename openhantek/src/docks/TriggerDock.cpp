@@ -17,6 +17,13 @@
 #include "sispinbox.h"
 #include "utils/printutils.h"
 
+template<typename... Args> struct SELECT {
+    template<typename C, typename R>
+    static constexpr auto OVERLOAD_OF( R (C::*pmf)(Args...) ) -> decltype(pmf) {
+        return pmf;
+    }
+};
+
 TriggerDock::TriggerDock(DsoSettingsScope *scope, const Dso::ControlSpecification *spec, QWidget *parent,
                          Qt::WindowFlags flags)
     : QDockWidget(tr("Trigger"), parent, flags), scope(scope), mSpec(spec) {
@@ -41,6 +48,36 @@ TriggerDock::TriggerDock(DsoSettingsScope *scope, const Dso::ControlSpecificatio
     this->sourceComboBox->addItems(this->sourceStandardStrings);
     this->sourceComboBox->addItems(this->sourceSpecialStrings);
 
+    // Only the software trigger knows other types than edges
+    if (mSpec->isSoftwareTriggerDevice)
+        for (Dso::TriggerType type : Dso::TriggerTypeEnum) this->types.push_back(type);
+    else
+        this->types.push_back(Dso::TriggerType::Edge);
+
+    this->typeLabel = new QLabel(tr("Type"));
+    this->typeComboBox = new QComboBox();
+    for (Dso::TriggerType type : this->types) this->typeComboBox->addItem(Dso::triggerTypeString(type));
+
+    this->conditionLabel = new QLabel(tr("Condition"));
+    this->conditionComboBox = new QComboBox();
+    for (Dso::TriggerCondition condition : Dso::TriggerConditionEnum)
+        this->conditionComboBox->addItem(Dso::triggerConditionString(condition));
+
+    this->timeLabel = new QLabel(tr("Time"));
+    this->timeSiSpinBox = new SiSpinBox(UNIT_SECONDS);
+    this->timeSiSpinBox->setMinimum(1e-9);
+    this->timeSiSpinBox->setMaximum(1e2);
+
+    this->timeMaxLabel = new QLabel(tr("Time max"));
+    this->timeMaxSiSpinBox = new SiSpinBox(UNIT_SECONDS);
+    this->timeMaxSiSpinBox->setMinimum(1e-9);
+    this->timeMaxSiSpinBox->setMaximum(1e2);
+
+    this->levelSpanLabel = new QLabel(tr("Level span"));
+    this->levelSpanSiSpinBox = new SiSpinBox(UNIT_VOLTS);
+    this->levelSpanSiSpinBox->setMinimum(1e-3);
+    this->levelSpanSiSpinBox->setMaximum(1e2);
+
     this->dockLayout = new QGridLayout();
     this->dockLayout->setColumnMinimumWidth(0, 64);
     this->dockLayout->setColumnStretch(1, 1);
@@ -50,6 +87,16 @@ TriggerDock::TriggerDock(DsoSettingsScope *scope, const Dso::ControlSpecificatio
     this->dockLayout->addWidget(this->sourceComboBox, 1, 1);
     this->dockLayout->addWidget(this->slopeLabel, 2, 0);
     this->dockLayout->addWidget(this->slopeComboBox, 2, 1);
+    this->dockLayout->addWidget(this->typeLabel, 3, 0);
+    this->dockLayout->addWidget(this->typeComboBox, 3, 1);
+    this->dockLayout->addWidget(this->conditionLabel, 4, 0);
+    this->dockLayout->addWidget(this->conditionComboBox, 4, 1);
+    this->dockLayout->addWidget(this->timeLabel, 5, 0);
+    this->dockLayout->addWidget(this->timeSiSpinBox, 5, 1);
+    this->dockLayout->addWidget(this->timeMaxLabel, 6, 0);
+    this->dockLayout->addWidget(this->timeMaxSiSpinBox, 6, 1);
+    this->dockLayout->addWidget(this->levelSpanLabel, 7, 0);
+    this->dockLayout->addWidget(this->levelSpanSiSpinBox, 7, 1);
 
     this->dockWidget = new QWidget();
     SetupDockWidget(this, dockWidget, dockLayout);
@@ -58,6 +105,11 @@ TriggerDock::TriggerDock(DsoSettingsScope *scope, const Dso::ControlSpecificatio
     setMode(scope->trigger.mode);
     setSlope(scope->trigger.slope);
     setSource(scope->trigger.special, scope->trigger.source);
+    setType(scope->trigger.type);
+    this->conditionComboBox->setCurrentIndex((int)scope->trigger.condition);
+    this->timeSiSpinBox->setValue(scope->trigger.time);
+    this->timeMaxSiSpinBox->setValue(scope->trigger.timeMax);
+    this->levelSpanSiSpinBox->setValue(scope->trigger.levelSpan);
 
     // Connect signals and slots
     connect(this->modeComboBox, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
@@ -83,6 +135,37 @@ TriggerDock::TriggerDock(DsoSettingsScope *scope, const Dso::ControlSpecificatio
                 this->scope->trigger.special = special;
                 emit sourceChanged(special, (unsigned)index);
             });
+    connect(this->typeComboBox, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+            [this](int index) {
+                this->scope->trigger.type = this->types[(unsigned)index];
+                updateTypeWidgets();
+                emit typeChanged(this->scope->trigger.type);
+            });
+    connect(this->conditionComboBox, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+            [this](int index) {
+                this->scope->trigger.condition = (Dso::TriggerCondition)index;
+                updateTypeWidgets();
+                emit timingChanged(this->scope->trigger.condition, this->scope->trigger.time,
+                                   this->scope->trigger.timeMax);
+            });
+    connect(this->timeSiSpinBox, SELECT<double>::OVERLOAD_OF(&QDoubleSpinBox::valueChanged), [this](double time) {
+        this->scope->trigger.time = time;
+        // Keep the range valid
+        if (this->scope->trigger.timeMax < time) this->timeMaxSiSpinBox->setValue(time);
+        emit timingChanged(this->scope->trigger.condition, this->scope->trigger.time, this->scope->trigger.timeMax);
+    });
+    connect(this->timeMaxSiSpinBox, SELECT<double>::OVERLOAD_OF(&QDoubleSpinBox::valueChanged),
+            [this](double timeMax) {
+                this->scope->trigger.timeMax = timeMax;
+                if (this->scope->trigger.time > timeMax) this->timeSiSpinBox->setValue(timeMax);
+                emit timingChanged(this->scope->trigger.condition, this->scope->trigger.time,
+                                   this->scope->trigger.timeMax);
+            });
+    connect(this->levelSpanSiSpinBox, SELECT<double>::OVERLOAD_OF(&QDoubleSpinBox::valueChanged),
+            [this](double span) {
+                this->scope->trigger.levelSpan = span;
+                emit levelSpanChanged(span);
+            });
 }
 
 /// \brief Don't close the dock, just hide it
@@ -114,3 +197,23 @@ void TriggerDock::setSource(bool special, unsigned int id) {
     QSignalBlocker blocker(sourceComboBox);
     sourceComboBox->setCurrentIndex(index);
 }
+
+void TriggerDock::setType(Dso::TriggerType type) {
+    auto it = std::find(types.begin(), types.end(), type);
+    if (it == types.end()) return;
+    QSignalBlocker blocker(typeComboBox);
+    typeComboBox->setCurrentIndex((int)(it - types.begin()));
+    updateTypeWidgets();
+}
+
+void TriggerDock::updateTypeWidgets() {
+    const Dso::TriggerType type = scope->trigger.type;
+    const bool timed = type == Dso::TriggerType::PulseWidth || type == Dso::TriggerType::SlewRate;
+    const bool twoLevels =
+        type == Dso::TriggerType::Runt || type == Dso::TriggerType::Window || type == Dso::TriggerType::SlewRate;
+
+    conditionComboBox->setEnabled(timed);
+    timeSiSpinBox->setEnabled(timed || type == Dso::TriggerType::Timeout);
+    timeMaxSiSpinBox->setEnabled(timed && scope->trigger.condition == Dso::TriggerCondition::Range);
+    levelSpanSiSpinBox->setEnabled(twoLevels);
+}
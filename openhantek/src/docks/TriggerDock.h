@@ -8,6 +8,8 @@
 #include <QCheckBox>
 #include <QComboBox>
 
+#include <vector>
+
 #include "hantekdso/enums.h"
 
 class SiSpinBox;
@@ -17,7 +19,7 @@ struct ControlSpecification;
 }
 
 /// \brief Dock window for the trigger settings.
-/// It contains the settings for the trigger mode, source and slope.
+/// It contains the settings for the trigger mode, source, slope and type.
 class TriggerDock : public QDockWidget {
     Q_OBJECT
 
@@ -42,25 +44,46 @@ class TriggerDock : public QDockWidget {
     /// \param slope The trigger slope.
     void setSlope(Dso::Slope slope);
 
+    /// \brief Changes the trigger type if the new type is supported.
+    /// \param type The trigger type.
+    void setType(Dso::TriggerType type);
+
   protected:
+    /// \brief Enables the time and level widgets that are used by the current trigger type.
+    void updateTypeWidgets();
+
     void closeEvent(QCloseEvent *event);
 
-    QGridLayout *dockLayout;   ///< The main layout for the dock window
-    QWidget *dockWidget;       ///< The main widget for the dock window
-    QLabel *modeLabel;         ///< The label for the trigger mode combobox
-    QLabel *sourceLabel;       ///< The label for the trigger source combobox
-    QLabel *slopeLabel;        ///< The label for the trigger slope combobox
-    QComboBox *modeComboBox;   ///< Select the triggering mode
-    QComboBox *sourceComboBox; ///< Select the source for triggering
-    QComboBox *slopeComboBox;  ///< Select the slope that causes triggering
+    QGridLayout *dockLayout;       ///< The main layout for the dock window
+    QWidget *dockWidget;           ///< The main widget for the dock window
+    QLabel *modeLabel;             ///< The label for the trigger mode combobox
+    QLabel *sourceLabel;           ///< The label for the trigger source combobox
+    QLabel *slopeLabel;            ///< The label for the trigger slope combobox
+    QComboBox *modeComboBox;       ///< Select the triggering mode
+    QComboBox *sourceComboBox;     ///< Select the source for triggering
+    QComboBox *slopeComboBox;      ///< Select the slope that causes triggering
+    QLabel *typeLabel;             ///< The label for the trigger type combobox
+    QLabel *conditionLabel;        ///< The label for the time condition combobox
+    QLabel *timeLabel;             ///< The label for the trigger time spinbox
+    QLabel *timeMaxLabel;          ///< The label for the maximum trigger time spinbox
+    QLabel *levelSpanLabel;        ///< The label for the level span spinbox
+    QComboBox *typeComboBox;       ///< Select the signal condition that causes triggering
+    QComboBox *conditionComboBox;  ///< Select the comparison of the measured duration
+    SiSpinBox *timeSiSpinBox;      ///< Select the trigger time
+    SiSpinBox *timeMaxSiSpinBox;   ///< Select the upper time limit for ranges
+    SiSpinBox *levelSpanSiSpinBox; ///< Select the distance of the upper level
 
     DsoSettingsScope *scope; ///< The settings provided by the parent class
     const Dso::ControlSpecification* mSpec;
 
-    QStringList sourceStandardStrings; ///< Strings for the standard trigger sources
-    QStringList sourceSpecialStrings;  ///< Strings for the special trigger sources
+    QStringList sourceStandardStrings;   ///< Strings for the standard trigger sources
+    QStringList sourceSpecialStrings;    ///< Strings for the special trigger sources
+    std::vector<Dso::TriggerType> types; ///< Trigger types supported by the device
   signals:
     void modeChanged(Dso::TriggerMode);                ///< The trigger mode has been changed
     void sourceChanged(bool special, unsigned int id); ///< The trigger source has been changed
     void slopeChanged(Dso::Slope);                     ///< The trigger slope has been changed
+    void typeChanged(Dso::TriggerType);                ///< The trigger type has been changed
+    void timingChanged(Dso::TriggerCondition condition, double time, double timeMax); ///< Trigger times changed
+    void levelSpanChanged(double span);                ///< The distance of the upper level has been changed
 };
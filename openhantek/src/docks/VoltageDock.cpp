@@ -5,6 +5,7 @@
 #include <QComboBox>
 #include <QDockWidget>
 #include <QLabel>
+#include <QLineEdit>
 #include <QSignalBlocker>
 
 #include <cmath>
@@ -12,6 +13,7 @@
 #include "VoltageDock.h"
 #include "dockwindows.h"
 
+#include "post/mathexpression.h"
 #include "settings.h"
 #include "sispinbox.h"
 #include "utils/printutils.h"
@@ -42,6 +44,7 @@ VoltageDock::VoltageDock(DsoSettingsScope *scope, const Dso::ControlSpecificatio
     dockLayout->setColumnStretch(1, 1);
 
     // Initialize elements
+    int row = 0;
     for (ChannelID channel = 0; channel < scope->voltage.size(); ++channel) {
         ChannelBlock b;
 
@@ -49,6 +52,10 @@ VoltageDock::VoltageDock(DsoSettingsScope *scope, const Dso::ControlSpecificatio
         b.gainComboBox=(new QComboBox());
         b.invertCheckBox=(new QCheckBox(tr("Invert")));
         b.usedCheckBox=(new QCheckBox(scope->voltage[channel].name));
+        if (channel >= spec->channels) {
+            b.expressionLineEdit = new QLineEdit(scope->voltage[channel].mathExpression);
+            b.expressionLineEdit->setPlaceholderText(tr("e.g. CH1*CH2, abs(CH1), d/dt(M1)"));
+        }
 
         channelBlocks.push_back(std::move(b));
 
@@ -59,15 +66,16 @@ VoltageDock::VoltageDock(DsoSettingsScope *scope, const Dso::ControlSpecificatio
 
         b.gainComboBox->addItems(gainStrings);
 
-        dockLayout->addWidget(b.usedCheckBox, (int)channel * 3, 0);
-        dockLayout->addWidget(b.gainComboBox, (int)channel * 3, 1);
-        dockLayout->addWidget(b.miscComboBox, (int)channel * 3 + 1, 1);
-        dockLayout->addWidget(b.invertCheckBox, (int)channel * 3 + 2, 1);
+        dockLayout->addWidget(b.usedCheckBox, row, 0);
+        dockLayout->addWidget(b.gainComboBox, row++, 1);
+        dockLayout->addWidget(b.miscComboBox, row++, 1);
+        if (b.expressionLineEdit) dockLayout->addWidget(b.expressionLineEdit, row++, 1);
+        dockLayout->addWidget(b.invertCheckBox, row++, 1);
 
         if (channel < spec->channels)
             setCoupling(channel, scope->voltage[channel].couplingOrMathIndex);
         else
-            setMode(scope->voltage[channel].couplingOrMathIndex);
+            setMode(channel, scope->voltage[channel].couplingOrMathIndex);
         setGain(channel, scope->voltage[channel].gainStepIndex);
         setUsed(channel, scope->voltage[channel].used);
 
@@ -83,9 +91,15 @@ VoltageDock::VoltageDock(DsoSettingsScope *scope, const Dso::ControlSpecificatio
             if (channel < spec->channels) {
                 emit couplingChanged(channel, scope->coupling(channel, spec));
             } else {
-                emit modeChanged(Dso::getMathMode(this->scope->voltage[channel]));
+                channelBlocks[channel].expressionLineEdit->setEnabled(
+                    Dso::getMathMode(this->scope->voltage[channel]) == Dso::MathMode::EXPRESSION);
+                emit modeChanged(channel, Dso::getMathMode(this->scope->voltage[channel]));
             }
         });
+        if (b.expressionLineEdit) {
+            connect(b.expressionLineEdit, &QLineEdit::editingFinished,
+                    [this, channel]() { updateExpression(channel); });
+        }
         connect(b.usedCheckBox, &QAbstractButton::toggled, [this,channel](bool checked) {
             this->scope->voltage[channel].used = checked;
             emit usedChanged(channel, checked);
@@ -117,9 +131,35 @@ void VoltageDock::setGain(ChannelID channel, unsigned gainStepIndex) {
     channelBlocks[channel].gainComboBox->setCurrentIndex((unsigned)gainStepIndex);
 }
 
-void VoltageDock::setMode(unsigned mathModeIndex) {
-    QSignalBlocker blocker(channelBlocks[spec->channels].miscComboBox);
-    channelBlocks[spec->channels].miscComboBox->setCurrentIndex((int)mathModeIndex);
+void VoltageDock::setMode(ChannelID channel, unsigned mathModeIndex) {
+    if (channel < spec->channels || channel >= scope->voltage.size()) return;
+    QSignalBlocker blocker(channelBlocks[channel].miscComboBox);
+    channelBlocks[channel].miscComboBox->setCurrentIndex((int)mathModeIndex);
+    channelBlocks[channel].expressionLineEdit->setEnabled((Dso::MathMode)mathModeIndex == Dso::MathMode::EXPRESSION);
+}
+
+void VoltageDock::updateExpression(ChannelID channel) {
+    QLineEdit *lineEdit = channelBlocks[channel].expressionLineEdit;
+    const QString text = lineEdit->text().trimmed();
+
+    // Invalid expressions are marked, the last valid one stays active
+    MathExpression expression;
+    QString error;
+    QPalette palette = lineEdit->palette();
+    if (!expression.compile(text, spec->channels, scope->countChannels() - spec->channels, &error)) {
+        palette.setColor(QPalette::Text, Qt::red);
+        lineEdit->setPalette(palette);
+        lineEdit->setToolTip(error);
+        return;
+    }
+    palette.setColor(QPalette::Text, this->palette().color(QPalette::Text));
+    lineEdit->setPalette(palette);
+    lineEdit->setToolTip(QString());
+
+    if (text == scope->voltage[channel].mathExpression) return;
+    scope->voltage[channel].mathExpression = text;
+    emit expressionChanged(channel, text);
+    emit modeChanged(channel, Dso::getMathMode(scope->voltage[channel]));
 }
 
 void VoltageDock::setUsed(ChannelID channel, bool used) {
@@ -7,6 +7,7 @@
 #include <QCheckBox>
 #include <QComboBox>
 #include <QLabel>
+#include <QLineEdit>
 
 #include "scopesettings.h"
 #include "hantekdso/controlspecification.h"
@@ -37,9 +38,10 @@ class VoltageDock : public QDockWidget {
     /// \param gain The gain in volts.
     void setGain(ChannelID channel, unsigned gainStepIndex);
 
-    /// \brief Sets the mode for the math channel.
+    /// \brief Sets the mode for a math channel.
+    /// \param channel The math channel, whose mode should be set.
     /// \param mathModeIndex The math-mode index.
-    void setMode(unsigned mathModeIndex);
+    void setMode(ChannelID channel, unsigned mathModeIndex);
 
     /// \brief Enables/disables a channel.
     /// \param channel The channel, that should be enabled/disabled.
@@ -57,8 +59,13 @@ class VoltageDock : public QDockWidget {
         QComboBox * gainComboBox;   ///< Select the vertical gain for the channels
         QComboBox * miscComboBox;   ///< Select coupling for real and mode for math channels
         QCheckBox * invertCheckBox; ///< Select if the channels should be displayed inverted
+        QLineEdit * expressionLineEdit = nullptr; ///< The expression of math channels
     };
 
+    /// \brief Compiles the entered expression and stores it, if it is valid.
+    /// \param channel The math channel.
+    void updateExpression(ChannelID channel);
+
     std::vector<ChannelBlock> channelBlocks;
 
     DsoSettingsScope *scope; ///< The settings provided by the parent class
@@ -71,6 +78,7 @@ class VoltageDock : public QDockWidget {
   signals:
     void couplingChanged(ChannelID channel, Dso::Coupling coupling); ///< A coupling has been selected
     void gainChanged(ChannelID channel, double gain);                ///< A gain has been selected
-    void modeChanged(Dso::MathMode mode);              ///< The mode for the math channels has been changed
+    void modeChanged(ChannelID channel, Dso::MathMode mode); ///< The mode or expression of a math channel changed
+    void expressionChanged(ChannelID channel, const QString &expression); ///< A valid expression has been entered
     void usedChanged(ChannelID channel, bool used); ///< A channel has been enabled/disabled
 };
@@ -25,6 +25,8 @@ void registerDockMetaTypes() {
     qRegisterMetaType<Dso::TriggerMode>();
     qRegisterMetaType<Dso::MathMode>();
     qRegisterMetaType<Dso::Slope>();
+    qRegisterMetaType<Dso::TriggerType>();
+    qRegisterMetaType<Dso::TriggerCondition>();
     qRegisterMetaType<Dso::Coupling>();
     qRegisterMetaType<Dso::GraphFormat>();
     qRegisterMetaType<Dso::ChannelMode>();
@@ -1,18 +1,22 @@
 // SPDX-License-Identifier: GPL-2.0+
 
+#include <algorithm>
 #include <cmath>
 
 #include <QApplication>
 #include <QFileDialog>
 #include <QGridLayout>
+#include <QHelpEvent>
 #include <QLabel>
 #include <QSignalBlocker>
 #include <QTimer>
+#include <QToolTip>
 
 #include "dsowidget.h"
 
 #include "post/postprocessingsettings.h"
 #include "post/graphgenerator.h"
+#include "post/measurementstatistics.h"
 #include "post/ppresult.h"
 
 #include "utils/printutils.h"
@@ -21,15 +25,18 @@
 #include "scopesettings.h"
 #include "viewconstants.h"
 #include "viewsettings.h"
+#include "widgets/annotationrow.h"
 #include "widgets/levelslider.h"
 #include "widgets/datagrid.h"
 
 static int zoomScopeRow = 0;
+static int spectrogramRow = 0;
 
 DsoWidget::DsoWidget(DsoSettingsScope *scope, DsoSettingsView *view, const Dso::ControlSpecification *spec,
                      QWidget *parent, Qt::WindowFlags flags)
     : QWidget(parent, flags), scope(scope), view(view), spec(spec), mainScope(GlScope::createNormal(scope, view)),
-      zoomScope(GlScope::createZoomed(scope, view)) {
+      zoomScope(GlScope::createZoomed(scope, view)), spectrogram(new GlSpectrogram(scope, view)),
+      annotations(new AnnotationRow(scope, &view->screen)) {
 
     // Palette for this widget
     QPalette palette;
@@ -71,8 +78,13 @@ DsoWidget::DsoWidget(DsoSettingsScope *scope, DsoSettingsView *view, const Dso::
     swTriggerStatus->setAlignment(Qt::AlignCenter);
     swTriggerStatus->setAutoFillBackground(true);
     swTriggerStatus->setVisible(false);
+    maskStatus = new QLabel();
+    maskStatus->setAlignment(Qt::AlignCenter);
+    maskStatus->setAutoFillBackground(true);
+    maskStatus->setVisible(false);
     settingsLayout = new QHBoxLayout();
     settingsLayout->addWidget(swTriggerStatus);
+    settingsLayout->addWidget(maskStatus);
     settingsLayout->addWidget(settingsTriggerLabel);
     settingsLayout->addWidget(settingsRecordLengthLabel, 1);
     settingsLayout->addWidget(settingsSamplerateLabel, 1);
@@ -111,6 +123,8 @@ DsoWidget::DsoWidget(DsoSettingsScope *scope, DsoSettingsView *view, const Dso::
     measurementLayout->setColumnStretch(3, 2);
     measurementLayout->setColumnStretch(4, 3);
     measurementLayout->setColumnStretch(5, 3);
+    measurementLayout->setColumnStretch(6, 5);
+    measuredData.resize(scope->voltage.size());
     for (ChannelID channel = 0; channel < scope->voltage.size(); ++channel) {
         tablePalette.setColor(QPalette::WindowText, view->screen.voltage[channel]);
         measurementNameLabel.push_back(new QLabel(scope->voltage[channel].name));
@@ -127,9 +141,13 @@ DsoWidget::DsoWidget(DsoSettingsScope *scope, DsoSettingsView *view, const Dso::
         measurementAmplitudeLabel.push_back(new QLabel());
         measurementAmplitudeLabel[channel]->setAlignment(Qt::AlignRight);
         measurementAmplitudeLabel[channel]->setPalette(palette);
+        measurementAmplitudeLabel[channel]->installEventFilter(this);
         measurementFrequencyLabel.push_back(new QLabel());
         measurementFrequencyLabel[channel]->setAlignment(Qt::AlignRight);
         measurementFrequencyLabel[channel]->setPalette(palette);
+        measurementDistortionLabel.push_back(new QLabel());
+        measurementDistortionLabel[channel]->setAlignment(Qt::AlignRight);
+        measurementDistortionLabel[channel]->setPalette(palette);
         setMeasurementVisible(channel);
         measurementLayout->addWidget(measurementNameLabel[channel], (int)channel, 0);
         measurementLayout->addWidget(measurementMiscLabel[channel], (int)channel, 1);
@@ -137,10 +155,11 @@ DsoWidget::DsoWidget(DsoSettingsScope *scope, DsoSettingsView *view, const Dso::
         measurementLayout->addWidget(measurementMagnitudeLabel[channel], (int)channel, 3);
         measurementLayout->addWidget(measurementAmplitudeLabel[channel], (int)channel, 4);
         measurementLayout->addWidget(measurementFrequencyLabel[channel], (int)channel, 5);
+        measurementLayout->addWidget(measurementDistortionLabel[channel], (int)channel, 6);
         if ((unsigned)channel < spec->channels)
             updateVoltageCoupling((unsigned)channel);
         else
-            updateMathMode();
+            updateMathMode((unsigned)channel);
         updateVoltageDetails((unsigned)channel);
         updateSpectrumDetails((unsigned)channel);
     }
@@ -211,6 +230,9 @@ DsoWidget::DsoWidget(DsoSettingsScope *scope, DsoSettingsView *view, const Dso::
     mainLayout->addWidget(mainSliders.triggerLevelSlider, row + 1, 4, 3, 2, Qt::AlignLeft);
     mainLayout->addWidget(mainSliders.markerSlider, row + 3, 2, 2, 3, Qt::AlignTop);
     row += 5;
+    // The decoded packets directly below the main scope, aligned with its screen
+    annotations->setVisible(false);
+    mainLayout->addWidget(annotations, row++, 3);
     // Separators and markerLayout
     mainLayout->setRowMinimumHeight(row++, 5);
     mainLayout->addLayout(markerLayout, row++, 1, 1, 5);
@@ -222,6 +244,9 @@ DsoWidget::DsoWidget(DsoSettingsScope *scope, DsoSettingsView *view, const Dso::
     mainLayout->addWidget(zoomSliders.triggerPositionSlider, row, 2, 2, 3, Qt::AlignBottom);
     mainLayout->addWidget(zoomSliders.triggerLevelSlider, row + 1, 4, 3, 2, Qt::AlignLeft);
     row += 5;
+    // Spectrogram below the zoomed scope, aligned with the scope screens
+    spectrogramRow = row++;
+    mainLayout->addWidget(spectrogram, spectrogramRow, 3);
     // Separator and embedded measurementLayout
     mainLayout->setRowMinimumHeight(row++, 8);
     mainLayout->addLayout(measurementLayout, row++, 1, 1, 5);
@@ -359,6 +384,8 @@ void DsoWidget::setMeasurementVisible(ChannelID channel) {
     if (!visible) {
         measurementGainLabel[channel]->setText(QString());
         measurementAmplitudeLabel[channel]->setText(QString());
+        measuredData[channel].measurements = Measurements();
+        measuredData[channel].statistics.clear();
         measurementFrequencyLabel[channel]->setText(QString());
     }
 
@@ -367,6 +394,9 @@ void DsoWidget::setMeasurementVisible(ChannelID channel) {
 
     measurementMagnitudeLabel[channel]->setVisible(scope->spectrum[channel].used);
     if (!scope->spectrum[channel].used) { measurementMagnitudeLabel[channel]->setText(QString()); }
+
+    measurementDistortionLabel[channel]->setVisible(scope->spectrum[channel].used);
+    if (!scope->spectrum[channel].used) { measurementDistortionLabel[channel]->setText(QString()); }
 }
 
 static QString markerToString(DsoSettingsScope *scope, unsigned index) {
@@ -452,9 +482,12 @@ void DsoWidget::updateTriggerDetails() {
     settingsTriggerLabel->setPalette(tablePalette);
     QString levelString = valueToString(scope->voltage[scope->trigger.source].trigger, UNIT_VOLTS, 3);
     QString pretriggerString = tr("%L1%").arg((int)(scope->trigger.position * 100 + 0.5));
+    QString slopeString = Dso::slopeString(scope->trigger.slope);
+    if (scope->trigger.type != Dso::TriggerType::Edge)
+        slopeString = Dso::triggerTypeString(scope->trigger.type) + " " + slopeString;
     settingsTriggerLabel->setText(tr("%1  %2  %3  %4")
-                                      .arg(scope->voltage[scope->trigger.source].name,
-                                           Dso::slopeString(scope->trigger.slope), levelString, pretriggerString));
+                                      .arg(scope->voltage[scope->trigger.source].name, slopeString, levelString,
+                                           pretriggerString));
 
     /// \todo This won't work for special trigger sources
 }
@@ -475,6 +508,8 @@ void DsoWidget::updateVoltageDetails(ChannelID channel) {
 /// \param frequencybase The frequencybase used for displaying the trace.
 void DsoWidget::updateFrequencybase(double frequencybase) {
     settingsFrequencybaseLabel->setText(valueToString(frequencybase, UNIT_HERTZ, 4) + tr("/div"));
+    // The columns of the older rows belong to another frequency axis
+    spectrogram->clear();
 }
 
 /// \brief Updates the samplerate field after changing the samplerate.
@@ -516,6 +551,9 @@ void DsoWidget::updateTriggerMode() { updateTriggerDetails(); }
 /// \brief Handles slopeChanged signal from the trigger dock.
 void DsoWidget::updateTriggerSlope() { updateTriggerDetails(); }
 
+/// \brief Handles typeChanged signal from the trigger dock.
+void DsoWidget::updateTriggerType() { updateTriggerDetails(); }
+
 /// \brief Handles sourceChanged signal from the trigger dock.
 void DsoWidget::updateTriggerSource() {
     // Change the colors of the trigger sliders
@@ -547,9 +585,9 @@ void DsoWidget::updateVoltageCoupling(ChannelID channel) {
 }
 
 /// \brief Handles modeChanged signal from the voltage dock.
-void DsoWidget::updateMathMode() {
-    measurementMiscLabel[spec->channels]->setText(
-        Dso::mathModeString(Dso::getMathMode(scope->voltage[spec->channels])));
+/// \param channel The math channel whose mode or expression was changed.
+void DsoWidget::updateMathMode(ChannelID channel) {
+    measurementMiscLabel[channel]->setText(Dso::mathChannelString(scope->voltage[channel]));
 }
 
 /// \brief Handles gainChanged signal from the voltage dock.
@@ -614,10 +652,53 @@ void DsoWidget::updateZoom(bool enabled) {
     repaint();
 }
 
+/// \brief Show/hide the spectrogram.
+void DsoWidget::updateSpectrogram(bool enabled) {
+    mainLayout->setRowStretch(spectrogramRow, enabled ? 1 : 0);
+    spectrogram->setVisible(enabled);
+    // Rows that were skipped while hidden would leave a gap in the history
+    if (enabled) spectrogram->clear();
+
+    repaint();
+}
+
+/// \brief Lists the level and timing measurements of a channel with their statistics.
+QString DsoWidget::measurementsToString(const DataChannel &data) {
+    if (!data.measurements.valid) return QString();
+
+    QString text = QString("<table><tr><th></th><th>%1</th><th>%2</th><th>%3</th>"
+                           "<th>%4</th><th>%5</th><th>%6</th></tr>")
+                       .arg(tr("Current"), tr("Minimum"), tr("Maximum"), tr("Mean"), tr("Std. dev."), tr("Count"));
+    for (Dso::Measurement measurement : Dso::MeasurementEnum) {
+        double value;
+        const bool measured = MeasurementStatistics::value(data, measurement, value);
+        const unsigned index = (unsigned)measurement;
+        const bool hasStatistics = index < data.statistics.size() && data.statistics[index].count > 0;
+        if (!measured && !hasStatistics) continue;
+        auto format = [measurement](double value) { return MeasurementStatistics::valueString(measurement, value); };
+
+        text += QString("<tr><td>%1</td><td align=\"right\">%2</td>")
+                    .arg(Dso::measurementString(measurement), measured ? format(value) : QString("-"));
+        if (hasStatistics) {
+            const MeasurementStatistic &statistic = data.statistics[index];
+            text += QString("<td align=\"right\">%1</td><td align=\"right\">%2</td><td align=\"right\">%3</td>"
+                            "<td align=\"right\">%4</td><td align=\"right\">%L5</td>")
+                        .arg(format(statistic.minimum), format(statistic.maximum), format(statistic.mean),
+                             format(statistic.deviation()))
+                        .arg(statistic.count);
+        }
+        text += "</tr>";
+    }
+    return text + "</table>";
+}
+
 /// \brief Prints analyzed data.
 void DsoWidget::showNew(std::shared_ptr<PPresult> data) {
     mainScope->showData(data);
     zoomScope->showData(data);
+    if (view->spectrogram) spectrogram->showData(data);
+    annotations->setVisible(data->decode.decoded);
+    if (data->decode.decoded) annotations->setData(data->decode);
 
     if (spec->isSoftwareTriggerDevice) {
         QPalette triggerLabelPalette = palette();
@@ -627,20 +708,60 @@ void DsoWidget::showNew(std::shared_ptr<PPresult> data) {
         swTriggerStatus->setVisible(true);
     }
 
+    const MaskTestResult &maskTest = data->maskTest;
+    maskStatus->setVisible(maskTest.tested);
+    if (maskTest.tested) {
+        QPalette maskLabelPalette = palette();
+        maskLabelPalette.setColor(QPalette::WindowText, Qt::black);
+        maskLabelPalette.setColor(QPalette::Background, maskTest.hits ? Qt::red : Qt::green);
+        maskStatus->setPalette(maskLabelPalette);
+        maskStatus->setText(tr("Mask %1/%2").arg(maskTest.failedFrames).arg(maskTest.frames));
+        maskStatus->setToolTip(tr("%1 of %2 frames failed\n%3 hits in this frame, %4 in total")
+                                   .arg(maskTest.failedFrames)
+                                   .arg(maskTest.frames)
+                                   .arg(maskTest.hits)
+                                   .arg(maskTest.totalHits));
+    }
+
     updateRecordLength(data.get()->sampleCount());
 
     for (ChannelID channel = 0; channel < scope->voltage.size(); ++channel) {
         if (scope->voltage[channel].used && data.get()->data(channel)) {
-            // Amplitude string representation (4 significant digits)
+            // Amplitude string representation (4 significant digits), the other measurements as tooltip
             measurementAmplitudeLabel[channel]->setText(
-                valueToString(data.get()->data(channel)->computeAmplitude(), UNIT_VOLTS, 4));
+                valueToString(data.get()->data(channel)->measurements.peakToPeak, UNIT_VOLTS, 4));
+            // The tooltip is built from them when it is shown
+            measuredData[channel].measurements = data.get()->data(channel)->measurements;
+            measuredData[channel].statistics = data.get()->data(channel)->statistics;
             // Frequency string representation (5 significant digits)
             measurementFrequencyLabel[channel]->setText(
                 valueToString(data.get()->data(channel)->frequency, UNIT_HERTZ, 5));
+            // Distortion and noise, only measured if the spectrum is shown
+            const HarmonicAnalysis &harmonics = data.get()->data(channel)->harmonics;
+            if (harmonics.valid)
+                measurementDistortionLabel[channel]->setText(tr("THD %1  SINAD %2  ENOB %L3")
+                                                                 .arg(valueToString(harmonics.thd, UNIT_DECIBEL, 3))
+                                                                 .arg(valueToString(harmonics.sinad, UNIT_DECIBEL, 3))
+                                                                 .arg(harmonics.enob, 0, 'f', 1));
+            else
+                measurementDistortionLabel[channel]->setText(QString());
         }
     }
 }
 
+bool DsoWidget::eventFilter(QObject *watched, QEvent *event) {
+    if (event->type() != QEvent::ToolTip) return QWidget::eventFilter(watched, event);
+    const auto label = std::find(measurementAmplitudeLabel.begin(), measurementAmplitudeLabel.end(), watched);
+    if (label == measurementAmplitudeLabel.end()) return QWidget::eventFilter(watched, event);
+
+    const QString text = measurementsToString(measuredData[(size_t)(label - measurementAmplitudeLabel.begin())]);
+    if (text.isEmpty())
+        QToolTip::hideText();
+    else
+        QToolTip::showText(static_cast<QHelpEvent *>(event)->globalPos(), text, *label);
+    return true;
+}
+
 void DsoWidget::showEvent(QShowEvent *event) {
     QWidget::showEvent(event);
     // Apply settings and update measured values
@@ -650,6 +771,7 @@ void DsoWidget::showEvent(QShowEvent *event) {
     updateSamplerate(scope->horizontal.samplerate);
     updateTimebase(scope->horizontal.timebase);
     updateZoom(view->zoom);
+    updateSpectrogram(view->spectrogram);
 
     updateTriggerSource();
     adaptTriggerPositionSlider();
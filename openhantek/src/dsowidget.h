@@ -9,13 +9,17 @@
 #include <memory>
 
 #include "glscope.h"
+#include "glspectrogram.h"
 #include "levelslider.h"
 #include "hantekdso/controlspecification.h"
+#include "post/ppresult.h"
 
 class SpectrumGenerator;
+struct DataChannel;
 struct DsoSettingsScope;
 struct DsoSettingsView;
 class DataGrid;
+class AnnotationRow;
 
 /// \brief The widget for the oszilloscope-screen
 /// This widget contains the scopes and all level sliders.
@@ -43,6 +47,8 @@ class DsoWidget : public QWidget {
 
   protected:
     virtual void showEvent(QShowEvent *event);
+    /// \brief Builds the tooltip of the measurements only when it is shown.
+    virtual bool eventFilter(QObject *watched, QEvent *event) override;
     void setupSliders(Sliders &sliders);
     void adaptTriggerLevelSlider(DsoWidget::Sliders &sliders, ChannelID channel);
     void adaptTriggerPositionSlider();
@@ -54,6 +60,8 @@ class DsoWidget : public QWidget {
 
     double mainToZoom(double position) const;
     double zoomToMain(double position) const;
+    /// \brief Lists the level and timing measurements of a channel and their statistics for the tooltip.
+    static QString measurementsToString(const DataChannel &data);
 
     Sliders mainSliders;
     Sliders zoomSliders;
@@ -68,6 +76,7 @@ class DsoWidget : public QWidget {
     QLabel *settingsFrequencybaseLabel; ///< The frequencybase of the main scope
 
     QLabel *swTriggerStatus;    ///< The status of SW trigger
+    QLabel *maskStatus;         ///< The failed frames of the mask test
 
     QHBoxLayout *markerLayout;        ///< The table for the marker details
     QLabel *markerInfoLabel;          ///< The info about the zoom factor
@@ -81,8 +90,10 @@ class DsoWidget : public QWidget {
     std::vector<QLabel *> measurementGainLabel;      ///< The gain for the voltage (V/div)
     std::vector<QLabel *> measurementMagnitudeLabel; ///< The magnitude for the spectrum (dB/div)
     std::vector<QLabel *> measurementMiscLabel;      ///< Coupling or math mode
-    std::vector<QLabel *> measurementAmplitudeLabel; ///< Amplitude of the signal (V)
+    std::vector<QLabel *> measurementAmplitudeLabel; ///< Peak-to-peak, all measurements as tooltip
     std::vector<QLabel *> measurementFrequencyLabel; ///< Frequency of the signal (Hz)
+    std::vector<QLabel *> measurementDistortionLabel; ///< THD, SINAD and ENOB of the signal
+    std::vector<DataChannel> measuredData; ///< Latest measurements and statistics of each channel for the tooltip
 
     DataGrid *cursorDataGrid;
 
@@ -92,6 +103,8 @@ class DsoWidget : public QWidget {
 
     GlScope *mainScope;     ///< The main scope screen
     GlScope *zoomScope;     ///< The optional magnified scope screen
+    GlSpectrogram *spectrogram; ///< The optional spectrogram of the spectrum channels
+    AnnotationRow *annotations; ///< The packets of the protocol decoder below the main scope
 
   public slots:
     // Horizontal axis
@@ -103,6 +116,7 @@ class DsoWidget : public QWidget {
     // Trigger
     void updateTriggerMode();
     void updateTriggerSlope();
+    void updateTriggerType();
     void updateTriggerSource();
 
     // Spectrum
@@ -111,7 +125,7 @@ class DsoWidget : public QWidget {
 
     // Vertical axis
     void updateVoltageCoupling(ChannelID channel);
-    void updateMathMode();
+    void updateMathMode(ChannelID channel);
     void updateVoltageGain(ChannelID channel);
     void updateVoltageUsed(ChannelID channel, bool used);
 
@@ -120,6 +134,7 @@ class DsoWidget : public QWidget {
 
     // Scope control
     void updateZoom(bool enabled);
+    void updateSpectrogram(bool enabled);
     void updateCursorGrid(bool enabled);
 
   private slots:
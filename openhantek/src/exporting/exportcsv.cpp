@@ -6,6 +6,8 @@
 #include "settings.h"
 #include "iconfont/QtAwesome.h"
 
+#include <cmath>
+
 #include <QCoreApplication>
 #include <QTextStream>
 #include <QFile>
@@ -49,6 +51,7 @@ bool ExporterCSV::save() {
     bool isSpectrumUsed = false;
     double timeInterval = 0;
     double freqInterval = 0;
+    double freqStart = 0;
 
     for (ChannelID channel = 0; channel < chCount; ++channel) {
         if (data->data(channel)) {
@@ -61,6 +64,7 @@ bool ExporterCSV::save() {
                 spectrumData[channel] = &(data->data(channel)->spectrum);
                 maxRow = std::max(maxRow, spectrumData[channel]->sample.size());
                 freqInterval = data->data(channel)->spectrum.interval;
+                freqStart = data->data(channel)->spectrum.start;
                 isSpectrumUsed = true;
             }
         }
@@ -92,7 +96,7 @@ bool ExporterCSV::save() {
         }
 
         if (isSpectrumUsed) {
-            csvStream << "," << freqInterval * row;
+            csvStream << "," << freqStart + freqInterval * row;
             for (ChannelID channel = 0; channel < chCount; ++channel) {
                 if (spectrumData[channel] != nullptr) {
                     csvStream << ",";
@@ -103,6 +107,49 @@ bool ExporterCSV::save() {
         csvStream << "\n";
     }
 
+    // The distortion measurements follow the samples as a separate table
+    bool isHarmonicsValid = false;
+    unsigned harmonicCount = 0;
+    for (ChannelID channel = 0; channel < chCount; ++channel) {
+        if (spectrumData[channel] != nullptr && data->data(channel)->harmonics.valid) {
+            isHarmonicsValid = true;
+            harmonicCount = std::max(harmonicCount, (unsigned)data->data(channel)->harmonics.harmonics.size());
+        }
+    }
+    if (isHarmonicsValid) {
+        csvStream << "\n\"channel\",\"fundamental\",\"amplitude\",\"THD\",\"THD+N\",\"SNR\",\"SINAD\",\"ENOB\"";
+        for (unsigned harmonic = 0; harmonic < harmonicCount; ++harmonic) csvStream << ",\"H" << harmonic + 2 << "\"";
+        csvStream << "\n";
+
+        for (ChannelID channel = 0; channel < chCount; ++channel) {
+            if (spectrumData[channel] == nullptr) continue;
+            const HarmonicAnalysis &harmonics = data->data(channel)->harmonics;
+            if (!harmonics.valid) continue;
+            csvStream << "\"" << registry->settings->scope.spectrum[channel].name << "\"," << harmonics.fundamental
+                      << "," << harmonics.amplitude << "," << harmonics.thd << "," << harmonics.thdN << ","
+                      << harmonics.snr << "," << harmonics.sinad << "," << harmonics.enob;
+            for (unsigned harmonic = 0; harmonic < harmonicCount; ++harmonic) {
+                csvStream << ",";
+                if (harmonic < harmonics.harmonics.size() && std::isfinite(harmonics.harmonics[harmonic]))
+                    csvStream << harmonics.harmonics[harmonic];
+            }
+            csvStream << "\n";
+        }
+    }
+
+    // The decoded packets follow as another table
+    if (data->decode.decoded && !data->decode.packets.empty()) {
+        csvStream << "\n\"start\",\"end\",\"type\",\"value\",\"read\",\"acknowledged\",\"error\"\n";
+        for (const DecodedPacket &packet : data->decode.packets) {
+            const char *type = "data";
+            if (packet.type == DecodedPacket::Type::ADDRESS) type = "address";
+            if (packet.type == DecodedPacket::Type::START) type = "start";
+            if (packet.type == DecodedPacket::Type::STOP) type = "stop";
+            csvStream << packet.start << "," << packet.end << ",\"" << type << "\"," << packet.value << ","
+                      << (int)packet.read << "," << (int)packet.acknowledged << "," << (int)packet.error << "\n";
+        }
+    }
+
     csvFile.close();
 
     return true;
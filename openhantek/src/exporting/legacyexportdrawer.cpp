@@ -81,9 +81,8 @@ bool LegacyExportDrawer::exportSamples(const PPresult *result, QPaintDevice* pai
                     painter.drawText(QRectF(lineHeight * 4, top, lineHeight * 2, lineHeight),
                                      Dso::couplingString(settings->scope.coupling(channel, deviceSpecification)));
                 else
-                    painter.drawText(
-                        QRectF(lineHeight * 4, top, lineHeight * 2, lineHeight),
-                        Dso::mathModeString(Dso::getMathMode(settings->scope.voltage[channel])));
+                    painter.drawText(QRectF(lineHeight * 4, top, lineHeight * 2, lineHeight),
+                                     Dso::mathChannelString(settings->scope.voltage[channel]));
 
                 // Print voltage gain
                 painter.drawText(QRectF(lineHeight * 6, top, stretchBase * 2, lineHeight),
@@ -101,7 +100,7 @@ bool LegacyExportDrawer::exportSamples(const PPresult *result, QPaintDevice* pai
                 // Amplitude string representation (4 significant digits)
                 painter.setPen(colorValues->text);
                 painter.drawText(QRectF(lineHeight * 6 + stretchBase * 4, top, stretchBase * 3, lineHeight),
-                                 valueToString(result->data(channel)->computeAmplitude(), UNIT_VOLTS, 4),
+                                 valueToString(result->data(channel)->measurements.peakToPeak, UNIT_VOLTS, 4),
                                  QTextOption(Qt::AlignRight));
                 // Frequency string representation (5 significant digits)
                 painter.drawText(QRectF(lineHeight * 6 + stretchBase * 7, top, stretchBase * 3, lineHeight),
@@ -208,25 +207,29 @@ bool LegacyExportDrawer::exportSamples(const PPresult *result, QPaintDevice* pai
                         // What's the horizontal distance between sampling points?
                         double horizontalFactor =
                             result->data(channel)->spectrum.interval / settings->scope.horizontal.frequencybase;
+                        // A zoomed spectrum doesn't start at 0 Hz
+                        double horizontalStart =
+                            result->data(channel)->spectrum.start / settings->scope.horizontal.frequencybase;
                         // How many samples are visible?
                         double centerPosition, centerOffset;
                         if (zoomed) {
-                            centerPosition = (zoomOffset + DIVS_TIME / 2) / horizontalFactor;
+                            centerPosition = (zoomOffset + DIVS_TIME / 2 - horizontalStart) / horizontalFactor;
                             centerOffset = DIVS_TIME / horizontalFactor / zoomFactor / 2;
                         } else {
-                            centerPosition = DIVS_TIME / 2 / horizontalFactor;
+                            centerPosition = (DIVS_TIME / 2 - horizontalStart) / horizontalFactor;
                             centerOffset = DIVS_TIME / horizontalFactor / 2;
                         }
-                        unsigned int firstPosition = qMax((int)(centerPosition - centerOffset), 0);
-                        unsigned int lastPosition = qMin((int)(centerPosition + centerOffset),
-                                                         (int)result->data(channel)->spectrum.sample.size() - 1);
+                        int firstPosition = qMax((int)(centerPosition - centerOffset), 0);
+                        int lastPosition = qMin((int)(centerPosition + centerOffset),
+                                                (int)result->data(channel)->spectrum.sample.size() - 1);
+                        if (lastPosition < firstPosition) continue;
 
                         // Draw graph
                         QPointF *graph = new QPointF[lastPosition - firstPosition + 1];
 
-                        for (unsigned int position = firstPosition; position <= lastPosition; ++position)
+                        for (int position = firstPosition; position <= lastPosition; ++position)
                             graph[position - firstPosition] =
-                                QPointF(position * horizontalFactor - DIVS_TIME / 2,
+                                QPointF(horizontalStart + position * horizontalFactor - DIVS_TIME / 2,
                                         result->data(channel)->spectrum.sample[position] /
                                                 settings->scope.spectrum[channel].magnitude +
                                             settings->scope.spectrum[channel].offset);
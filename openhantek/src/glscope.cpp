@@ -387,9 +387,16 @@ void GlScope::paintGL() {
         }
         ++historyIndex;
     }
+    if (!m_GraphHistory.empty() && scope->horizontal.format == Dso::GraphFormat::TY) drawMask(m_GraphHistory.front());
 
     if (zoomed) { m_program->setUniformValue(matrixLocation, pmvMatrix); }
 
+    // The histogram stays at the left edge of the screen, it doesn't depend on the time axis
+    if (!m_GraphHistory.empty()) {
+        for (ChannelID channel = 0; channel < scope->voltage.size(); ++channel)
+            drawHistogramGraph(channel, m_GraphHistory.front());
+    }
+
     drawGrid();
     m_program->release();
 }
@@ -581,6 +588,24 @@ void GlScope::drawVoltageChannelGraph(ChannelID channel, Graph &graph, int histo
     context()->functions()->glDrawArrays(dMode, 0, v.second);
 }
 
+void GlScope::drawHistogramGraph(ChannelID channel, Graph &graph) {
+    if (!scope->voltage[channel].used || channel >= graph.vaoHistogram.size()) return;
+    Graph::VaoCount &v = graph.vaoHistogram[channel];
+    if (!v.second) return;
+
+    m_program->setUniformValue(colorLocation, view->screen.voltage[channel].darker(150));
+    QOpenGLVertexArrayObject::Binder b(v.first);
+    context()->functions()->glDrawArrays(GL_LINE_STRIP, 0, v.second);
+}
+
+void GlScope::drawMask(Graph &graph) {
+    if (!graph.vaoMask.second) return;
+
+    m_program->setUniformValue(colorLocation, view->screen.markers);
+    QOpenGLVertexArrayObject::Binder b(graph.vaoMask.first);
+    context()->functions()->glDrawArrays(GL_LINES, 0, graph.vaoMask.second);
+}
+
 void GlScope::drawSpectrumChannelGraph(ChannelID channel, Graph &graph, int historyIndex) {
     if (!scope->spectrum[channel].used) return;
 
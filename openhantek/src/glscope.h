@@ -77,6 +77,8 @@ class GlScope : public QOpenGLWidget {
 
     void drawVoltageChannelGraph(ChannelID channel, Graph &graph, int historyIndex);
     void drawSpectrumChannelGraph(ChannelID channel, Graph &graph, int historyIndex);
+    void drawHistogramGraph(ChannelID channel, Graph &graph);
+    void drawMask(Graph &graph);
     QPointF eventToPosition(QMouseEvent *event);
   signals:
     void markerMoved(unsigned cursorIndex, unsigned marker);
@@ -11,6 +11,8 @@ void Graph::writeData(PPresult *data, QOpenGLShaderProgram *program, int vertexL
     int neededMemory = 0;
     for (ChannelGraph &cg : data->vaChannelVoltage) neededMemory += cg.size() * sizeof(QVector3D);
     for (ChannelGraph &cg : data->vaChannelSpectrum) neededMemory += cg.size() * sizeof(QVector3D);
+    for (ChannelGraph &cg : data->vaChannelHistogram) neededMemory += cg.size() * sizeof(QVector3D);
+    neededMemory += data->vaMask.size() * sizeof(QVector3D);
 
     buffer.bind();
     program->bind();
@@ -25,6 +27,7 @@ void Graph::writeData(PPresult *data, QOpenGLShaderProgram *program, int vertexL
     int offset = 0;
     vaoVoltage.resize(data->vaChannelVoltage.size());
     vaoSpectrum.resize(data->vaChannelSpectrum.size());
+    vaoHistogram.resize(data->vaChannelHistogram.size());
     for (ChannelID channel = 0; channel < vaoVoltage.size(); ++channel) {
         int dataSize;
 
@@ -63,8 +66,38 @@ void Graph::writeData(PPresult *data, QOpenGLShaderProgram *program, int vertexL
             s.second = (int)gSpectrum.size();
             offset += dataSize;
         }
+
+        // Histogram overlay
+        if (channel < vaoHistogram.size()) {
+            VaoCount &h = vaoHistogram[channel];
+            if (!h.first) {
+                h.first = new QOpenGLVertexArrayObject;
+                if (!h.first->create()) throw new std::runtime_error("QOpenGLVertexArrayObject create failed");
+            }
+            ChannelGraph &gHistogram = data->vaChannelHistogram[channel];
+            h.first->bind();
+            dataSize = int(gHistogram.size() * sizeof(QVector3D));
+            buffer.write(offset, gHistogram.data(), dataSize);
+            program->enableAttributeArray(vertexLocation);
+            program->setAttributeBuffer(vertexLocation, GL_FLOAT, offset, 3, 0);
+            h.first->release();
+            h.second = (int)gHistogram.size();
+            offset += dataSize;
+        }
     }
 
+    // Mask outline
+    if (!vaoMask.first) {
+        vaoMask.first = new QOpenGLVertexArrayObject;
+        if (!vaoMask.first->create()) throw new std::runtime_error("QOpenGLVertexArrayObject create failed");
+    }
+    vaoMask.first->bind();
+    buffer.write(offset, data->vaMask.data(), int(data->vaMask.size() * sizeof(QVector3D)));
+    program->enableAttributeArray(vertexLocation);
+    program->setAttributeBuffer(vertexLocation, GL_FLOAT, offset, 3, 0);
+    vaoMask.first->release();
+    vaoMask.second = (int)data->vaMask.size();
+
     buffer.release();
 }
 
@@ -77,5 +110,13 @@ Graph::~Graph() {
         vao.first->destroy();
         delete vao.first;
     }
+    for (auto &vao : vaoHistogram) {
+        vao.first->destroy();
+        delete vao.first;
+    }
+    if (vaoMask.first) {
+        vaoMask.first->destroy();
+        delete vaoMask.first;
+    }
     if (buffer.isCreated()) { buffer.destroy(); }
 }
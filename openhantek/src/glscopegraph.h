@@ -24,4 +24,6 @@ struct Graph {
     QOpenGLBuffer buffer;
     std::vector<VaoCount> vaoVoltage;
     std::vector<VaoCount> vaoSpectrum;
+    std::vector<VaoCount> vaoHistogram;
+    VaoCount vaoMask{nullptr, 0};
 };
@@ -0,0 +1,212 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+#include <cstring>
+
+#include <QDebug>
+
+#include "glspectrogram.h"
+
+#include "post/ppresult.h"
+#include "scopesettings.h"
+#include "viewconstants.h"
+#include "viewsettings.h"
+
+// Single channel texture formats of desktop OpenGL, OpenGL ES 2.0 uses GL_LUMINANCE instead
+#ifndef GL_RED
+#define GL_RED 0x1903
+#endif
+#ifndef GL_R8
+#define GL_R8 0x8229
+#endif
+
+GlSpectrogram::GlSpectrogram(const DsoSettingsScope *scope, const DsoSettingsView *view, QWidget *parent)
+    : QOpenGLWidget(parent), scope(scope), view(view), quad(QOpenGLBuffer::VertexBuffer) {
+    history.resize(scope->spectrum.size(), std::vector<unsigned char>(SPECTROGRAM_COLUMNS * SPECTROGRAM_ROWS, 0));
+}
+
+GlSpectrogram::~GlSpectrogram() {
+    if (!initialized) return;
+    makeCurrent();
+    context()->functions()->glDeleteTextures((GLsizei)textures.size(), textures.data());
+    vaoQuad.destroy();
+    quad.destroy();
+    doneCurrent();
+}
+
+void GlSpectrogram::initializeGL() {
+    if (initialized || !QOpenGLShaderProgram::hasOpenGLShaderPrograms(context())) return;
+
+    auto program = std::unique_ptr<QOpenGLShaderProgram>(new QOpenGLShaderProgram(context()));
+
+    const char *vshaderES = R"(
+          #version 100
+          attribute highp vec2 vertex;
+          varying highp vec2 position;
+          void main()
+          {
+              position = vertex * 0.5 + 0.5;
+              gl_Position = vec4(vertex, 0.0, 1.0);
+          }
+    )";
+    const char *fshaderES = R"(
+          #version 100
+          uniform sampler2D rows;
+          uniform highp float newest;
+          uniform highp vec4 colour;
+          varying highp vec2 position;
+          void main()
+          {
+              highp float row = fract(newest - (1.0 - position.y));
+              gl_FragColor = vec4(colour.rgb, texture2D(rows, vec2(position.x, row)).r * colour.a);
+          }
+    )";
+
+    const char *vshaderDesktop = R"(
+          #version 150
+          in highp vec2 vertex;
+          out highp vec2 position;
+          void main()
+          {
+              position = vertex * 0.5 + 0.5;
+              gl_Position = vec4(vertex, 0.0, 1.0);
+          }
+    )";
+    const char *fshaderDesktop = R"(
+          #version 150
+          uniform sampler2D rows;
+          uniform highp float newest;
+          uniform highp vec4 colour;
+          in highp vec2 position;
+          out vec4 flatColor;
+          void main()
+          {
+              highp float row = fract(newest - (1.0 - position.y));
+              flatColor = vec4(colour.rgb, texture(rows, vec2(position.x, row)).r * colour.a);
+          }
+    )";
+
+    bool usesOpenGL = QSurfaceFormat::defaultFormat().renderableType() == QSurfaceFormat::OpenGL;
+    if (!program->addShaderFromSourceCode(QOpenGLShader::Vertex, usesOpenGL ? vshaderDesktop : vshaderES) ||
+        !program->addShaderFromSourceCode(QOpenGLShader::Fragment, usesOpenGL ? fshaderDesktop : fshaderES) ||
+        !program->link() || !program->bind()) {
+        qWarning() << "Failed to compile spectrogram shader programs" << program->log();
+        return;
+    }
+
+    vertexLocation = program->attributeLocation("vertex");
+    colourLocation = program->uniformLocation("colour");
+    newestLocation = program->uniformLocation("newest");
+    rowsLocation = program->uniformLocation("rows");
+    if (vertexLocation == -1 || colourLocation == -1 || newestLocation == -1 || rowsLocation == -1) {
+        qWarning() << "Failed to locate spectrogram shader variable";
+        return;
+    }
+    program->setUniformValue(rowsLocation, 0);
+
+    // The whole widget is covered by one quad
+    const GLfloat vertices[] = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
+    vaoQuad.create();
+    {
+        QOpenGLVertexArrayObject::Binder b(&vaoQuad);
+        quad.create();
+        quad.bind();
+        quad.setUsagePattern(QOpenGLBuffer::StaticDraw);
+        quad.allocate(vertices, int(sizeof(vertices)));
+        program->enableAttributeArray(vertexLocation);
+        program->setAttributeBuffer(vertexLocation, GL_FLOAT, 0, 2, 0);
+    }
+
+    auto *gl = context()->functions();
+    textureInternalFormat = usesOpenGL ? GL_R8 : GL_LUMINANCE;
+    textureFormat = usesOpenGL ? GL_RED : GL_LUMINANCE;
+    textures.resize(history.size());
+    gl->glGenTextures((GLsizei)textures.size(), textures.data());
+    for (ChannelID channel = 0; channel < textures.size(); ++channel) {
+        gl->glBindTexture(GL_TEXTURE_2D, textures[channel]);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        uploadHistory(channel);
+    }
+
+    gl->glDisable(GL_DEPTH_TEST);
+    gl->glEnable(GL_BLEND);
+    // The channels are added on top of each other
+    gl->glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+
+    QColor bg = view->screen.background;
+    gl->glClearColor((GLfloat)bg.redF(), (GLfloat)bg.greenF(), (GLfloat)bg.blueF(), (GLfloat)bg.alphaF());
+
+    program->release();
+    this->program = std::move(program);
+    initialized = true;
+}
+
+void GlSpectrogram::uploadHistory(ChannelID channel) {
+    auto *gl = context()->functions();
+    gl->glBindTexture(GL_TEXTURE_2D, textures[channel]);
+    gl->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    gl->glTexImage2D(GL_TEXTURE_2D, 0, textureInternalFormat, SPECTROGRAM_COLUMNS, SPECTROGRAM_ROWS, 0,
+                     textureFormat, GL_UNSIGNED_BYTE, history[channel].data());
+}
+
+void GlSpectrogram::showData(std::shared_ptr<PPresult> data) {
+    if (data->spectrogramRows.empty()) return;
+
+    // All channels advance together, channels without a spectrum get an empty row
+    newestRow = (newestRow + 1) % SPECTROGRAM_ROWS;
+    if (initialized) makeCurrent();
+    for (ChannelID channel = 0; channel < history.size(); ++channel) {
+        unsigned char *row = history[channel].data() + newestRow * SPECTROGRAM_COLUMNS;
+        if (channel < data->spectrogramRows.size() && data->spectrogramRows[channel].size() == SPECTROGRAM_COLUMNS)
+            memcpy(row, data->spectrogramRows[channel].data(), SPECTROGRAM_COLUMNS);
+        else
+            memset(row, 0, SPECTROGRAM_COLUMNS);
+
+        if (initialized) {
+            auto *gl = context()->functions();
+            gl->glBindTexture(GL_TEXTURE_2D, textures[channel]);
+            gl->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            gl->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, (GLint)newestRow, SPECTROGRAM_COLUMNS, 1, textureFormat,
+                                GL_UNSIGNED_BYTE, row);
+        }
+    }
+
+    update();
+}
+
+void GlSpectrogram::clear() {
+    for (std::vector<unsigned char> &rows : history) std::fill(rows.begin(), rows.end(), 0);
+    if (initialized) {
+        makeCurrent();
+        for (ChannelID channel = 0; channel < textures.size(); ++channel) uploadHistory(channel);
+    }
+    update();
+}
+
+void GlSpectrogram::paintGL() {
+    if (!initialized) return;
+
+    auto *gl = context()->functions();
+    gl->glClear(GL_COLOR_BUFFER_BIT);
+
+    program->bind();
+    program->setUniformValue(newestLocation, (GLfloat)((newestRow + 0.5) / SPECTROGRAM_ROWS));
+    gl->glActiveTexture(GL_TEXTURE0);
+
+    QOpenGLVertexArrayObject::Binder b(&vaoQuad);
+    for (ChannelID channel = 0; channel < textures.size(); ++channel) {
+        if (!scope->spectrum[channel].used) continue;
+        gl->glBindTexture(GL_TEXTURE_2D, textures[channel]);
+        program->setUniformValue(colourLocation, view->screen.spectrum[channel]);
+        gl->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    }
+    program->release();
+}
+
+void GlSpectrogram::resizeGL(int width, int height) {
+    if (!initialized) return;
+    context()->functions()->glViewport(0, 0, (GLint)width, (GLint)height);
+}
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <QOpenGLBuffer>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
+#include <QOpenGLWidget>
+
+#include "hantekprotocol/types.h"
+
+struct DsoSettingsView;
+struct DsoSettingsScope;
+class PPresult;
+
+/// \brief OpenGL widget that displays the spectrogram (waterfall) of the spectrum channels.
+/// Every channel has an 8 bit texture with SPECTROGRAM_ROWS rows that is used as a ring buffer. A new spectrum
+/// only uploads its own row as a sub-image, the history is never drawn or transferred again. The shader offsets
+/// the texture coordinates so the newest row is at the top. The rows are also kept in memory to fill the
+/// textures when the OpenGL context is created.
+class GlSpectrogram : public QOpenGLWidget {
+    Q_OBJECT
+
+  public:
+    GlSpectrogram(const DsoSettingsScope *scope, const DsoSettingsView *view, QWidget *parent = 0);
+    virtual ~GlSpectrogram();
+
+    /// \brief Adds the spectrogram rows of the post processed data.
+    void showData(std::shared_ptr<PPresult> data);
+    /// \brief Discards the history, e.g. if the frequency axis has changed.
+    void clear();
+
+  protected:
+    virtual void initializeGL() override;
+    virtual void paintGL() override;
+    virtual void resizeGL(int width, int height) override;
+
+  private:
+    /// \brief Uploads all rows of a channel to its texture.
+    void uploadHistory(ChannelID channel);
+
+    const DsoSettingsScope *scope;
+    const DsoSettingsView *view;
+
+    std::vector<std::vector<unsigned char>> history; ///< SPECTROGRAM_ROWS rows for each channel
+    unsigned newestRow = 0;                          ///< Index of the last written row, the same for all channels
+
+    // OpenGL objects
+    bool initialized = false;
+    std::unique_ptr<QOpenGLShaderProgram> program;
+    QOpenGLBuffer quad;
+    QOpenGLVertexArrayObject vaoQuad;
+    std::vector<GLuint> textures; ///< One texture for each channel
+    GLint textureInternalFormat;
+    GLenum textureFormat;
+    int vertexLocation;
+    int colourLocation;
+    int newestLocation;
+    int rowsLocation;
+};
@@ -37,6 +37,14 @@ struct ControlSettingsTrigger {
     Dso::Slope slope = Dso::Slope::Positive;                     ///< The trigger slope
     bool special = false;                                        ///< true, if the trigger source is special
     unsigned int source = 0;                                     ///< The trigger source
+    double swDisplayTime = 0.0;                                  ///< Software trigger, record time shown on screen (s)
+    unsigned swThreshold = 7;                                    ///< Software trigger, threshold
+    unsigned swSampleSet = 11;                                   ///< Software trigger, sample set
+    Dso::TriggerType swType = Dso::TriggerType::Edge;            ///< Software trigger, signal condition
+    Dso::TriggerCondition swCondition = Dso::TriggerCondition::Greater; ///< Software trigger, time comparison
+    double swTime = 0.0;                                         ///< Software trigger, time (s)
+    double swTimeMax = 0.0;                                      ///< Software trigger, maximum time for ranges (s)
+    double swLevelSpan = 0.0;                                    ///< Software trigger, upper level distance (V)
 };
 
 /// \brief Stores the current amplification settings of the device.
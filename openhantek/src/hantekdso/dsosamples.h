@@ -11,5 +11,14 @@ struct DSOsamples {
     std::vector<std::vector<double>> data; ///< Pointer to input data from device
     double samplerate = 0.0;               ///< The samplerate of the input data
     bool append = false;                   ///< true, if waiting data should be appended
+    bool triggered = true;                 ///< false, if the software trigger did not find a trigger point
+    unsigned triggerOffset = 0;            ///< Software trigger, index of the first sample to display
+    double triggerFraction = 0.0;          ///< Software trigger, sub-sample distance of the crossing in samples
+    std::vector<std::vector<short>> codes; ///< The raw ADC codes of each channel
+    std::vector<double> codeStep;          ///< Voltage of one code step of each channel
+    std::vector<double> codeBase;          ///< Voltage of the lowest code of each channel
+    unsigned codeBits = 8;                 ///< Resolution of the ADC
+    int codeShift = 0;                     ///< Added to a code to get the position above the lowest code
+    unsigned long long sequence = 0;       ///< Counted up for every converted record
     mutable QReadWriteLock lock;
 };
@@ -4,6 +4,8 @@
 namespace Dso {
     Enum<Dso::TriggerMode, Dso::TriggerMode::HARDWARE_SOFTWARE, Dso::TriggerMode::SINGLE> TriggerModeEnum;
     Enum<Dso::Slope, Dso::Slope::Positive, Dso::Slope::Negative> SlopeEnum;
+    Enum<Dso::TriggerType, Dso::TriggerType::Edge, Dso::TriggerType::SlewRate> TriggerTypeEnum;
+    Enum<Dso::TriggerCondition, Dso::TriggerCondition::Greater, Dso::TriggerCondition::Range> TriggerConditionEnum;
     Enum<Dso::GraphFormat, Dso::GraphFormat::TY, Dso::GraphFormat::XY> GraphFormatEnum;
 
     /// \brief Return string representation of the given channel mode.
@@ -77,6 +79,42 @@ namespace Dso {
         }
     }
 
+    /// \brief Return string representation of the given trigger type.
+    /// \param type The ::TriggerType that should be returned as string.
+    /// \return The string that should be used in labels etc.
+    QString triggerTypeString(TriggerType type) {
+        switch (type) {
+        case TriggerType::Edge:
+            return QCoreApplication::tr("Edge");
+        case TriggerType::PulseWidth:
+            return QCoreApplication::tr("Pulse width");
+        case TriggerType::Runt:
+            return QCoreApplication::tr("Runt");
+        case TriggerType::Window:
+            return QCoreApplication::tr("Window");
+        case TriggerType::Timeout:
+            return QCoreApplication::tr("Timeout");
+        case TriggerType::SlewRate:
+            return QCoreApplication::tr("Slew rate");
+        }
+        return QString();
+    }
+
+    /// \brief Return string representation of the given trigger time condition.
+    /// \param condition The ::TriggerCondition that should be returned as string.
+    /// \return The string that should be used in labels etc.
+    QString triggerConditionString(TriggerCondition condition) {
+        switch (condition) {
+        case TriggerCondition::Greater:
+            return QString::fromUtf8(">");
+        case TriggerCondition::Less:
+            return QString::fromUtf8("<");
+        case TriggerCondition::Range:
+            return QString::fromUtf8("\u2194");
+        }
+        return QString();
+    }
+
     /// \brief Return string representation of the given graph interpolation mode.
     /// \param interpolation The ::InterpolationMode that should be returned as
     /// string.
@@ -45,6 +45,29 @@ enum class Slope : uint8_t {
 };
 extern Enum<Dso::Slope, Dso::Slope::Positive, Dso::Slope::Negative> SlopeEnum;
 
+/// \enum TriggerType
+/// \brief The signal condition that causes a trigger. Only the software trigger supports other types than edges.
+/// The slope selects the polarity, the upper level of two level types lies the level span above the trigger level.
+enum class TriggerType : uint8_t {
+    Edge,       ///< Signal crosses the trigger level
+    PulseWidth, ///< Pulse between two crossings of the trigger level matches the time condition
+    Runt,       ///< Pulse crosses the lower level and returns without reaching the upper level
+    Window,     ///< Signal leaves (positive slope) or enters (negative slope) the band between both levels
+    Timeout,    ///< Signal stays above (positive slope) or below (negative slope) the level for longer than the time
+    SlewRate    ///< Transition time between both levels matches the time condition
+};
+extern Enum<Dso::TriggerType, Dso::TriggerType::Edge, Dso::TriggerType::SlewRate> TriggerTypeEnum;
+
+/// \enum TriggerCondition
+/// \brief The comparison of a measured duration for pulse width and slew rate triggers.
+enum class TriggerCondition : uint8_t {
+    Greater, ///< Longer than the trigger time
+    Less,    ///< Shorter than the trigger time
+    Range    ///< Between the trigger time and the maximum trigger time
+};
+extern Enum<Dso::TriggerCondition, Dso::TriggerCondition::Greater, Dso::TriggerCondition::Range>
+    TriggerConditionEnum;
+
 /// \enum InterpolationMode
 /// \brief The different interpolation modes for the graphs.
 enum InterpolationMode {
@@ -59,11 +82,15 @@ QString graphFormatString(GraphFormat format);
 QString couplingString(Coupling coupling);
 QString triggerModeString(TriggerMode mode);
 QString slopeString(Slope slope);
+QString triggerTypeString(TriggerType type);
+QString triggerConditionString(TriggerCondition condition);
 QString interpolationModeString(InterpolationMode interpolation);
 }
 
 Q_DECLARE_METATYPE(Dso::TriggerMode)
 Q_DECLARE_METATYPE(Dso::Slope)
+Q_DECLARE_METATYPE(Dso::TriggerType)
+Q_DECLARE_METATYPE(Dso::TriggerCondition)
 Q_DECLARE_METATYPE(Dso::Coupling)
 Q_DECLARE_METATYPE(Dso::GraphFormat)
 Q_DECLARE_METATYPE(Dso::ChannelMode)
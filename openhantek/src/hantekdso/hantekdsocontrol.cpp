@@ -16,6 +16,7 @@
 #include "hantekprotocol/bulkStructs.h"
 #include "hantekprotocol/controlStructs.h"
 #include "models/modelDSO6022.h"
+#include "softwaretrigger.h"
 #include "usb/usbdevice.h"
 
 using namespace Hantek;
@@ -25,6 +26,12 @@ using namespace Dso;
 void HantekDsoControl::enableSampling(bool enabled) {
     sampling = enabled;
 
+    // Every start of the segmented acquisition records a new sequence
+    if (enabled && segmentCount) {
+        segmentedMemory.clear();
+        replayedSegment = UINT_MAX;
+    }
+
     // Emit signals for initial settings
     //    emit availableRecordLengthsChanged(controlsettings.samplerate.limits->recordLengths);
     //    updateSamplerateLimits();
@@ -109,8 +116,9 @@ void HantekDsoControl::updateInterval() {
     else
         cycleTime = (int)((double)getRecordLength() / controlsettings.samplerate.current * 250);
 
-    // Not more often than every 10 ms though but at least once every second
-    cycleTime = qBound(10, cycleTime, 1000);
+    // Not more often than every 10 ms though but at least once every second. The segmented acquisition
+    // polls faster to rearm the trigger as soon as possible.
+    cycleTime = qBound(segmentCount ? 1 : 10, cycleTime, 1000);
 }
 
 bool HantekDsoControl::isRollMode() const {
@@ -214,39 +222,25 @@ std::vector<unsigned char> HantekDsoControl::getSamples(unsigned &previousSample
     return data;
 }
 
-void HantekDsoControl::convertRawDataToSamples(const std::vector<unsigned char> &rawData) {
+void HantekDsoControl::decodeChannel(const std::vector<unsigned char> &rawData, ChannelID channel,
+                                     std::vector<short> &codes) const {
     const size_t totalSampleCount = (specification->sampleSize > 8) ? rawData.size() / 2 : rawData.size();
-
-    QWriteLocker locker(&result.lock);
-    result.samplerate = controlsettings.samplerate.current;
-    result.append = isRollMode();
-    // Prepare result buffers
-    result.data.resize(specification->channels);
-    for (ChannelID channelCounter = 0; channelCounter < specification->channels; ++channelCounter)
-        result.data[channelCounter].clear();
+    codes.clear();
 
     const unsigned extraBitsSize = specification->sampleSize - 8;            // Number of extra bits
     const unsigned short extraBitsMask = (0x00ff << extraBitsSize) & 0xff00; // Mask for extra bits extraction
 
-    // Convert channel data
     if (isFastRate()) {
         // Fast rate mode, one channel is using all buffers
-        ChannelID channel = 0;
-        for (; channel < specification->channels; ++channel) {
-            if (controlsettings.voltage[channel].used) break;
+        ChannelID usedChannel = 0;
+        for (; usedChannel < specification->channels; ++usedChannel) {
+            if (controlsettings.voltage[usedChannel].used) break;
         }
 
-        if (channel >= specification->channels) return;
+        if (channel != usedChannel) return;
 
-        // Resize sample vector
-        result.data[channel].resize(totalSampleCount);
+        codes.resize(totalSampleCount);
 
-        const unsigned gainID = controlsettings.voltage[channel].gain;
-        const unsigned short limit = specification->voltageLimit[channel][gainID];
-        const double offset = controlsettings.voltage[channel].offsetReal;
-        const double gainStep = specification->gain[gainID].gainSteps;
-
-        // Convert data from the oscilloscope and write it into the sample buffer
         unsigned bufferPosition = controlsettings.trigger.point * 2;
         if (specification->sampleSize > 8) {
             for (unsigned pos = 0; pos < totalSampleCount; ++pos, ++bufferPosition) {
@@ -259,66 +253,190 @@ void HantekDsoControl::convertRawDataToSamples(const std::vector<unsigned char>
                     ((unsigned short int)rawData[totalSampleCount + bufferPosition - extraBitsPosition] << shift) &
                     extraBitsMask;
 
-                result.data[channel][pos] = ((double)(low + high) / limit - offset) * gainStep;
+                codes[pos] = (short)(low + high);
             }
         } else {
             for (unsigned pos = 0; pos < totalSampleCount; ++pos, ++bufferPosition) {
                 if (bufferPosition >= totalSampleCount) bufferPosition %= totalSampleCount;
 
-                double dataBuf = (double)((int)rawData[bufferPosition]);
-                result.data[channel][pos] = (dataBuf / limit - offset) * gainStep;
+                codes[pos] = rawData[bufferPosition];
             }
         }
+        return;
+    }
+
+    // Normal mode, channels are using their separate buffers
+    codes.resize(totalSampleCount / specification->channels);
+
+    int shiftDataBuf = 0;
+    unsigned bufferPosition = controlsettings.trigger.point * 2;
+    if (specification->sampleSize > 8) {
+        // Additional most significant bits after the normal data
+        unsigned extraBitsIndex = 8 - channel * 2; // Bit position offset for extra bits extraction
+
+        for (unsigned realPosition = 0; realPosition < codes.size();
+             ++realPosition, bufferPosition += specification->channels) {
+            if (bufferPosition >= totalSampleCount) bufferPosition %= totalSampleCount;
+
+            const unsigned short low = rawData[bufferPosition + specification->channels - 1 - channel];
+            const unsigned short high =
+                ((unsigned short int)rawData[totalSampleCount + bufferPosition] << extraBitsIndex) & extraBitsMask;
+
+            codes[realPosition] = (short)(low + high);
+        }
+        return;
+    } else if (device->getModel()->ID == ModelDSO6022BE::ID) {
+        // if device is 6022BE, drop heading & trailing samples
+        const unsigned DROP_DSO6022_HEAD = 0x410;
+        const unsigned DROP_DSO6022_TAIL = 0x3F0;
+        if (!isRollMode()) {
+            codes.resize(codes.size() - (DROP_DSO6022_HEAD + DROP_DSO6022_TAIL));
+            // if device is 6022BE, offset DROP_DSO6022_HEAD incrementally
+            bufferPosition += DROP_DSO6022_HEAD * 2;
+        }
+        bufferPosition += channel;
+        shiftDataBuf = codeShift();
     } else {
-        // Normal mode, channels are using their separate buffers
-        for (ChannelID channel = 0; channel < specification->channels; ++channel) {
-            result.data[channel].resize(totalSampleCount / specification->channels);
-
-            const unsigned gainID = controlsettings.voltage[channel].gain;
-            const unsigned short limit = specification->voltageLimit[channel][gainID];
-            const double offset = controlsettings.voltage[channel].offsetReal;
-            const double gainStep = specification->gain[gainID].gainSteps;
-            int shiftDataBuf = 0;
-
-            // Convert data from the oscilloscope and write it into the sample buffer
-            unsigned bufferPosition = controlsettings.trigger.point * 2;
-            if (specification->sampleSize > 8) {
-                // Additional most significant bits after the normal data
-                unsigned extraBitsIndex = 8 - channel * 2; // Bit position offset for extra bits extraction
-
-                for (unsigned realPosition = 0; realPosition < result.data[channel].size();
-                     ++realPosition, bufferPosition += specification->channels) {
-                    if (bufferPosition >= totalSampleCount) bufferPosition %= totalSampleCount;
-
-                    const unsigned short low = rawData[bufferPosition + specification->channels - 1 - channel];
-                    const unsigned short high =
-                        ((unsigned short int)rawData[totalSampleCount + bufferPosition] << extraBitsIndex) &
-                        extraBitsMask;
-
-                    result.data[channel][realPosition] = ((double)(low + high) / limit - offset) * gainStep;
-                }
-            } else if (device->getModel()->ID == ModelDSO6022BE::ID) {
-                // if device is 6022BE, drop heading & trailing samples
-                const unsigned DROP_DSO6022_HEAD = 0x410;
-                const unsigned DROP_DSO6022_TAIL = 0x3F0;
-                if (!isRollMode()) {
-                    result.data[channel].resize(result.data[channel].size() - (DROP_DSO6022_HEAD + DROP_DSO6022_TAIL));
-                    // if device is 6022BE, offset DROP_DSO6022_HEAD incrementally
-                    bufferPosition += DROP_DSO6022_HEAD * 2;
-                }
-                bufferPosition += channel;
-                shiftDataBuf = 0x83;
-            } else {
-                bufferPosition += specification->channels - 1 - channel;
-            }
-            for (unsigned pos = 0; pos < result.data[channel].size();
-                 ++pos, bufferPosition += specification->channels) {
-                if (bufferPosition >= totalSampleCount) bufferPosition %= totalSampleCount;
-                double dataBuf = (double)((int)(rawData[bufferPosition] - shiftDataBuf));
-                result.data[channel][pos] = (dataBuf / limit - offset) * gainStep;
-            }
+        bufferPosition += specification->channels - 1 - channel;
+    }
+    for (unsigned pos = 0; pos < codes.size(); ++pos, bufferPosition += specification->channels) {
+        if (bufferPosition >= totalSampleCount) bufferPosition %= totalSampleCount;
+        codes[pos] = (short)(rawData[bufferPosition] - shiftDataBuf);
+    }
+}
+
+int HantekDsoControl::codeShift() const {
+    if (specification->sampleSize > 8 || isFastRate()) return 0;
+    return device->getModel()->ID == ModelDSO6022BE::ID ? 0x83 : 0;
+}
+
+bool HantekDsoControl::applySoftwareTrigger(const std::vector<unsigned char> &rawData) {
+    swTriggered = true;
+    swTriggerOffset = 0;
+    swTriggerFraction = 0.0;
+    decodedTriggerChannel = UINT_MAX;
+
+    if (!specification->isSoftwareTriggerDevice || isRollMode()) return true;
+
+    // Trigger channel not in use, nothing to trigger on
+    const ChannelID channel = controlsettings.trigger.source;
+    if (controlsettings.trigger.special || channel >= specification->channels ||
+        !controlsettings.voltage[channel].used)
+        return true;
+
+    channelCodes.resize(specification->channels);
+    std::vector<short> &codes = channelCodes[channel];
+    decodeChannel(rawData, channel, codes);
+    decodedTriggerChannel = channel;
+
+    const double samplesDisplay = controlsettings.trigger.swDisplayTime * controlsettings.samplerate.current;
+    if (codes.empty() || samplesDisplay >= codes.size()) {
+        // For sure not enough samples to adjust for jitter. The record is shown untriggered.
+        timestampDebug(QString("Too few samples to make a steady picture. Decrease sample rate"));
+        swTriggered = false;
+        return true;
+    }
+    const unsigned preTrigSamples = (unsigned)(controlsettings.trigger.position * controlsettings.samplerate.current);
+
+    // Convert the trigger levels once into the sample code units of the trigger channel
+    const unsigned gainID = controlsettings.voltage[channel].gain;
+    const double limit = specification->voltageLimit[channel][gainID];
+    const double gainStep = specification->gain[gainID].gainSteps;
+    const double offset = controlsettings.voltage[channel].offsetReal;
+    const double triggerLevel = controlsettings.trigger.level[channel];
+    const double level = (triggerLevel / gainStep + offset) * limit;
+    const double upperLevel = ((triggerLevel + controlsettings.trigger.swLevelSpan) / gainStep + offset) * limit;
+
+    const unsigned swTriggerStart =
+        SoftwareTrigger::compute(codes, level, upperLevel, controlsettings.samplerate.current, preTrigSamples,
+                                 (unsigned)samplesDisplay, controlsettings.trigger);
+    if (swTriggerStart == 0) {
+        swTriggered = false;
+        // Without a trigger point only the automatic mode shows the record
+        if (controlsettings.trigger.mode != Dso::TriggerMode::WAIT_FORCE) {
+            timestampDebug(QString("Trigger not asserted. Data ignored"));
+            return false;
         }
+        return true;
     }
+
+    swTriggerOffset = swTriggerStart - preTrigSamples;
+    swTriggerFraction = SoftwareTrigger::crossingFraction(codes, level, upperLevel, swTriggerStart);
+    return true;
+}
+
+void HantekDsoControl::convertRawDataToSamples(const std::vector<unsigned char> &rawData) {
+    QWriteLocker locker(&result.lock);
+    ++result.sequence;
+    result.samplerate = controlsettings.samplerate.current;
+    result.append = isRollMode();
+    result.triggered = swTriggered;
+    result.triggerOffset = swTriggerOffset;
+    result.triggerFraction = swTriggerFraction;
+    // Prepare result buffers
+    result.data.resize(specification->channels);
+    result.codes.resize(specification->channels);
+    result.codeStep.resize(specification->channels);
+    result.codeBase.resize(specification->channels);
+    result.codeBits = specification->sampleSize;
+    result.codeShift = codeShift();
+    channelCodes.resize(specification->channels);
+
+    for (ChannelID channel = 0; channel < specification->channels; ++channel) {
+        // The trigger channel may have been decoded by the software trigger already
+        if (channel != decodedTriggerChannel) decodeChannel(rawData, channel, channelCodes[channel]);
+        const std::vector<short> &codes = channelCodes[channel];
+
+        const unsigned gainID = controlsettings.voltage[channel].gain;
+        const unsigned short limit = specification->voltageLimit[channel][gainID];
+        const double offset = controlsettings.voltage[channel].offsetReal;
+        const double gainStep = specification->gain[gainID].gainSteps;
+
+        // Convert data from the oscilloscope and write it into the sample buffer
+        std::vector<double> &samples = result.data[channel];
+        samples.resize(codes.size());
+        for (size_t pos = 0; pos < codes.size(); ++pos) samples[pos] = ((double)codes[pos] / limit - offset) * gainStep;
+
+        // The codes go to the post processing as well, the buffer of the previous record is decoded next time
+        result.codeStep[channel] = gainStep / limit;
+        result.codeBase[channel] = (-(double)result.codeShift / limit - offset) * gainStep;
+        result.codes[channel].swap(channelCodes[channel]);
+    }
+    decodedTriggerChannel = UINT_MAX;
+}
+
+void HantekDsoControl::storeSegment(const std::vector<unsigned char> &rawData) {
+    const unsigned recordSize =
+        std::max(getSampleCount() * (specification->sampleSize > 8 ? 2 : 1), (unsigned)rawData.size());
+    if (!segmentedMemory.matches(recordSize, controlsettings))
+        segmentedMemory.allocate(segmentCount, recordSize, controlsettings);
+    if (segmentedMemory.count() == 0) sequenceTimer.start();
+
+    SegmentedMemory::Segment segment;
+    segment.triggerPoint = controlsettings.trigger.point;
+    segment.triggered = swTriggered;
+    segment.triggerOffset = swTriggerOffset;
+    segment.triggerFraction = swTriggerFraction;
+    segment.timestamp = sequenceTimer.nsecsElapsed() * 1e-9;
+    segmentedMemory.store(rawData, segment);
+
+    // The decoded trigger channel is not needed, it's decoded again when the segment is shown
+    decodedTriggerChannel = UINT_MAX;
+    emit segmentsCaptured(segmentedMemory.count(), segmentedMemory.capacity());
+}
+
+void HantekDsoControl::emitSegment(unsigned index) {
+    const SegmentedMemory::Segment &segment = segmentedMemory.load(index, segmentRecord);
+
+    // Restore the state of the capture, the trigger point is updated with the next capture state again
+    controlsettings.trigger.point = segment.triggerPoint;
+    swTriggered = segment.triggered;
+    swTriggerOffset = segment.triggerOffset;
+    swTriggerFraction = segment.triggerFraction;
+    decodedTriggerChannel = UINT_MAX;
+
+    convertRawDataToSamples(segmentRecord);
+    emit samplesAvailable(&result);
 }
 
 double HantekDsoControl::getBestSamplerate(double samplerate, bool fastRate, bool maximum,
@@ -851,12 +969,19 @@ Dso::ErrorCode HantekDsoControl::setTriggerMode(Dso::TriggerMode mode) {
 
 Dso::ErrorCode HantekDsoControl::setTriggerSource(bool special, unsigned id) {
     if (!device->isConnected()) return Dso::ErrorCode::CONNECTION;
-    if (specification->isSoftwareTriggerDevice) return Dso::ErrorCode::UNSUPPORTED;
 
     if (!special && id >= specification->channels) return Dso::ErrorCode::PARAMETER;
 
     if (special && id >= specification->specialTriggerChannels.size()) return Dso::ErrorCode::PARAMETER;
 
+    // The software trigger only needs to know the source channel
+    if (specification->isSoftwareTriggerDevice) {
+        if (special) return Dso::ErrorCode::UNSUPPORTED;
+        controlsettings.trigger.special = false;
+        controlsettings.trigger.source = id;
+        return Dso::ErrorCode::NONE;
+    }
+
     int hardwareID = special ? specification->specialTriggerChannels[id].hardwareID : (int)id;
 
     switch (specification->cmdSetTrigger) {
@@ -939,6 +1064,11 @@ Dso::ErrorCode HantekDsoControl::setTriggerLevel(ChannelID channel, double level
 Dso::ErrorCode HantekDsoControl::setTriggerSlope(Dso::Slope slope) {
     if (!device->isConnected()) return Dso::ErrorCode::CONNECTION;
 
+    if (specification->isSoftwareTriggerDevice) {
+        controlsettings.trigger.slope = slope;
+        return Dso::ErrorCode::NONE;
+    }
+
     switch (specification->cmdSetTrigger) {
     case BulkCode::SETTRIGGERANDSAMPLERATE: {
         // SetTriggerAndSamplerate bulk command for trigger slope
@@ -968,6 +1098,12 @@ void HantekDsoControl::forceTrigger() { modifyCommand<BulkCommand>(BulkCode::FOR
 Dso::ErrorCode HantekDsoControl::setPretriggerPosition(double position) {
     if (!device->isConnected()) return Dso::ErrorCode::CONNECTION;
 
+    // The software trigger converts the position into samples for each record
+    if (specification->isSoftwareTriggerDevice) {
+        controlsettings.trigger.position = position;
+        return Dso::ErrorCode::NONE;
+    }
+
     // All trigger positions are measured in samples
     double positionSamples = position * controlsettings.samplerate.current;
     unsigned recordLength = getRecordLength();
@@ -1014,6 +1150,77 @@ Dso::ErrorCode HantekDsoControl::setPretriggerPosition(double position) {
     return Dso::ErrorCode::NONE;
 }
 
+Dso::ErrorCode HantekDsoControl::setTriggerType(Dso::TriggerType type) {
+    if (!device->isConnected()) return Dso::ErrorCode::CONNECTION;
+
+    // The hardware triggers only know edges
+    if (!specification->isSoftwareTriggerDevice)
+        return type == Dso::TriggerType::Edge ? Dso::ErrorCode::NONE : Dso::ErrorCode::UNSUPPORTED;
+
+    controlsettings.trigger.swType = type;
+    return Dso::ErrorCode::NONE;
+}
+
+Dso::ErrorCode HantekDsoControl::setTriggerTiming(Dso::TriggerCondition condition, double time, double timeMax) {
+    if (!device->isConnected()) return Dso::ErrorCode::CONNECTION;
+    if (!specification->isSoftwareTriggerDevice) return Dso::ErrorCode::UNSUPPORTED;
+
+    if (time < 0.0 || (condition == Dso::TriggerCondition::Range && timeMax < time))
+        return Dso::ErrorCode::PARAMETER;
+
+    controlsettings.trigger.swCondition = condition;
+    controlsettings.trigger.swTime = time;
+    controlsettings.trigger.swTimeMax = timeMax;
+    return Dso::ErrorCode::NONE;
+}
+
+Dso::ErrorCode HantekDsoControl::setTriggerLevelSpan(double span) {
+    if (!device->isConnected()) return Dso::ErrorCode::CONNECTION;
+    if (!specification->isSoftwareTriggerDevice) return Dso::ErrorCode::UNSUPPORTED;
+
+    if (span < 0.0) return Dso::ErrorCode::PARAMETER;
+
+    controlsettings.trigger.swLevelSpan = span;
+    return Dso::ErrorCode::NONE;
+}
+
+Dso::ErrorCode HantekDsoControl::setDisplayedRecordTime(double duration) {
+    if (duration < 0.0) return Dso::ErrorCode::PARAMETER;
+
+    controlsettings.trigger.swDisplayTime = duration;
+    return Dso::ErrorCode::NONE;
+}
+
+Dso::ErrorCode HantekDsoControl::setSegmentCount(unsigned count) {
+    if (count && isRollMode()) return Dso::ErrorCode::UNSUPPORTED;
+
+    segmentCount = count;
+    replayedSegment = UINT_MAX;
+    segmentedMemory.allocate(count, count ? getSampleCount() * (specification->sampleSize > 8 ? 2 : 1) : 0,
+                             controlsettings);
+    emit segmentsCaptured(0, count);
+    return Dso::ErrorCode::NONE;
+}
+
+Dso::ErrorCode HantekDsoControl::showSegment(unsigned index) {
+    if (index >= segmentedMemory.count()) return Dso::ErrorCode::PARAMETER;
+    // The records can't be decoded with other settings
+    if (!segmentedMemory.matches(0, controlsettings)) return Dso::ErrorCode::UNSUPPORTED;
+
+    replayedSegment = UINT_MAX;
+    emitSegment(index);
+    return Dso::ErrorCode::NONE;
+}
+
+Dso::ErrorCode HantekDsoControl::replaySegments() {
+    if (segmentedMemory.count() == 0) return Dso::ErrorCode::PARAMETER;
+    if (!segmentedMemory.matches(0, controlsettings)) return Dso::ErrorCode::UNSUPPORTED;
+
+    // The segments are emitted one per cycle by run()
+    replayedSegment = 0;
+    return Dso::ErrorCode::NONE;
+}
+
 Dso::ErrorCode HantekDsoControl::stringCommand(const QString &commandString) {
     if (!device->isConnected()) return Dso::ErrorCode::CONNECTION;
 
@@ -1104,6 +1311,14 @@ void HantekDsoControl::run() {
         controlCommand = controlCommand->next;
     }
 
+    // Replay one stored segment per cycle, the post processing handles them like live records
+    if (replayedSegment < segmentedMemory.count()) {
+        if (segmentedMemory.matches(0, controlsettings))
+            emitSegment(replayedSegment++);
+        else
+            replayedSegment = UINT_MAX;
+    }
+
     // State machine for the device communication
     if (isRollMode()) {
         // Roll mode
@@ -1167,6 +1382,7 @@ void HantekDsoControl::run() {
         case RollState::GETDATA: {
             std::vector<unsigned char> rawData = this->getSamples(expectedSampleCount);
             if (this->_samplingStarted) {
+                applySoftwareTrigger(rawData);
                 convertRawDataToSamples(rawData);
                 emit samplesAvailable(&result);
             }
@@ -1202,20 +1418,35 @@ void HantekDsoControl::run() {
         } else if (this->captureState != lastCaptureState)
             timestampDebug(QString("Capture state changed to %1").arg(this->captureState));
 
+        bool recordAvailable = false;
         switch (this->captureState) {
         case CAPTURE_READY:
         case CAPTURE_READY2250:
         case CAPTURE_READY5200: {
             std::vector<unsigned char> rawData = this->getSamples(expectedSampleCount);
-            if (this->_samplingStarted) {
-                convertRawDataToSamples(rawData);
-                emit samplesAvailable(&result);
+            // Records without a software trigger point are dropped before they are converted
+            if (this->_samplingStarted && applySoftwareTrigger(rawData)) {
+                if (segmentCount) {
+                    // Defer the conversion until the sequence is complete and rearm at once
+                    storeSegment(rawData);
+                } else {
+                    convertRawDataToSamples(rawData);
+                    emit samplesAvailable(&result);
+                }
+                recordAvailable = true;
             }
         }
 
-            // Check if we're in single trigger mode
-            if (controlsettings.trigger.mode == Dso::TriggerMode::SINGLE && this->_samplingStarted)
+            if (recordAvailable && segmentCount) {
+                // Stop when the segmented memory is full and show the first segment of the sequence
+                if (segmentedMemory.isFull()) {
+                    this->enableSampling(false);
+                    emitSegment(0);
+                }
+            } else if (controlsettings.trigger.mode == Dso::TriggerMode::SINGLE && recordAvailable) {
+                // Check if we're in single trigger mode
                 this->enableSampling(false);
+            }
 
             // Sampling completed, restart it when necessary
             this->_samplingStarted = false;
@@ -9,6 +9,7 @@
 #include "controlspecification.h"
 #include "dsosamples.h"
 #include "errorcodes.h"
+#include "segmentedmemory.h"
 #include "states.h"
 #include "utils/printutils.h"
 
@@ -18,6 +19,7 @@
 
 #include <vector>
 
+#include <QElapsedTimer>
 #include <QMutex>
 #include <QStringList>
 #include <QThread>
@@ -151,9 +153,28 @@ class HantekDsoControl : public QObject {
     /// \brief Gets sample data from the oscilloscope
     std::vector<unsigned char> getSamples(unsigned &expectedSampleCount) const;
 
+    /// \brief Extracts the raw sample codes of one channel from the oscilloscope data
+    /// \param rawData The data as received from the oscilloscope.
+    /// \param channel The channel that should be extracted.
+    /// \param codes The sample codes, empty if the channel has no samples in this record.
+    void decodeChannel(const std::vector<unsigned char> &rawData, ChannelID channel, std::vector<short> &codes) const;
+    /// \return The value that is subtracted from the bytes of the device, the codes of the 6022BE are signed.
+    int codeShift() const;
+
+    /// \brief Searches the software trigger point on the raw data of the trigger source.
+    /// \return false, if the record did not trigger and should be dropped.
+    bool applySoftwareTrigger(const std::vector<unsigned char> &rawData);
+
     /// \brief Converts raw oscilloscope data to sample data
     void convertRawDataToSamples(const std::vector<unsigned char> &rawData);
 
+    /// \brief Stores a triggered record in the segmented memory without converting it.
+    /// A new sequence is started if the acquisition settings changed since the last record.
+    void storeSegment(const std::vector<unsigned char> &rawData);
+
+    /// \brief Converts a stored segment to sample data and hands it to the post processing.
+    void emitSegment(unsigned index);
+
     /// \brief Sets the size of the sample buffer without updating dependencies.
     /// \param index The record length index that should be set.
     /// \return The record length that has been set, 0 on error.
@@ -191,6 +212,18 @@ class HantekDsoControl : public QObject {
     DSOsamples result;
     unsigned expectedSampleCount = 0; ///< The expected total number of samples at
                                       /// the last check before sampling started
+    std::vector<std::vector<short>> channelCodes; ///< Raw sample codes for each channel of the last record
+    ChannelID decodedTriggerChannel = UINT_MAX;   ///< Channel already decoded by the software trigger
+    bool swTriggered = true;                      ///< Software trigger result for the last record
+    unsigned swTriggerOffset = 0;                 ///< Software trigger, first sample to display
+    double swTriggerFraction = 0.0;               ///< Software trigger, sub-sample distance of the crossing
+
+    // Segmented acquisition
+    SegmentedMemory segmentedMemory;          ///< Raw records of the current sequence
+    unsigned segmentCount = 0;                ///< Segments per sequence, 0 for the live acquisition
+    unsigned replayedSegment = UINT_MAX;      ///< Next segment that is shown by replaySegments()
+    std::vector<unsigned char> segmentRecord; ///< Raw record of the segment that is shown
+    QElapsedTimer sequenceTimer;              ///< Started with the first segment of a sequence
 
     // State of the communication thread
     int captureState = Hantek::CAPTURE_WAITING;
@@ -271,12 +304,50 @@ class HantekDsoControl : public QObject {
     /// \param position The new trigger position (in s).
     /// \return The trigger position that has been set.
     Dso::ErrorCode setPretriggerPosition(double position);
+    /// \brief Set the signal condition that causes a trigger.
+    /// Hardware triggers only support ::Dso::TriggerType::Edge.
+    /// \param type The trigger type.
+    /// \return See ::Dso::ErrorCode.
+    Dso::ErrorCode setTriggerType(Dso::TriggerType type);
+    /// \brief Set the time condition for pulse width, timeout and slew rate triggers.
+    /// \param condition The comparison of the measured duration.
+    /// \param time The trigger time (s), the lower limit for ranges.
+    /// \param timeMax The upper time limit for ranges (s).
+    /// \return See ::Dso::ErrorCode.
+    Dso::ErrorCode setTriggerTiming(Dso::TriggerCondition condition, double time, double timeMax);
+    /// \brief Set the distance of the upper level above the trigger level.
+    /// It is used by runt, window and slew rate triggers.
+    /// \param span The level distance (V).
+    /// \return See ::Dso::ErrorCode.
+    Dso::ErrorCode setTriggerLevelSpan(double span);
+    /// \brief Set the record time that is shown on screen.
+    /// Software trigger devices need it to keep the trigger point within the displayed range.
+    /// \param duration The displayed record time duration (s).
+    /// \return See ::Dso::ErrorCode.
+    Dso::ErrorCode setDisplayedRecordTime(double duration);
     void forceTrigger();
 
+    /// \brief Enables the segmented acquisition.
+    /// Triggered records are stored in a preallocated memory and the trigger is rearmed at once, nothing is
+    /// shown until the memory is full. Sampling stops then and the first segment is shown.
+    /// \param count The number of segments per sequence, 0 returns to the live acquisition.
+    /// \return See ::Dso::ErrorCode.
+    Dso::ErrorCode setSegmentCount(unsigned count);
+    /// \brief Shows a stored segment of the segmented acquisition.
+    /// \param index The index of the segment.
+    /// \return See ::Dso::ErrorCode, UNSUPPORTED if the acquisition settings changed since the capture.
+    Dso::ErrorCode showSegment(unsigned index);
+    /// \brief Shows all stored segments one after another.
+    /// They pass the post processing like live records, so they are overlaid by the digital phosphor and
+    /// exported by an active exporter.
+    /// \return See ::Dso::ErrorCode, UNSUPPORTED if the acquisition settings changed since the capture.
+    Dso::ErrorCode replaySegments();
+
   signals:
     void samplingStatusChanged(bool enabled); ///< The oscilloscope started/stopped sampling/waiting for trigger
     void statusMessage(const QString &message, int timeout); ///< Status message about the oscilloscope
     void samplesAvailable(const DSOsamples *samples);        ///< New sample data is available
+    void segmentsCaptured(unsigned count, unsigned capacity); ///< Segments stored in the segmented memory
 
     void availableRecordLengthsChanged(const std::vector<unsigned> &recordLengths); ///< The available record
                                                                                     /// lengths, empty list for
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <cstring>
+
+#include "segmentedmemory.h"
+
+void SegmentedMemory::allocate(unsigned capacity, unsigned recordSize, const Dso::ControlSettings &settings) {
+    this->recordSize = recordSize;
+    arena.resize((size_t)capacity * recordSize);
+    arena.shrink_to_fit();
+    segments.assign(capacity, Segment());
+    used = 0;
+
+    samplerate = settings.samplerate.current;
+    limits = settings.samplerate.limits;
+    recordLengthId = settings.recordLengthId;
+    voltage = settings.voltage;
+}
+
+void SegmentedMemory::clear() { used = 0; }
+
+bool SegmentedMemory::matches(unsigned recordSize, const Dso::ControlSettings &settings) const {
+    if (recordSize > this->recordSize || samplerate != settings.samplerate.current ||
+        limits != settings.samplerate.limits || recordLengthId != settings.recordLengthId ||
+        voltage.size() != settings.voltage.size())
+        return false;
+
+    for (size_t channel = 0; channel < voltage.size(); ++channel) {
+        const Dso::ControlSettingsVoltage &recorded = voltage[channel];
+        const Dso::ControlSettingsVoltage &current = settings.voltage[channel];
+        if (recorded.gain != current.gain || recorded.offsetReal != current.offsetReal ||
+            recorded.used != current.used)
+            return false;
+    }
+    return true;
+}
+
+bool SegmentedMemory::store(const std::vector<unsigned char> &rawData, const Segment &info) {
+    if (isFull() || rawData.size() > recordSize) return false;
+
+    Segment &segment = segments[used];
+    segment = info;
+    segment.size = (unsigned)rawData.size();
+    if (!rawData.empty()) memcpy(&arena[(size_t)used * recordSize], rawData.data(), rawData.size());
+    ++used;
+    return true;
+}
+
+const SegmentedMemory::Segment &SegmentedMemory::load(unsigned index, std::vector<unsigned char> &rawData) const {
+    const Segment &segment = segments[index];
+    const unsigned char *slot = arena.data() + (size_t)index * recordSize;
+    rawData.assign(slot, slot + segment.size);
+    return segment;
+}
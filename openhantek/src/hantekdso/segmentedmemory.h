@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <vector>
+
+#include "controlsettings.h"
+
+/// \brief Preallocated arena of raw records for the segmented acquisition.
+/// HantekDsoControl copies each triggered record into the next free slot without converting it. The arena is
+/// allocated once per sequence, so no allocation takes place while records are captured in quick succession.
+/// The records can only be decoded with the acquisition settings they were recorded with, which are kept
+/// alongside. A sequence is restarted when those settings change.
+class SegmentedMemory {
+  public:
+    /// \brief Capture information of one segment.
+    struct Segment {
+        unsigned triggerPoint = 0;    ///< The trigger position in Hantek coding
+        bool triggered = true;        ///< false, if the software trigger did not find a trigger point
+        unsigned triggerOffset = 0;   ///< Software trigger, index of the first sample to display
+        double triggerFraction = 0.0; ///< Software trigger, sub-sample distance of the crossing
+        double timestamp = 0.0;       ///< Capture time relative to the start of the sequence (s)
+        unsigned size = 0;            ///< Number of valid bytes within the arena slot
+    };
+
+    /// \brief Reserves the arena and starts a new sequence. Existing segments are discarded.
+    /// \param capacity The number of segments, 0 releases the arena.
+    /// \param recordSize The size of one raw record in bytes.
+    /// \param settings The acquisition settings the records are captured with.
+    void allocate(unsigned capacity, unsigned recordSize, const Dso::ControlSettings &settings);
+
+    /// \brief Discards all segments but keeps the arena.
+    void clear();
+
+    /// \brief Checks if records captured with the given settings fit into this sequence.
+    /// \param recordSize The size of the raw record in bytes.
+    /// \param settings The current acquisition settings.
+    /// \return true, if the record size and all settings needed to decode the records are unchanged.
+    bool matches(unsigned recordSize, const Dso::ControlSettings &settings) const;
+
+    /// \brief Copies a raw record into the next free slot.
+    /// \return false, if the arena is full or the record doesn't fit into a slot.
+    bool store(const std::vector<unsigned char> &rawData, const Segment &info);
+
+    /// \brief Copies the raw record of a stored segment.
+    /// \param index The segment index.
+    /// \param rawData The raw record, its capacity is reused.
+    /// \return The capture information of the segment.
+    const Segment &load(unsigned index, std::vector<unsigned char> &rawData) const;
+
+    unsigned capacity() const { return (unsigned)segments.size(); }
+    unsigned count() const { return used; }
+    bool isFull() const { return used >= segments.size(); }
+
+  private:
+    std::vector<unsigned char> arena;    ///< Raw records, one slot of recordSize bytes per segment
+    std::vector<Segment> segments;       ///< Capture information for each slot
+    unsigned recordSize = 0;             ///< The size of one arena slot in bytes
+    unsigned used = 0;                   ///< Number of captured segments
+
+    // Acquisition settings the sequence is recorded with
+    double samplerate = 0.0;
+    const Dso::ControlSamplerateLimits *limits = nullptr;
+    RecordLengthID recordLengthId = 0;
+    std::vector<Dso::ControlSettingsVoltage> voltage;
+};
@@ -0,0 +1,332 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include "softwaretrigger.h"
+#include "controlsettings.h"
+
+namespace {
+/// Number of samples that are tested for a level crossing at once. The inner loop over a block has no
+/// early exit and no data dependent branch, so the compiler is able to vectorize it.
+const unsigned CROSSING_BLOCK = 64;
+
+/// Sample codes are integers, so an integer level gives the same result as the exact level would.
+/// A rising edge uses floor(level) for "value > level", a falling edge ceil(level) for "value < level".
+struct RisingEdge {
+    static inline int code(double level) { return (int)std::floor(level); }
+    static inline bool crossed(int value, int level, int prev) { return value > level && prev <= level; }
+    static inline bool follows(int sampleK, int value) { return sampleK >= value; }
+};
+
+struct FallingEdge {
+    static inline int code(double level) { return (int)std::ceil(level); }
+    static inline bool crossed(int value, int level, int prev) { return value < level && prev >= level; }
+    static inline bool follows(int sampleK, int value) { return sampleK < value; }
+};
+
+/// Number of newton iterations used to refine the linear estimate of the crossing on the cubic curve.
+const unsigned CROSSING_ITERATIONS = 3;
+
+/// \brief Checks the noise filter condition for the crossing candidate at position.
+template <class Edge>
+inline bool confirmed(const short *samples, unsigned position, unsigned sampleCount, unsigned sampleSet,
+                      unsigned threshold) {
+    const int value = samples[position];
+    const unsigned windowEnd = std::min(position + sampleSet, sampleCount);
+    unsigned following = 0;
+    for (unsigned k = position + 1; k < windowEnd; ++k) following += Edge::follows(samples[k], value);
+    return following > threshold;
+}
+
+/// \brief Returns the first confirmed crossing within [begin, end) or 0 if there is none.
+/// The sample at begin is never a trigger candidate, because it has no predecessor within the range.
+template <class Edge>
+unsigned findTrigger(const std::vector<short> &samples, double levelValue, unsigned begin, unsigned end,
+                     unsigned sampleSet, unsigned threshold) {
+    const short *data = samples.data();
+    const unsigned sampleCount = (unsigned)samples.size();
+    const int level = Edge::code(levelValue);
+
+    for (unsigned blockStart = begin + 1; blockStart < end; blockStart += CROSSING_BLOCK) {
+        const unsigned blockEnd = std::min(blockStart + CROSSING_BLOCK, end);
+
+        // Branchless search for any crossing within this block
+        unsigned crossings = 0;
+        for (unsigned i = blockStart; i < blockEnd; ++i) crossings |= Edge::crossed(data[i], level, data[i - 1]);
+        if (!crossings) continue;
+
+        // Only blocks with a crossing are inspected sample by sample
+        for (unsigned i = blockStart; i < blockEnd; ++i) {
+            if (Edge::crossed(data[i], level, data[i - 1]) &&
+                confirmed<Edge>(data, i, sampleCount, sampleSet, threshold))
+                return i;
+        }
+    }
+    return 0;
+}
+
+/// Zones of a sample relative to the trigger levels. With a single level only BELOW and ABOVE occur.
+const int BELOW = 0;
+const int BETWEEN = 1;
+const int ABOVE = 2;
+
+/// Marks an unknown position and a state machine without a pending timeout.
+const unsigned NO_POSITION = UINT_MAX;
+
+inline int zoneOf(int value, int low, int high) { return (value > low) + (value > high); }
+
+/// \brief Compares a measured duration in samples with the trigger time condition.
+struct Duration {
+    Duration(Dso::TriggerCondition condition, double time, double timeMax)
+        : condition(condition), time(time), timeMax(timeMax) {}
+    bool matches(unsigned samples) const {
+        switch (condition) {
+        case Dso::TriggerCondition::Greater:
+            return samples > time;
+        case Dso::TriggerCondition::Less:
+            return samples < time;
+        case Dso::TriggerCondition::Range:
+            return samples >= time && samples <= timeMax;
+        }
+        return false;
+    }
+    Dso::TriggerCondition condition;
+    double time;
+    double timeMax;
+};
+
+/// \brief Base of the trigger state machines. They are advanced only on zone transitions.
+/// A machine may request to trigger at a later sample without a further transition by setting a deadline.
+struct ZoneMachine {
+    void start(int) {}
+    unsigned deadline = NO_POSITION;
+};
+
+/// \brief Pulse width trigger. A pulse leaves the idle zone and returns to it, the trigger point is its end.
+class PulseWidthMachine : public ZoneMachine {
+  public:
+    PulseWidthMachine(bool positive, const Duration &duration) : idle(positive ? BELOW : ABOVE), duration(duration) {}
+    bool transition(unsigned position, int from, int to) {
+        if (from == idle) {
+            pulseStart = position;
+            return false;
+        }
+        if (to != idle || pulseStart == NO_POSITION) return false;
+        const unsigned width = position - pulseStart;
+        pulseStart = NO_POSITION;
+        return duration.matches(width);
+    }
+
+  private:
+    const int idle;
+    const Duration duration;
+    unsigned pulseStart = NO_POSITION; ///< The width of a pulse that started before the record is unknown
+};
+
+/// \brief Runt trigger. A pulse leaves the idle zone and returns to it without reaching the opposite zone.
+class RuntMachine : public ZoneMachine {
+  public:
+    explicit RuntMachine(bool positive) : idle(positive ? BELOW : ABOVE), limit(positive ? ABOVE : BELOW) {}
+    bool transition(unsigned, int from, int to) {
+        if (from == idle) {
+            armed = to != limit;
+        } else if (to == limit) {
+            armed = false;
+        } else if (to == idle) {
+            const bool runt = armed;
+            armed = false;
+            return runt;
+        }
+        return false;
+    }
+
+  private:
+    const int idle;
+    const int limit;
+    bool armed = false;
+};
+
+/// \brief Window trigger. Triggers when the signal leaves or enters the band between both levels.
+class WindowMachine : public ZoneMachine {
+  public:
+    explicit WindowMachine(bool leave) : leave(leave) {}
+    bool transition(unsigned, int from, int to) { return leave ? from == BETWEEN : to == BETWEEN; }
+
+  private:
+    const bool leave;
+};
+
+/// \brief Timeout trigger. Triggers when the signal stays in the held zone for the given number of samples.
+class TimeoutMachine : public ZoneMachine {
+  public:
+    TimeoutMachine(bool positive, unsigned timeSamples) : held(positive ? ABOVE : BELOW), timeSamples(timeSamples) {}
+    void start(int zone) { deadline = zone == held ? timeSamples : NO_POSITION; }
+    bool transition(unsigned position, int, int to) {
+        deadline = to == held ? position + timeSamples : NO_POSITION;
+        return false;
+    }
+
+  private:
+    const int held;
+    const unsigned timeSamples;
+};
+
+/// \brief Slew rate trigger. Measures the transition time from leaving the origin zone to reaching the target zone.
+class SlewRateMachine : public ZoneMachine {
+  public:
+    SlewRateMachine(bool positive, const Duration &duration)
+        : origin(positive ? BELOW : ABOVE), target(positive ? ABOVE : BELOW), duration(duration) {}
+    bool transition(unsigned position, int from, int to) {
+        if (to == target) {
+            // A jump over both levels within one sample is a transition time of zero
+            const bool matches = from == origin ? duration.matches(0)
+                                                : transitionStart != NO_POSITION &&
+                                                      duration.matches(position - transitionStart);
+            transitionStart = NO_POSITION;
+            return matches;
+        }
+        transitionStart = from == origin ? position : NO_POSITION;
+        return false;
+    }
+
+  private:
+    const int origin;
+    const int target;
+    const Duration duration;
+    unsigned transitionStart = NO_POSITION;
+};
+
+/// \brief Feeds the zone transitions of the samples into a trigger state machine.
+/// The machine sees the whole record to know the signal history, but only triggers within [begin, end) count.
+/// \return The first trigger position within [begin, end) or 0 if there is none.
+template <class Machine>
+unsigned runMachine(Machine &machine, const std::vector<short> &samples, int low, int high, unsigned begin,
+                    unsigned end) {
+    const short *data = samples.data();
+    int zone = zoneOf(data[0], low, high);
+    machine.start(zone);
+
+    for (unsigned blockStart = 1; blockStart < end; blockStart += CROSSING_BLOCK) {
+        const unsigned blockEnd = std::min(blockStart + CROSSING_BLOCK, end);
+
+        // Branchless search for any zone transition within this block
+        unsigned transitions = 0;
+        for (unsigned i = blockStart; i < blockEnd; ++i)
+            transitions |= zoneOf(data[i], low, high) != zoneOf(data[i - 1], low, high);
+
+        if (transitions) {
+            for (unsigned i = blockStart; i < blockEnd; ++i) {
+                const int next = zoneOf(data[i], low, high);
+                if (next == zone) continue;
+                if (machine.deadline < i) {
+                    const unsigned position = machine.deadline;
+                    machine.deadline = NO_POSITION;
+                    if (position >= begin) return position;
+                }
+                const bool triggered = machine.transition(i, zone, next);
+                zone = next;
+                if (triggered && i >= begin) return i;
+            }
+        }
+
+        // A deadline passes within the block without a transition that cancels it
+        if (machine.deadline < blockEnd) {
+            const unsigned position = machine.deadline;
+            machine.deadline = NO_POSITION;
+            if (position >= begin) return position;
+        }
+    }
+    return 0;
+}
+} // namespace
+
+unsigned SoftwareTrigger::compute(const std::vector<short> &samples, double level, double upperLevel,
+                                  double samplerate, unsigned preTrigSamples, unsigned displaySamples,
+                                  const Dso::ControlSettingsTrigger &trigger) {
+    if (samples.empty() || displaySamples >= samples.size()) return 0;
+
+    // The trigger point has to leave enough samples in front of and behind it to fill the screen
+    const unsigned postTrigSamples = (unsigned)samples.size() - (displaySamples - preTrigSamples);
+
+    const bool positive = trigger.slope == Dso::Slope::Positive;
+    const int low = (int)std::floor(level);
+    const int high = (int)std::floor(std::max(level, upperLevel));
+    const Duration duration(trigger.swCondition, trigger.swTime * samplerate, trigger.swTimeMax * samplerate);
+
+    switch (trigger.swType) {
+    case Dso::TriggerType::Edge:
+        break;
+    case Dso::TriggerType::PulseWidth: {
+        PulseWidthMachine machine(positive, duration);
+        return runMachine(machine, samples, low, low, preTrigSamples, postTrigSamples);
+    }
+    case Dso::TriggerType::Runt: {
+        RuntMachine machine(positive);
+        return runMachine(machine, samples, low, high, preTrigSamples, postTrigSamples);
+    }
+    case Dso::TriggerType::Window: {
+        WindowMachine machine(positive);
+        return runMachine(machine, samples, low, high, preTrigSamples, postTrigSamples);
+    }
+    case Dso::TriggerType::Timeout: {
+        const double timeSamples = std::ceil(trigger.swTime * samplerate);
+        TimeoutMachine machine(positive, (unsigned)std::max(1.0, std::min(timeSamples, (double)samples.size())));
+        return runMachine(machine, samples, low, low, preTrigSamples, postTrigSamples);
+    }
+    case Dso::TriggerType::SlewRate: {
+        SlewRateMachine machine(positive, duration);
+        return runMachine(machine, samples, low, high, preTrigSamples, postTrigSamples);
+    }
+    }
+
+    if (trigger.slope == Dso::Slope::Positive)
+        return findTrigger<RisingEdge>(samples, level, preTrigSamples, postTrigSamples, trigger.swSampleSet,
+                                       trigger.swThreshold);
+    else
+        return findTrigger<FallingEdge>(samples, level, preTrigSamples, postTrigSamples, trigger.swSampleSet,
+                                        trigger.swThreshold);
+}
+
+double SoftwareTrigger::crossingFraction(const std::vector<short> &samples, double level, double upperLevel,
+                                         unsigned position) {
+    if (position == 0 || position >= samples.size()) return 0.0;
+
+    // The crossing lies between p1 and p2, p1 is on or behind the level and p2 is past it
+    const double p1 = samples[position - 1];
+    const double p2 = samples[position];
+    if (p1 == p2) return 0.0;
+
+    // Two level triggers may have crossed the upper level only
+    if (level < std::min(p1, p2) || level > std::max(p1, p2)) {
+        if (upperLevel < std::min(p1, p2) || upperLevel > std::max(p1, p2)) return 0.0;
+        level = upperLevel;
+    }
+
+    // Linear estimate of the crossing, t is measured from p1 towards p2
+    double t = (level - p1) / (p2 - p1);
+
+    // Refine on the cubic curve if both outer neighbours exist
+    if (position >= 2 && position + 1 < samples.size()) {
+        const double p0 = samples[position - 2];
+        const double p3 = samples[position + 1];
+        // Catmull-Rom segment between p1 and p2: c0 + c1*t + c2*t^2 + c3*t^3
+        const double c0 = p1 - level;
+        const double c1 = 0.5 * (p2 - p0);
+        const double c2 = 0.5 * (2.0 * p0 - 5.0 * p1 + 4.0 * p2 - p3);
+        const double c3 = 0.5 * (-p0 + 3.0 * p1 - 3.0 * p2 + p3);
+
+        double cubic = t;
+        for (unsigned iteration = 0; iteration < CROSSING_ITERATIONS; ++iteration) {
+            const double value = ((c3 * cubic + c2) * cubic + c1) * cubic + c0;
+            const double slope = (3.0 * c3 * cubic + 2.0 * c2) * cubic + c1;
+            if (slope == 0.0) break;
+            cubic -= value / slope;
+        }
+        // The curve may overshoot between the samples, keep the linear estimate then
+        if (cubic >= 0.0 && cubic <= 1.0) t = cubic;
+    }
+
+    return std::max(0.0, std::min(1.0 - t, 1.0));
+}
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <vector>
+
+namespace Dso {
+struct ControlSettingsTrigger;
+}
+
+/**
+ * Contains software trigger algorithms for devices without a hardware trigger. They work on the raw
+ * sample codes of the trigger channel within HantekDsoControl, before any conversion to volts is done.
+ *
+ * Besides edges, the trigger types of ::Dso::TriggerType are supported. Each of them is a state machine
+ * that is only advanced when the signal moves between the zones that are separated by the two trigger levels.
+ * Sample blocks without such a transition are skipped by a branchless prefilter.
+ */
+class SoftwareTrigger {
+  public:
+    /**
+     * @brief Computes a software trigger point.
+     * @param samples Raw sample codes of the trigger channel
+     * @param level Trigger level in raw sample code units
+     * @param upperLevel Upper level for runt, window and slew rate triggers in raw sample code units
+     * @param samplerate Samplerate of the record, converts the trigger times into samples
+     * @param preTrigSamples Number of samples that are shown in front of the trigger point
+     * @param displaySamples Number of samples that are shown on screen
+     * @param trigger Trigger settings (type, slope, times, noise filter)
+     * @return Returns the trigger position or 0 if the trigger was not asserted
+     */
+    static unsigned compute(const std::vector<short> &samples, double level, double upperLevel, double samplerate,
+                            unsigned preTrigSamples, unsigned displaySamples,
+                            const Dso::ControlSettingsTrigger &trigger);
+
+    /**
+     * @brief Locates the level crossing in front of a trigger position with sub-sample accuracy.
+     * The crossing is interpolated with a cubic (Catmull-Rom) curve through the neighbouring samples,
+     * linear interpolation is used at the borders of the record.
+     * @param samples Raw sample codes of the trigger channel
+     * @param level Trigger level in raw sample code units
+     * @param upperLevel Upper level in raw sample code units, used if the trigger level is not crossed
+     * @param position Trigger position as returned by compute()
+     * @return Distance between the crossing and the trigger position in samples, within [0, 1].
+     * 0 if no level is crossed in front of the position, like for a timeout.
+     */
+    static double crossingFraction(const std::vector<short> &samples, double level, double upperLevel,
+                                   unsigned position);
+};
@@ -22,9 +22,21 @@
 #include "usb/usbdevice.h"
 
 // Post processing
+#include "post/datalogger.h"
+#include "post/eyediagramgenerator.h"
+#include "post/fftthreads.h"
+#include "post/filterprocessor.h"
 #include "post/graphgenerator.h"
+#include "post/harmonicanalyzer.h"
+#include "post/histogramgenerator.h"
+#include "post/masktester.h"
 #include "post/mathchannelgenerator.h"
+#include "post/measurementprocessor.h"
+#include "post/measurementstatistics.h"
 #include "post/postprocessing.h"
+#include "post/protocoldecoder.h"
+#include "post/spectrogramgenerator.h"
+#include "post/spectrumaverager.h"
 #include "post/spectrumgenerator.h"
 
 // Exporter
@@ -73,10 +85,16 @@ void applySettingsToDevice(HantekDsoControl *dsoControl, DsoSettingsScope *scope
                                         std::find(recLenVec.begin(), recLenVec.end(), scope->horizontal.recordLength));
         dsoControl->setRecordLength(index < 0 ? 1 : (unsigned)index);
     }
+    dsoControl->setDisplayedRecordTime(scope->horizontal.timebase * DIVS_TIME);
+    if (dsoControl->setSegmentCount(scope->horizontal.segments) != Dso::ErrorCode::NONE) scope->horizontal.segments = 0;
     dsoControl->setTriggerMode(scope->trigger.mode);
     dsoControl->setPretriggerPosition(scope->trigger.position * scope->horizontal.timebase * DIVS_TIME);
     dsoControl->setTriggerSlope(scope->trigger.slope);
     dsoControl->setTriggerSource(scope->trigger.special, scope->trigger.source);
+    if (dsoControl->setTriggerType(scope->trigger.type) == Dso::ErrorCode::UNSUPPORTED)
+        scope->trigger.type = Dso::TriggerType::Edge;
+    dsoControl->setTriggerTiming(scope->trigger.condition, scope->trigger.time, scope->trigger.timeMax);
+    dsoControl->setTriggerLevelSpan(scope->trigger.levelSpan);
 }
 
 /// \brief Initialize resources and translations and show the main window.
@@ -165,25 +183,78 @@ int main(int argc, char *argv[]) {
     postProcessingThread.setObjectName("postProcessingThread");
     PostProcessing postProcessing(settings.scope.countChannels());
 
+    FftThreads::get()->init();
+    FilterProcessor filterProcessor(&settings.post, device->getModel()->spec()->channels);
     SpectrumGenerator spectrumGenerator(&settings.scope, &settings.post);
+    HarmonicAnalyzer harmonicAnalyzer(&settings.post);
+    SpectrumAverager spectrumAverager(&settings.scope, &settings.post);
+    SpectrogramGenerator spectrogramGenerator(&settings.scope, &settings.view);
     MathChannelGenerator mathchannelGenerator(&settings.scope, device->getModel()->spec()->channels);
-    GraphGenerator graphGenerator(&settings.scope, device->getModel()->spec()->isSoftwareTriggerDevice);
+    MeasurementProcessor measurementProcessor(&settings.scope);
+    MaskTester maskTester(&settings.scope, &settings.post);
+    EyeDiagramGenerator eyeDiagramGenerator(&settings.scope, &settings.post);
+    ProtocolDecoder protocolDecoder(&settings.post);
+    MeasurementStatistics measurementStatistics;
+    Datalogger datalogger(&settings.scope, &settings.post);
+    HistogramGenerator histogramGenerator(&settings.post);
+    GraphGenerator graphGenerator(&settings.scope);
 
     postProcessing.registerProcessor(&samplesToExportRaw);
+    postProcessing.registerProcessor(&filterProcessor);
     postProcessing.registerProcessor(&mathchannelGenerator);
+    postProcessing.registerProcessor(&measurementProcessor);
+    postProcessing.registerProcessor(&maskTester);
+    postProcessing.registerProcessor(&eyeDiagramGenerator);
+    postProcessing.registerProcessor(&protocolDecoder);
     postProcessing.registerProcessor(&spectrumGenerator);
+    postProcessing.registerProcessor(&measurementStatistics);
+    postProcessing.registerProcessor(&datalogger);
+    postProcessing.registerProcessor(&harmonicAnalyzer);
+    postProcessing.registerProcessor(&spectrumAverager);
+    postProcessing.registerProcessor(&spectrogramGenerator);
+    postProcessing.registerProcessor(&histogramGenerator);
     postProcessing.registerProcessor(&graphGenerator);
 
     postProcessing.moveToThread(&postProcessingThread);
+    // The FFT plans are created in the post processing thread, the threshold is tuned there before the first frame
+    QObject::connect(&postProcessingThread, &QThread::started, &postProcessing, []() { FftThreads::get()->tune(); });
     QObject::connect(&dsoControl, &HantekDsoControl::samplesAvailable, &postProcessing, &PostProcessing::input);
     QObject::connect(&postProcessing, &PostProcessing::processingFinished, &exportRegistry, &ExporterRegistry::input,
                      Qt::DirectConnection);
 
     //////// Create main window ////////
     iconFont->initFontAwesome();
-    MainWindow openHantekMainWindow(&dsoControl, &settings, &exportRegistry);
+    MainWindow openHantekMainWindow(&dsoControl, &settings, &exportRegistry, datalogger.trend());
     QObject::connect(&postProcessing, &PostProcessing::processingFinished, &openHantekMainWindow,
                      &MainWindow::showNewData);
+    QObject::connect(&openHantekMainWindow, &MainWindow::resetStatistics,
+                     [&measurementStatistics, &histogramGenerator, &maskTester, &eyeDiagramGenerator]() {
+                         measurementStatistics.reset();
+                         histogramGenerator.reset();
+                         maskTester.reset();
+                         eyeDiagramGenerator.reset();
+                     });
+    QObject::connect(&openHantekMainWindow, &MainWindow::mathExpressionChanged,
+                     [&mathchannelGenerator](ChannelID channel, const QString &expression) {
+                         mathchannelGenerator.setExpression(channel, expression);
+                     });
+    // The processors get copies of the settings that contain containers, the GUI thread may change them anytime
+    QObject::connect(&openHantekMainWindow, &MainWindow::postProcessingChanged,
+                     [&filterProcessor, &datalogger, &maskTester, &mathchannelGenerator, &settings]() {
+                         const std::vector<DsoSettingsScopeVoltage> &voltage = settings.scope.voltage;
+                         for (ChannelID channel = 0; channel < voltage.size(); ++channel)
+                             mathchannelGenerator.setExpression(channel, voltage[channel].mathExpression);
+                         filterProcessor.setFilters(settings.post.filter);
+                         datalogger.setFile(settings.post.datalogger.file);
+                         maskTester.setMask(settings.post.mask);
+                     });
+    QObject::connect(&openHantekMainWindow, &MainWindow::captureGolden,
+                     [&maskTester]() { maskTester.captureGolden(); });
+    QObject::connect(&maskTester, &MaskTester::goldenCaptured, &openHantekMainWindow,
+                     [&maskTester, &settings]() { maskTester.golden(settings.post.mask); });
+    // The failure is reported by the post processing thread, the acquisition is stopped in its own thread
+    QObject::connect(&maskTester, &MaskTester::failed, &dsoControl,
+                     [&dsoControl]() { dsoControl.enableSampling(false); });
     QObject::connect(&exportRegistry, &ExporterRegistry::exporterProgressChanged, &openHantekMainWindow,
                      &MainWindow::exporterProgressChanged);
     QObject::connect(&exportRegistry, &ExporterRegistry::exporterStatusChanged, &openHantekMainWindow,
@@ -2,8 +2,10 @@
 #include "iconfont/QtAwesome.h"
 #include "ui_mainwindow.h"
 
+#include "EyeDock.h"
 #include "HorizontalDock.h"
 #include "SpectrumDock.h"
+#include "TrendDock.h"
 #include "TriggerDock.h"
 #include "VoltageDock.h"
 #include "dockwindows.h"
@@ -25,7 +27,7 @@
 #include <QMessageBox>
 
 MainWindow::MainWindow(HantekDsoControl *dsoControl, DsoSettings *settings, ExporterRegistry *exporterRegistry,
-                       QWidget *parent)
+                       const TrendStore *trend, QWidget *parent)
     : QMainWindow(parent), ui(new Ui::MainWindow), mSettings(settings), exporterRegistry(exporterRegistry) {
     ui->setupUi(this);
     ui->actionSave->setIcon(iconFont->icon(fa::save));
@@ -39,6 +41,7 @@ MainWindow::MainWindow(HantekDsoControl *dsoControl, DsoSettings *settings, Expo
     ui->actionManualCommand->setIcon(iconFont->icon(fa::edit));
     ui->actionDigital_phosphor->setIcon(QIcon(":/images/digitalphosphor.svg"));
     ui->actionZoom->setIcon(iconFont->icon(fa::crop));
+    ui->actionSpectrogram->setIcon(iconFont->icon(fa::th));
     ui->actionCursors->setIcon(iconFont->icon(fa::crosshairs));
 
     // Window title
@@ -73,15 +76,25 @@ MainWindow::MainWindow(HantekDsoControl *dsoControl, DsoSettings *settings, Expo
     TriggerDock *triggerDock;
     SpectrumDock *spectrumDock;
     VoltageDock *voltageDock;
+    TrendDock *trendDock;
     horizontalDock = new HorizontalDock(scope, this);
     triggerDock = new TriggerDock(scope, spec, this);
     spectrumDock = new SpectrumDock(scope, this);
     voltageDock = new VoltageDock(scope, spec, this);
+    trendDock = new TrendDock(scope, &mSettings->view, trend, this);
+    eyeDock = new EyeDock(scope, &mSettings->post, &mSettings->view, this);
 
     addDockWidget(Qt::RightDockWidgetArea, horizontalDock);
     addDockWidget(Qt::RightDockWidgetArea, triggerDock);
     addDockWidget(Qt::RightDockWidgetArea, voltageDock);
     addDockWidget(Qt::RightDockWidgetArea, spectrumDock);
+    addDockWidget(Qt::RightDockWidgetArea, trendDock);
+    addDockWidget(Qt::RightDockWidgetArea, eyeDock);
+    // The trend and the eye are only shown on demand, unless the saved state shows them
+    trendDock->hide();
+    eyeDock->hide();
+    ui->menuView->insertAction(ui->actionResetStatistics, trendDock->toggleViewAction());
+    ui->menuView->insertAction(ui->actionResetStatistics, eyeDock->toggleViewAction());
 
     restoreGeometry(mSettings->mainWindowGeometry);
     restoreState(mSettings->mainWindowState);
@@ -118,6 +131,7 @@ MainWindow::MainWindow(HantekDsoControl *dsoControl, DsoSettings *settings, Expo
     });
     connect(horizontalDock, &HorizontalDock::timebaseChanged, [dsoControl, this]() {
         dsoControl->setRecordTime(mSettings->scope.horizontal.timebase * DIVS_TIME);
+        dsoControl->setDisplayedRecordTime(mSettings->scope.horizontal.timebase * DIVS_TIME);
         this->dsoWidget->updateTimebase(mSettings->scope.horizontal.timebase);
     });
     connect(horizontalDock, &HorizontalDock::frequencybaseChanged, dsoWidget, &DsoWidget::updateFrequencybase);
@@ -134,6 +148,7 @@ MainWindow::MainWindow(HantekDsoControl *dsoControl, DsoSettings *settings, Expo
 
                 // The trigger position should be kept at the same place but the timebase has
                 // changed
+                dsoControl->setDisplayedRecordTime(settings->scope.horizontal.timebase * DIVS_TIME);
                 dsoControl->setPretriggerPosition(settings->scope.trigger.position *
                                                   settings->scope.horizontal.timebase * DIVS_TIME);
 
@@ -155,6 +170,10 @@ MainWindow::MainWindow(HantekDsoControl *dsoControl, DsoSettings *settings, Expo
     connect(triggerDock, &TriggerDock::sourceChanged, dsoWidget, &DsoWidget::updateTriggerSource);
     connect(triggerDock, &TriggerDock::slopeChanged, dsoControl, &HantekDsoControl::setTriggerSlope);
     connect(triggerDock, &TriggerDock::slopeChanged, dsoWidget, &DsoWidget::updateTriggerSlope);
+    connect(triggerDock, &TriggerDock::typeChanged, dsoControl, &HantekDsoControl::setTriggerType);
+    connect(triggerDock, &TriggerDock::typeChanged, dsoWidget, &DsoWidget::updateTriggerType);
+    connect(triggerDock, &TriggerDock::timingChanged, dsoControl, &HantekDsoControl::setTriggerTiming);
+    connect(triggerDock, &TriggerDock::levelSpanChanged, dsoControl, &HantekDsoControl::setTriggerLevelSpan);
     connect(dsoWidget, &DsoWidget::triggerPositionChanged, dsoControl, &HantekDsoControl::setPretriggerPosition);
     connect(dsoWidget, &DsoWidget::triggerLevelChanged, dsoControl, &HantekDsoControl::setTriggerLevel);
 
@@ -162,12 +181,14 @@ MainWindow::MainWindow(HantekDsoControl *dsoControl, DsoSettings *settings, Expo
         if (channel >= (unsigned int)mSettings->scope.voltage.size()) return;
 
 //        if (!used) dsoWidget->
-        bool mathUsed = mSettings->scope.anyUsed(spec->channels);
+        bool mathUsed = false;
+        for (ChannelID math = spec->channels; math < mSettings->scope.voltage.size(); ++math)
+            mathUsed |= mSettings->scope.anyUsed(math);
 
-        // Normal channel, check if voltage/spectrum or math channel is used
+        // Normal channel, check if voltage/spectrum or any math channel is used
         if (channel < spec->channels) dsoControl->setChannelUsed(channel, mathUsed | mSettings->scope.anyUsed(channel));
         // Math channel, update all channels
-        else if (channel == spec->channels) {
+        else {
             for (ChannelID c = 0; c < spec->channels; ++c)
                 dsoControl->setChannelUsed(c, mathUsed | mSettings->scope.anyUsed(c));
         }
@@ -178,6 +199,7 @@ MainWindow::MainWindow(HantekDsoControl *dsoControl, DsoSettings *settings, Expo
     connect(voltageDock, &VoltageDock::couplingChanged, dsoControl, &HantekDsoControl::setCoupling);
     connect(voltageDock, &VoltageDock::couplingChanged, dsoWidget, &DsoWidget::updateVoltageCoupling);
     connect(voltageDock, &VoltageDock::modeChanged, dsoWidget, &DsoWidget::updateMathMode);
+    connect(voltageDock, &VoltageDock::expressionChanged, this, &MainWindow::mathExpressionChanged);
     connect(voltageDock, &VoltageDock::gainChanged, [this, dsoControl, spec](ChannelID channel, double gain) {
         if (channel >= spec->channels) return;
 
@@ -213,11 +235,18 @@ MainWindow::MainWindow(HantekDsoControl *dsoControl, DsoSettings *settings, Expo
     connect(dsoControl, &HantekDsoControl::samplerateLimitsChanged, horizontalDock,
             &HorizontalDock::setSamplerateLimits);
     connect(dsoControl, &HantekDsoControl::samplerateSet, horizontalDock, &HorizontalDock::setSamplerateSteps);
+    connect(dsoControl, &HantekDsoControl::segmentsCaptured, horizontalDock, &HorizontalDock::setSegmentsCaptured);
+    connect(horizontalDock, &HorizontalDock::segmentsChanged, dsoControl, &HantekDsoControl::setSegmentCount);
+    connect(horizontalDock, &HorizontalDock::segmentSelected, dsoControl, &HantekDsoControl::showSegment);
+    connect(horizontalDock, &HorizontalDock::replayRequested, dsoControl, &HantekDsoControl::replaySegments);
 
     connect(ui->actionOpen, &QAction::triggered, [this]() {
         QString fileName = QFileDialog::getOpenFileName(this, tr("Open file"), "", tr("Settings (*.ini)"));
         if (!fileName.isEmpty()) {
-            if (mSettings->setFilename(fileName)) { mSettings->load(); }
+            if (mSettings->setFilename(fileName)) {
+                mSettings->load();
+                emit postProcessingChanged();
+            }
         }
     });
 
@@ -243,6 +272,7 @@ MainWindow::MainWindow(HantekDsoControl *dsoControl, DsoSettings *settings, Expo
         mSettings->mainWindowState = saveState();
 
         DsoConfigDialog *configDialog = new DsoConfigDialog(this->mSettings, this);
+        connect(configDialog, &DsoConfigDialog::applied, this, &MainWindow::postProcessingChanged);
         configDialog->setModal(true);
         configDialog->show();
     });
@@ -269,6 +299,18 @@ MainWindow::MainWindow(HantekDsoControl *dsoControl, DsoSettings *settings, Expo
     });
     ui->actionZoom->setChecked(mSettings->view.zoom);
 
+    connect(ui->actionSpectrogram, &QAction::toggled, [this](bool enabled) {
+        mSettings->view.spectrogram = enabled;
+
+        if (mSettings->view.spectrogram)
+            this->ui->actionSpectrogram->setStatusTip(tr("Hide spectrogram"));
+        else
+            this->ui->actionSpectrogram->setStatusTip(tr("Show spectrogram"));
+
+        this->dsoWidget->updateSpectrogram(enabled);
+    });
+    ui->actionSpectrogram->setChecked(mSettings->view.spectrogram);
+
     connect(ui->actionCursors, &QAction::toggled, [this](bool enabled) {
         mSettings->view.cursorsVisible = enabled;
 
@@ -281,6 +323,9 @@ MainWindow::MainWindow(HantekDsoControl *dsoControl, DsoSettings *settings, Expo
     });
     ui->actionCursors->setChecked(mSettings->view.cursorsVisible);
 
+    connect(ui->actionResetStatistics, &QAction::triggered, this, &MainWindow::resetStatistics);
+    connect(ui->actionCaptureGolden, &QAction::triggered, this, &MainWindow::captureGolden);
+
     connect(ui->actionAbout, &QAction::triggered, [this]() {
         QMessageBox::about(
             this, tr("About OpenHantek %1").arg(VERSION),
@@ -305,7 +350,10 @@ MainWindow::MainWindow(HantekDsoControl *dsoControl, DsoSettings *settings, Expo
 
 MainWindow::~MainWindow() { delete ui; }
 
-void MainWindow::showNewData(std::shared_ptr<PPresult> data) { dsoWidget->showNew(data); }
+void MainWindow::showNewData(std::shared_ptr<PPresult> data) {
+    dsoWidget->showNew(data);
+    eyeDock->showData(data);
+}
 
 void MainWindow::exporterStatusChanged(const QString &exporterName, const QString &status) {
     ui->statusbar->showMessage(tr("%1: %2").arg(exporterName).arg(status));
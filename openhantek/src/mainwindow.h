@@ -8,10 +8,12 @@ class HantekDsoControl;
 class DsoSettings;
 class ExporterRegistry;
 class DsoWidget;
+class EyeDock;
 class HorizontalDock;
 class TriggerDock;
 class SpectrumDock;
 class VoltageDock;
+class TrendStore;
 
 namespace Ui {
 class MainWindow;
@@ -25,13 +27,19 @@ class MainWindow : public QMainWindow {
 
   public:
     explicit MainWindow(HantekDsoControl *dsoControl, DsoSettings *mSettings, ExporterRegistry *exporterRegistry,
-                        QWidget *parent = 0);
+                        const TrendStore *trend, QWidget *parent = 0);
     ~MainWindow();
   public slots:
     void showNewData(std::shared_ptr<PPresult> data);
     void exporterStatusChanged(const QString &exporterName, const QString &status);
     void exporterProgressChanged();
 
+  signals:
+    void resetStatistics(); ///< The user wants to restart the statistics of the measurements
+    void captureGolden();   ///< The user wants a new golden waveform for the mask test
+    void mathExpressionChanged(ChannelID channel, const QString &expression); ///< A math channel has a new expression
+    void postProcessingChanged(); ///< The config dialog has saved or a file has loaded the post processing settings
+
   protected:
     void closeEvent(QCloseEvent *event) override;
 
@@ -40,6 +48,7 @@ class MainWindow : public QMainWindow {
 
     // Central widgets
     DsoWidget *dsoWidget;
+    EyeDock *eyeDock;
 
     // Settings used for the whole program
     DsoSettings *mSettings;
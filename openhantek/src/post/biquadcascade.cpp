@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+
+#include "biquadcascade.h"
+
+namespace {
+/// \brief Appends the sections of a Butterworth low- or high-pass.
+void butterworth(bool highpass, unsigned order, double frequency, std::vector<BiquadCascade::Section> &sections) {
+    const double k = std::tan(M_PI * frequency);
+    const unsigned count = (order + 1) / 2;
+    for (unsigned section = 0; section < count; ++section) {
+        // The poles of a Butterworth filter lie on a circle, each pair gives the quality of one section
+        const double q = 1.0 / (2.0 * std::cos(M_PI * (2 * section + 1) / (4.0 * count)));
+        const double norm = 1.0 / (1.0 + k / q + k * k);
+        BiquadCascade::Section coefficients;
+        if (highpass) {
+            coefficients.b0 = norm;
+            coefficients.b1 = -2.0 * norm;
+        } else {
+            coefficients.b0 = k * k * norm;
+            coefficients.b1 = 2.0 * coefficients.b0;
+        }
+        coefficients.b2 = coefficients.b0;
+        coefficients.a1 = 2.0 * (k * k - 1.0) * norm;
+        coefficients.a2 = (1.0 - k / q + k * k) * norm;
+        sections.push_back(coefficients);
+    }
+}
+} // namespace
+
+std::vector<BiquadCascade::Section> BiquadCascade::design(Dso::FilterType type, unsigned order, double low,
+                                                          double high) {
+    low = std::min(std::max(low, 1e-6), 0.4999);
+    high = std::min(std::max(high, low), 0.4999);
+    order = std::max(order, 2u);
+
+    std::vector<Section> sections;
+    switch (type) {
+    case Dso::FilterType::HIGHPASS:
+        butterworth(true, order, low, sections);
+        break;
+    case Dso::FilterType::BANDPASS:
+        butterworth(true, order, low, sections);
+        butterworth(false, order, high, sections);
+        break;
+    default: // Dso::FilterType::LOWPASS
+        butterworth(false, order, low, sections);
+        break;
+    }
+    return sections;
+}
+
+void BiquadCascade::setSections(std::vector<Section> sections) {
+    this->sections = std::move(sections);
+    states.clear();
+}
+
+void BiquadCascade::settle(double value) {
+    states.resize(sections.size());
+    for (size_t index = 0; index < sections.size(); ++index) {
+        const Section &section = sections[index];
+        // The output of a constant input is the input times the DC gain
+        const double output = value * (section.b0 + section.b1 + section.b2) / (1.0 + section.a1 + section.a2);
+        State &state = states[index];
+        state.z2 = section.b2 * value - section.a2 * output;
+        state.z1 = section.b1 * value - section.a1 * output + state.z2;
+        value = output;
+    }
+}
+
+void BiquadCascade::process(std::vector<double> &samples, bool append) {
+    if (sections.empty() || samples.empty()) return;
+    if (!append || states.size() != sections.size()) settle(samples.front());
+
+    // Section by section, each pass is a short recursion over the whole record
+    for (size_t index = 0; index < sections.size(); ++index) {
+        const Section section = sections[index];
+        double z1 = states[index].z1;
+        double z2 = states[index].z2;
+        for (double &sample : samples) {
+            const double input = sample;
+            const double output = section.b0 * input + z1;
+            z1 = section.b1 * input - section.a1 * output + z2;
+            z2 = section.b2 * input - section.a2 * output;
+            sample = output;
+        }
+        states[index].z1 = z1;
+        states[index].z2 = z2;
+    }
+}
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <vector>
+
+#include "postprocessingsettings.h"
+
+/// \brief IIR filter as a cascade of second order sections.
+/// Every section is a biquad in the transposed direct form II, which keeps two state values and is robust with
+/// double precision. The state is kept between streamed records, a new record starts in the steady state of its
+/// first sample, so there is no step response at the left edge.
+class BiquadCascade {
+  public:
+    /// \brief The coefficients of one section, a0 is normalized to 1.
+    struct Section {
+        double b0, b1, b2;
+        double a1, a2;
+    };
+
+    /// \brief Designs a Butterworth filter by the bilinear transformation.
+    /// \param type The filter type, low-, high- or band-pass. The band-pass is a high-pass followed by a low-pass.
+    /// \param order The order of each edge, rounded up to an even number.
+    /// \param low The cutoff, the lower edge of the band-pass, relative to the samplerate.
+    /// \param high The upper edge of the band-pass, relative to the samplerate.
+    static std::vector<Section> design(Dso::FilterType type, unsigned order, double low, double high);
+
+    /// \brief Sets the sections and resets the state.
+    void setSections(std::vector<Section> sections);
+
+    /// \brief Filters the samples in place.
+    /// \param samples The samples, they are replaced by the filtered samples.
+    /// \param append true, if the samples continue the previous call.
+    void process(std::vector<double> &samples, bool append);
+
+  private:
+    /// \brief The two delayed values of a section.
+    struct State {
+        double z1 = 0.0;
+        double z2 = 0.0;
+    };
+
+    /// \brief Sets the states to the steady state for a constant input.
+    void settle(double value);
+
+    std::vector<Section> sections;
+    std::vector<State> states;
+};
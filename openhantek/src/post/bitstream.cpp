@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+
+#include "bitstream.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+/// \return The position of the lowest set bit, the word must not be 0.
+inline unsigned lowestBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(word);
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return (unsigned)index;
+#else
+    unsigned index = 0;
+    while (!(word & 1)) {
+        word >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+} // namespace
+
+void BitStream::threshold(const std::vector<double> &samples, double lower, double upper, bool append) {
+    count = samples.size();
+    words.resize((count + 63) / 64);
+    edgeList.clear();
+    if (!count) return;
+    // Without a previous frame the first sample defines the level, it is no edge
+    if (!append) level = samples.front() > (lower + upper) / 2;
+
+    const double *const data = samples.data();
+    for (size_t index = 0; index < words.size(); ++index) {
+        const double *const block = data + index * 64;
+        const unsigned length = (unsigned)std::min<size_t>(64, count - index * 64);
+
+        // Plain compares without branches, the compiler vectorizes them
+        uint64_t high = 0, known = 0;
+        for (unsigned bit = 0; bit < length; ++bit) {
+            high |= (uint64_t)(block[bit] > upper) << bit;
+            known |= (uint64_t)((block[bit] > upper) | (block[bit] < lower)) << bit;
+        }
+
+        // The samples within the hysteresis take the level of the last sample outside of it. The first sample is
+        // given the level of the previous word, then the known levels are spread in steps of 1, 2, 4 ... 32 bits.
+        uint64_t value = high | ((uint64_t)level & ~known & 1);
+        known |= 1;
+        for (unsigned shift = 1; shift < 64; shift <<= 1) {
+            value |= (value << shift) & ~known;
+            known |= known << shift;
+        }
+        words[index] = value;
+
+        // A changed bit against the bit before it is an edge
+        uint64_t changes = value ^ ((value << 1) | (uint64_t)level);
+        if (length < 64) changes &= (UINT64_C(1) << length) - 1;
+        while (changes) {
+            edgeList.push_back(index * 64 + lowestBit(changes));
+            changes &= changes - 1;
+        }
+        level = (value >> (length - 1)) & 1;
+    }
+}
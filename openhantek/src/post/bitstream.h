@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// \brief The samples of a channel thresholded into one bit each, packed into 64 bit words.
+/// Sample i of the frame is bit i % 64 of word i / 64. A sample between the lower and the upper threshold keeps the
+/// level of the sample before it, so the noise on a slow edge doesn't give several edges. The positions of the edges
+/// are listed while packing, the decoders walk these lists and only read single bits at their sampling points.
+class BitStream {
+  public:
+    /// \brief Thresholds the samples of a frame.
+    /// \param lower A sample below this level is low.
+    /// \param upper A sample above this level is high.
+    /// \param append true, if the samples continue the previous frame. The first sample continues its last level.
+    void threshold(const std::vector<double> &samples, double lower, double upper, bool append);
+
+    /// \return The level of a sample of the frame.
+    bool bit(size_t position) const { return (words[position >> 6] >> (position & 63)) & 1; }
+    /// \return The positions of the samples whose level differs from the sample before, in ascending order.
+    const std::vector<size_t> &edges() const { return edgeList; }
+    /// \return The number of samples of the frame.
+    size_t size() const { return count; }
+
+  private:
+    std::vector<uint64_t> words;
+    std::vector<size_t> edgeList;
+    size_t count = 0;
+    bool level = false; ///< The level of the last sample
+};
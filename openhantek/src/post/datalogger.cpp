@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <QDateTime>
+#include <QFile>
+
+#include "datalogger.h"
+#include "measurementstatistics.h"
+#include "scopesettings.h"
+
+Datalogger::Datalogger(const DsoSettingsScope *scope, const DsoSettingsPostProcessing *postprocessing)
+    : scope(scope), postprocessing(postprocessing), flushTask([this]() { flush(); }) {
+    writer.setMaxThreadCount(1);
+    logFile = postprocessing->datalogger.file;
+}
+
+Datalogger::~Datalogger() {
+    writer.waitForDone();
+    // Lines that were added while the last flush was running
+    flush();
+}
+
+unsigned Datalogger::seriesIndex(ChannelID channel, Dso::Measurement measurement) {
+    return channel * Dso::MEASUREMENT_COUNT + (unsigned)measurement;
+}
+
+void Datalogger::setFile(const QString &file) {
+    QMutexLocker locker(&pendingMutex);
+    logFile = file;
+}
+
+void Datalogger::process(PPresult *result) {
+    const DsoSettingsDatalogger &settings = postprocessing->datalogger;
+    if (!settings.enabled || !settings.measurements) return;
+    QString fileName;
+    {
+        QMutexLocker locker(&pendingMutex);
+        fileName = logFile;
+    }
+
+    // The trend uses the wall-clock time, it has to match the log file over days
+    const double time = QDateTime::currentMSecsSinceEpoch() / 1000.0;
+    QString lines;
+    for (ChannelID channel = 0; channel < result->channelCount() && channel < scope->voltage.size(); ++channel) {
+        const DataChannel *const channelData = result->data(channel);
+        if (!channelData->measurements.valid) continue;
+
+        for (Dso::Measurement measurement : Dso::MeasurementEnum) {
+            double value;
+            if (!(settings.measurements & Dso::measurementBit(measurement)) ||
+                !MeasurementStatistics::value(*channelData, measurement, value))
+                continue;
+
+            TrendStore::Bucket closed;
+            if (!store.add(seriesIndex(channel, measurement), time, value, closed) || fileName.isEmpty())
+                continue;
+            const QDateTime start = QDateTime::fromMSecsSinceEpoch((qint64)(closed.time * 1000.0)).toUTC();
+            lines += QString("%1,\"%2\",\"%3\",%4,%5,%6,%7\n")
+                         .arg(start.toString(Qt::ISODate), scope->voltage[channel].name,
+                              Dso::measurementString(measurement))
+                         .arg(closed.minimum, 0, 'g', 10)
+                         .arg(closed.maximum, 0, 'g', 10)
+                         .arg(closed.mean(), 0, 'g', 10)
+                         .arg(closed.count);
+        }
+    }
+    if (lines.isEmpty()) return;
+
+    {
+        QMutexLocker locker(&pendingMutex);
+        // A new file starts with the lines of the new file only
+        if (pendingFile != fileName) pending.clear();
+        pendingFile = fileName;
+        pending += lines;
+    }
+    if (!flushQueued.exchange(true)) writer.start(&flushTask);
+}
+
+void Datalogger::flush() {
+    flushQueued = false;
+    QString lines, fileName;
+    {
+        QMutexLocker locker(&pendingMutex);
+        lines.swap(pending);
+        fileName = pendingFile;
+    }
+    if (lines.isEmpty() || fileName.isEmpty()) return;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) return;
+    if (file.size() == 0) file.write("time,channel,measurement,minimum,maximum,mean,count\n");
+    file.write(lines.toUtf8());
+}
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <atomic>
+
+#include <QMutex>
+#include <QString>
+#include <QThreadPool>
+
+#include "pooltask.h"
+#include "postprocessingsettings.h"
+#include "processor.h"
+#include "trendstore.h"
+
+struct DsoSettingsScope;
+
+/// \brief Records the selected measurements of every frame for the long-term trend.
+/// Runs after the MeasurementProcessor and the SpectrumGenerator. The values go into a TrendStore, which the trend
+/// plot reads. Every completed 1 s bucket is appended to the log file as a CSV line. The lines are collected here
+/// and written by a separate thread, so a slow disk never delays the post processing.
+class Datalogger : public Processor {
+  public:
+    Datalogger(const DsoSettingsScope *scope, const DsoSettingsPostProcessing *postprocessing);
+    ~Datalogger();
+    virtual void process(PPresult *result) override;
+
+    /// \return The trend of all logged measurements.
+    const TrendStore *trend() const { return &store; }
+    /// \return The index of the series of a measurement in the TrendStore.
+    static unsigned seriesIndex(ChannelID channel, Dso::Measurement measurement);
+    /// \brief Sets the log file for the following buckets, can be called from any thread.
+    void setFile(const QString &file);
+
+  private:
+    /// \brief Appends the pending lines to the log file, runs in the writer thread.
+    void flush();
+
+    const DsoSettingsScope *scope;
+    const DsoSettingsPostProcessing *postprocessing;
+    TrendStore store;
+
+    QMutex pendingMutex; ///< Guards the pending lines and the log file
+    QString pending;     ///< Lines that are not written yet
+    QString pendingFile; ///< The file the pending lines belong to
+    QString logFile;     ///< The file of new lines, set by the GUI thread
+    std::atomic<bool> flushQueued{false};
+    PoolTask flushTask;
+    QThreadPool writer; ///< A single thread, the lines are written in order
+};
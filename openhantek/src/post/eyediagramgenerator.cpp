@@ -0,0 +1,256 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+
+#include "eyediagramgenerator.h"
+#include "scopesettings.h"
+#include "viewconstants.h"
+
+namespace {
+/// Horizontal resolution of the density.
+const unsigned COLUMNS_PER_UNIT_INTERVAL = 128;
+/// Vertical resolution of the density, the rows cover the screen height.
+const unsigned ROWS = 256;
+/// Hysteresis of the crossings relative to the amplitude.
+const double HYSTERESIS = 0.1;
+/// A recovered bit period that differs more than this restarts the accumulation.
+const double PERIOD_TOLERANCE = 0.02;
+/// Width of the center of the eye that is used for the height, relative to the unit interval.
+const double CENTER_WIDTH = 0.2;
+/// The measurements need at least this many hits at the crossings and in the center.
+const unsigned long long MIN_HITS = 10;
+} // namespace
+
+EyeDiagramGenerator::EyeDiagramGenerator(const DsoSettingsScope *scope,
+                                         const DsoSettingsPostProcessing *postprocessing)
+    : scope(scope), postprocessing(postprocessing) {}
+
+double EyeDiagramGenerator::recoverUnitInterval(const std::vector<double> &crossings) {
+    if (crossings.size() < 2) return 0.0;
+    std::vector<double> distances(crossings.size() - 1);
+    for (size_t index = 0; index < distances.size(); ++index)
+        distances[index] = crossings[index + 1] - crossings[index];
+
+    // A low quantile instead of the minimum, a single glitch doesn't halve the estimate
+    std::vector<double> sorted(distances);
+    const size_t quantile = sorted.size() / 20;
+    std::nth_element(sorted.begin(), sorted.begin() + (long)quantile, sorted.end());
+    double estimate = sorted[quantile];
+    if (estimate <= 0.0) return 0.0;
+
+    // Each crossing gets its bit number, the slope of the times over the numbers is the bit period.
+    // A second pass counts the long distances again with the better estimate.
+    for (unsigned pass = 0; pass < 2; ++pass) {
+        double bit = 0.0, sumBits = 0.0, sumTimes = 0.0, sumBitSquares = 0.0, sumProducts = 0.0;
+        for (size_t index = 0; index < crossings.size(); ++index) {
+            if (index) bit += std::max(std::round(distances[index - 1] / estimate), 1.0);
+            sumBits += bit;
+            sumTimes += crossings[index];
+            sumBitSquares += bit * bit;
+            sumProducts += bit * crossings[index];
+        }
+        const double count = crossings.size();
+        const double denominator = count * sumBitSquares - sumBits * sumBits;
+        if (denominator <= 0.0) break;
+        estimate = (count * sumProducts - sumBits * sumTimes) / denominator;
+    }
+    return estimate;
+}
+
+void EyeDiagramGenerator::findCrossings(const std::vector<double> &samples, double threshold, double hysteresis,
+                                        double start, double interval) {
+    crossings.clear();
+    int state = 0; // -1 below, 1 above the hysteresis, 0 unknown
+    double candidate = -1.0;
+    for (size_t position = 1; position < samples.size(); ++position) {
+        const double previous = samples[position - 1];
+        const double current = samples[position];
+        // The last pass of the threshold before the hysteresis is left is the crossing
+        if ((previous < threshold) != (current < threshold))
+            candidate = position - 1 + (threshold - previous) / (current - previous);
+
+        int next = state;
+        if (current > threshold + hysteresis)
+            next = 1;
+        else if (current < threshold - hysteresis)
+            next = -1;
+        if (next != state) {
+            if (state != 0 && candidate >= 0.0) crossings.push_back(start + candidate * interval);
+            state = next;
+            candidate = -1.0;
+        }
+    }
+}
+
+void EyeDiagramGenerator::measure(double thresholdRow, double voltsPerRow) {
+    eye.measured = false;
+    const int threshold = (int)thresholdRow;
+    if (threshold < 0 || threshold >= (int)eye.rows) return;
+
+    // Phase of a column relative to the nearest crossing, -0.5 .. 0.5 unit intervals
+    const double crossingPhase = (eye.unitIntervals - 1) * 0.5;
+    std::vector<double> distance(eye.columns);
+    for (unsigned column = 0; column < eye.columns; ++column) {
+        const double phase = (column + 0.5) / COLUMNS_PER_UNIT_INTERVAL - crossingPhase;
+        distance[column] = phase - std::floor(phase + 0.5);
+    }
+
+    // The spread of the hits at the threshold level is the jitter
+    const int band = std::max(1, (int)eye.rows / 128);
+    unsigned long long hits = 0;
+    double sum = 0.0, sumOfSquares = 0.0, earliest = 0.5, latest = -0.5;
+    for (int row = std::max(threshold - band, 0); row <= std::min(threshold + band, (int)eye.rows - 1); ++row) {
+        const unsigned *const counts = eye.density.data() + (size_t)row * eye.columns;
+        for (unsigned column = 0; column < eye.columns; ++column) {
+            if (!counts[column]) continue;
+            hits += counts[column];
+            sum += counts[column] * distance[column];
+            sumOfSquares += counts[column] * distance[column] * distance[column];
+            earliest = std::min(earliest, distance[column]);
+            latest = std::max(latest, distance[column]);
+        }
+    }
+    if (hits < MIN_HITS) return;
+    const double mean = sum / hits;
+    const double sigma = std::sqrt(std::max(sumOfSquares / hits - mean * mean, 0.0));
+
+    // The levels in the center of the eye, above and below the threshold
+    unsigned long long upperHits = 0, lowerHits = 0;
+    double upperSum = 0.0, upperSquares = 0.0, lowerSum = 0.0, lowerSquares = 0.0;
+    for (unsigned row = 0; row < eye.rows; ++row) {
+        const unsigned *const counts = eye.density.data() + (size_t)row * eye.columns;
+        const double level = row + 0.5;
+        for (unsigned column = 0; column < eye.columns; ++column) {
+            if (!counts[column] || std::abs(distance[column]) < 0.5 - CENTER_WIDTH / 2) continue;
+            if (level > thresholdRow) {
+                upperHits += counts[column];
+                upperSum += counts[column] * level;
+                upperSquares += counts[column] * level * level;
+            } else {
+                lowerHits += counts[column];
+                lowerSum += counts[column] * level;
+                lowerSquares += counts[column] * level * level;
+            }
+        }
+    }
+    if (upperHits < MIN_HITS || lowerHits < MIN_HITS) return;
+    const double upperMean = upperSum / upperHits;
+    const double lowerMean = lowerSum / lowerHits;
+    const double upperSigma = std::sqrt(std::max(upperSquares / upperHits - upperMean * upperMean, 0.0));
+    const double lowerSigma = std::sqrt(std::max(lowerSquares / lowerHits - lowerMean * lowerMean, 0.0));
+
+    eye.measured = true;
+    eye.jitterRms = sigma * eye.unitInterval;
+    eye.jitterPeakToPeak = (latest - earliest) * eye.unitInterval;
+    eye.width = std::max(1.0 - 6.0 * sigma, 0.0) * eye.unitInterval;
+    eye.height =
+        std::max((upperMean - 3.0 * upperSigma) - (lowerMean + 3.0 * lowerSigma), 0.0) * std::abs(voltsPerRow);
+}
+
+void EyeDiagramGenerator::process(PPresult *result) {
+    const DsoSettingsEye &settings = postprocessing->eye;
+    if (resetRequested.exchange(false) || !settings.enabled) eye = EyeDiagram();
+    if (!settings.enabled || result->append || settings.channel >= result->channelCount() ||
+        settings.channel >= scope->voltage.size())
+        return;
+
+    const DataChannel *const channelData = result->data(settings.channel);
+    const std::vector<double> &samples = channelData->voltage.sample;
+    const double interval = channelData->voltage.interval;
+    if (samples.size() < 2 || interval <= 0.0 || !result->softwareTriggerTriggered) {
+        result->eye = eye;
+        return;
+    }
+
+    // The decision threshold lies between the levels of the signal
+    double top, base;
+    if (channelData->measurements.valid) {
+        top = channelData->measurements.top;
+        base = channelData->measurements.base;
+    } else {
+        const auto range = std::minmax_element(samples.begin(), samples.end());
+        top = *range.second;
+        base = *range.first;
+    }
+    if (top <= base) {
+        result->eye = eye;
+        return;
+    }
+    const double threshold = (top + base) / 2.0;
+    // The time is counted from the left edge of the screen, softwareTriggerOffset is the first sample on it
+    const double start = -(result->softwareTriggerOffset + result->softwareTriggerFraction) * interval;
+    findCrossings(samples, threshold, (top - base) * HYSTERESIS, start, interval);
+
+    double unitInterval = settings.recoverBitRate ? recoverUnitInterval(crossings)
+                                                  : (settings.bitRate > 0.0 ? 1.0 / settings.bitRate : 0.0);
+    if (unitInterval <= 0.0) unitInterval = eye.unitInterval;
+    if (unitInterval <= 0.0) {
+        result->eye = eye;
+        return;
+    }
+
+    // A new geometry can't be added to the old density
+    const unsigned unitIntervals = std::min(std::max(settings.unitIntervals, 1u), 2u);
+    const unsigned columns = COLUMNS_PER_UNIT_INTERVAL * unitIntervals;
+    const double gain = scope->gain(settings.channel);
+    const DsoSettingsScopeVoltage &voltage = scope->voltage[settings.channel];
+    if (eye.columns != columns || eye.channel != settings.channel || gain != eyeGain || voltage.offset != eyeOffset ||
+        voltage.inverted != eyeInverted ||
+        std::abs(unitInterval - referenceInterval) > PERIOD_TOLERANCE * referenceInterval) {
+        eye = EyeDiagram();
+        eye.columns = columns;
+        eye.rows = ROWS;
+        eye.unitIntervals = unitIntervals;
+        eye.channel = settings.channel;
+        eye.density.assign((size_t)columns * ROWS, 0);
+        referenceInterval = unitInterval;
+        eyeGain = gain;
+        eyeOffset = voltage.offset;
+        eyeInverted = voltage.inverted;
+    }
+    eye.unitInterval = unitInterval;
+
+    // The mean phase of the crossings, as angle it isn't disturbed by the wrap-around
+    double sine = 0.0, cosine = 0.0;
+    for (double crossing : crossings) {
+        const double angle = 2.0 * M_PI * crossing / unitInterval;
+        sine += std::sin(angle);
+        cosine += std::cos(angle);
+    }
+    const double crossingPhase = crossings.empty() ? 0.0 : std::atan2(sine, cosine) / (2.0 * M_PI);
+
+    // Old hits fade, the persistence is rounded down to a power of two. The loss is rounded up, so single hits
+    // disappear as well.
+    if (settings.persistence > 1) {
+        unsigned shift = 0;
+        while ((2u << shift) <= settings.persistence) ++shift;
+        const unsigned mask = (1u << shift) - 1;
+        for (unsigned &count : eye.density) count -= (count + mask) >> shift;
+    }
+
+    // The crossings are at the edges of a single unit interval, two unit intervals show one eye in the center
+    const double span = unitIntervals;
+    double phase = std::fmod(start / unitInterval - crossingPhase + (unitIntervals - 1) * 0.5, span);
+    if (phase < 0.0) phase += span;
+    const double phaseStep = std::fmod(interval / unitInterval, span);
+    const float invert = voltage.inverted ? -1.0f : 1.0f;
+    const double rowFactor = ROWS / DIVS_VOLTAGE * invert / gain;
+    const double rowOffset = (voltage.offset + DIVS_VOLTAGE / 2) * ROWS / DIVS_VOLTAGE;
+    unsigned *const density = eye.density.data();
+    for (double sample : samples) {
+        const double row = sample * rowFactor + rowOffset;
+        if (row >= 0.0 && row < ROWS) {
+            const unsigned column = std::min((unsigned)(phase * COLUMNS_PER_UNIT_INTERVAL), columns - 1);
+            ++density[(size_t)row * columns + column];
+        }
+        phase += phaseStep;
+        if (phase >= span) phase -= span;
+    }
+
+    eye.maximum = *std::max_element(eye.density.begin(), eye.density.end());
+    ++eye.frames;
+    measure(threshold * rowFactor + rowOffset, DIVS_VOLTAGE / ROWS * gain);
+    result->eye = eye;
+}
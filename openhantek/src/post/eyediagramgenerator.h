@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "postprocessingsettings.h"
+#include "processor.h"
+
+struct DsoSettingsScope;
+
+/// \brief Folds the frames of a voltage channel into the hit density of an eye diagram.
+/// The bit period is configured or recovered from the threshold crossings of each frame, the crossings also give the
+/// phase of the bits relative to the screen. Every sample is counted into an integer bin by its phase within the
+/// shown unit intervals and its position on the screen, which is O(samples) per frame. With a persistence the counts
+/// fade by a power of two each frame. Eye height, width and jitter are taken from the density after every frame.
+class EyeDiagramGenerator : public Processor {
+  public:
+    EyeDiagramGenerator(const DsoSettingsScope *scope, const DsoSettingsPostProcessing *postprocessing);
+    virtual void process(PPresult *result) override;
+
+    /// \brief Restarts the accumulation with the next frame, can be called from any thread.
+    void reset() { resetRequested = true; }
+
+    /// \brief Recovers the bit period from the crossing times.
+    /// The distances between crossings are whole numbers of bits, the shortest common distance gives a first estimate
+    /// that is refined by a line fit of the crossing times over the bit numbers.
+    /// \return The bit period, 0 if there are less than two crossings.
+    static double recoverUnitInterval(const std::vector<double> &crossings);
+
+  private:
+    /// \brief Collects the times where the samples cross the threshold, the hysteresis suppresses noise.
+    void findCrossings(const std::vector<double> &samples, double threshold, double hysteresis, double start,
+                       double interval);
+    /// \brief Takes height, width and jitter from the density.
+    /// \param thresholdRow The row of the decision threshold.
+    /// \param voltsPerRow The height of a row (V).
+    void measure(double thresholdRow, double voltsPerRow);
+
+    const DsoSettingsScope *scope;
+    const DsoSettingsPostProcessing *postprocessing;
+
+    EyeDiagram eye;                 ///< The accumulated density
+    double referenceInterval = 0.0; ///< The bit period of the first accumulated frame
+    double eyeGain = 0.0;           ///< The gain the density was accumulated with
+    double eyeOffset = 0.0;         ///< The offset the density was accumulated with
+    bool eyeInverted = false;       ///< The inversion the density was accumulated with
+    std::vector<double> crossings;  ///< Crossing times of the current frame, from the left edge of the screen (s)
+    std::atomic<bool> resetRequested{false};
+};
@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include "fftsize.h"
+
+namespace {
+/// The radices FFTW has optimized codelets for.
+const unsigned FAST_FACTORS[] = {2, 3, 5, 7};
+} // namespace
+
+bool FftSize::isFast(unsigned length) {
+    if (length == 0) return false;
+    for (unsigned factor : FAST_FACTORS) {
+        while (length % factor == 0) length /= factor;
+    }
+    return length == 1;
+}
+
+unsigned FftSize::below(unsigned length) {
+    while (length > 1 && !isFast(length)) --length;
+    return length;
+}
+
+unsigned FftSize::above(unsigned length) {
+    while (!isFast(length)) ++length;
+    return length;
+}
@@ -0,0 +1,17 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+/// \brief Transformation lengths that FFTW handles fast.
+/// FFTW has optimized codelets for the radices 2, 3, 5 and 7, other prime factors fall back to slower generic
+/// algorithms. Record lengths are therefore fitted to the nearest length without larger prime factors
+/// (7-smooth). These are dense enough that the fitted length differs by a few percent at most.
+class FftSize {
+  public:
+    /// \return true, if the length has no prime factor above 7.
+    static bool isFast(unsigned length);
+    /// \return The largest fast length that is not above the given length, used to truncate the record.
+    static unsigned below(unsigned length);
+    /// \return The smallest fast length that is not below the given length, used to zero-pad the record.
+    static unsigned above(unsigned length);
+};
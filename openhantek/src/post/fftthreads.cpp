@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+#include <limits>
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <fftw3.h>
+
+#include "fftthreads.h"
+
+namespace {
+/// Threads that are not available for the post processing: the GUI and the acquisition.
+const int RESERVED_THREADS = 2;
+/// Range of the lengths that are timed for the threshold.
+const unsigned MIN_TUNED_LENGTH = 1 << 14;
+const unsigned MAX_TUNED_LENGTH = 1 << 20;
+/// Number of samples that are transformed for each timed length, split into repeated transformations.
+const unsigned TUNING_SAMPLES = 1 << 20;
+/// The threads have to save at least this part of the time to be used.
+const double MIN_SPEEDUP = 1.25;
+/// Threshold that disables multithreaded transformations.
+const unsigned NEVER = std::numeric_limits<unsigned>::max();
+} // namespace
+
+FftThreads::Planning::Planning(unsigned threads) {
+#ifdef HAVE_FFTW_THREADS
+    if (FftThreads::get()->initialized) fftw_plan_with_nthreads((int)std::max(1u, threads));
+#else
+    Q_UNUSED(threads);
+#endif
+}
+
+FftThreads::Planning::~Planning() {
+#ifdef HAVE_FFTW_THREADS
+    if (FftThreads::get()->initialized) fftw_plan_with_nthreads(1);
+#endif
+}
+
+FftThreads *FftThreads::get() {
+    static FftThreads inst;
+    return &inst;
+}
+
+void FftThreads::init() {
+    budget = (unsigned)std::max(1, QThread::idealThreadCount() - RESERVED_THREADS);
+#ifdef HAVE_FFTW_THREADS
+    initialized = fftw_init_threads() != 0;
+    if (!initialized) qWarning() << "FFTW thread support could not be initialized";
+#endif
+    if (!initialized) budget = 1;
+}
+
+unsigned FftThreads::threadsFor(unsigned length, unsigned threshold) {
+    if (!initialized || budget < 2) return 1;
+    if (threshold == 0) {
+        if (tunedThreshold == 0) return 1;
+        threshold = tunedThreshold;
+    }
+    return length >= threshold ? budget : 1;
+}
+
+double FftThreads::measure(unsigned length, unsigned threads) const {
+    double *real = fftw_alloc_real(length);
+    fftw_complex *bins = fftw_alloc_complex(length / 2 + 1);
+    std::fill(real, real + length, 0.0);
+
+    double elapsed = 0.0;
+    {
+        Planning planning(threads);
+        fftw_plan plan = fftw_plan_dft_r2c_1d((int)length, real, bins, FFTW_ESTIMATE);
+        // The first run starts the threads and fills the caches
+        fftw_execute(plan);
+
+        const unsigned repetitions = std::max(1u, TUNING_SAMPLES / length);
+        QElapsedTimer timer;
+        timer.start();
+        for (unsigned repetition = 0; repetition < repetitions; ++repetition) fftw_execute(plan);
+        elapsed = (double)timer.nsecsElapsed() / repetitions;
+        fftw_destroy_plan(plan);
+    }
+
+    fftw_free(real);
+    fftw_free(bins);
+    return elapsed;
+}
+
+void FftThreads::tune() {
+    if (!initialized || budget < 2 || tunedThreshold != 0) return;
+    unsigned threshold = NEVER;
+    for (unsigned length = MIN_TUNED_LENGTH; length <= MAX_TUNED_LENGTH; length *= 2) {
+        if (measure(length, 1) >= measure(length, budget) * MIN_SPEEDUP) {
+            threshold = length;
+            break;
+        }
+    }
+    tunedThreshold = threshold;
+}
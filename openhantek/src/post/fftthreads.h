@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+/// \brief Multithreaded FFTW transformations of long records.
+/// The post processing may use all cores except the ones of the GUI and the acquisition thread. Plans for
+/// transformations above a threshold length are created for this number of threads, shorter ones stay
+/// single-threaded because the synchronization would cost more than it saves. The threshold is tuned once at
+/// startup by timing single- and multithreaded transformations of increasing length. FFTW needs to be built
+/// with thread support (HAVE_FFTW_THREADS), otherwise all plans are single-threaded.
+class FftThreads {
+  public:
+    /// \brief Sets the number of threads for the plans created while it exists.
+    /// The number is a global setting of the FFTW planner, so all plans have to be created in the same thread.
+    class Planning {
+      public:
+        /// \param threads The number of threads, usually from FftThreads::threadsFor().
+        explicit Planning(unsigned threads);
+        ~Planning();
+    };
+
+    static FftThreads *get();
+
+    /// \brief Initializes the thread support of FFTW, needs to be called before any plan is created.
+    void init();
+    /// \return The number of threads the post processing may use, including the calling thread.
+    unsigned threadBudget() const { return budget; }
+    /// \brief Returns the number of threads for a transformation.
+    /// \param length The length of the transformation.
+    /// \param threshold The minimum length of multithreaded transformations, 0 for the tuned threshold.
+    /// \return The number of threads the plan should be created with.
+    unsigned threadsFor(unsigned length, unsigned threshold);
+    /// \brief Finds the shortest length that is transformed faster by all threads than by one.
+    /// Called once when the thread that creates the plans starts, until then all plans are single-threaded.
+    void tune();
+
+  private:
+    /// \brief Measures the time of a transformation in ns.
+    double measure(unsigned length, unsigned threads) const;
+
+    bool initialized = false;
+    unsigned budget = 1;
+    unsigned tunedThreshold = 0; ///< 0 until the threshold has been tuned
+};
@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+
+#include <QStringList>
+
+#include "filterprocessor.h"
+
+namespace {
+/// \return true, if the filter has to be designed again.
+bool changed(const DsoSettingsFilter &current, const DsoSettingsFilter &designed) {
+    if (current.type != designed.type) return true;
+    if (current.type == Dso::FilterType::CUSTOM) return current.coefficients != designed.coefficients;
+    return current.design != designed.design || current.low != designed.low || current.high != designed.high ||
+           (current.design == Dso::FilterDesign::FIR ? current.taps != designed.taps : current.order != designed.order);
+}
+} // namespace
+
+FilterProcessor::FilterProcessor(const DsoSettingsPostProcessing *postprocessing, unsigned physicalChannels)
+    : physicalChannels(physicalChannels), settings(postprocessing->filter) {}
+
+void FilterProcessor::setFilters(const std::vector<DsoSettingsFilter> &filters) {
+    QMutexLocker locker(&settingsMutex);
+    pendingSettings = filters;
+    settingsChanged = true;
+}
+
+void FilterProcessor::design(ChannelFilter &filter) {
+    const DsoSettingsFilter &settings = filter.settings;
+    if (settings.type == Dso::FilterType::CUSTOM) {
+        std::vector<double> taps;
+        const QString text = QString(settings.coefficients).replace(',', ' ').replace(';', ' ').simplified();
+        for (const QString &value : text.split(' ', QString::SkipEmptyParts)) {
+            bool ok = false;
+            const double tap = value.toDouble(&ok);
+            if (ok) taps.push_back(tap);
+        }
+        filter.fir.setTaps(taps);
+        filter.iir.setSections({});
+        return;
+    }
+
+    // The cutoffs relative to the samplerate
+    const double low = settings.low * filter.interval;
+    const double high = settings.high * filter.interval;
+    if (settings.design == Dso::FilterDesign::FIR) {
+        filter.fir.setTaps(FirFilter::design(settings.type, settings.taps, low, high));
+        filter.iir.setSections({});
+    } else {
+        filter.iir.setSections(BiquadCascade::design(settings.type, settings.order, low, high));
+        filter.fir.setTaps({});
+    }
+}
+
+void FilterProcessor::process(PPresult *result) {
+    {
+        QMutexLocker locker(&settingsMutex);
+        if (settingsChanged) settings.swap(pendingSettings);
+        settingsChanged = false;
+    }
+
+    const unsigned channelCount = std::min(physicalChannels, (unsigned)settings.size());
+    while (filters.size() < channelCount) filters.emplace_back(new ChannelFilter);
+
+    for (ChannelID channel = 0; channel < channelCount && channel < result->channelCount(); ++channel) {
+        ChannelFilter &filter = *filters[channel];
+        const DsoSettingsFilter &channelSettings = settings[channel];
+        if (channelSettings.type == Dso::FilterType::OFF) {
+            filter.designed = false;
+            continue;
+        }
+
+        DataChannel *const channelData = result->modifyData(channel);
+        if (channelData->voltage.sample.empty() || channelData->voltage.interval <= 0.0) continue;
+
+        if (!filter.designed || filter.interval != channelData->voltage.interval ||
+            changed(channelSettings, filter.settings)) {
+            filter.settings = channelSettings;
+            filter.interval = channelData->voltage.interval;
+            design(filter);
+            filter.designed = true;
+        }
+
+        // Only one of both filters has coefficients
+        filter.fir.process(channelData->voltage.sample, result->append);
+        filter.iir.process(channelData->voltage.sample, result->append);
+        // The result depends on the filter state as well
+        channelData->generation = 0;
+    }
+}
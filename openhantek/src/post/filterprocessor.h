@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <QMutex>
+
+#include "biquadcascade.h"
+#include "firfilter.h"
+#include "postprocessingsettings.h"
+#include "processor.h"
+
+/// \brief Filters the samples of the physical channels.
+/// Runs before the math channels and the spectrum, so everything that follows sees the filtered signal. The
+/// filters are designed again only if their settings or the samplerate change, their state continues across the
+/// packets of the roll mode. The settings are handed over as a copy, the GUI thread may change its own anytime.
+class FilterProcessor : public Processor {
+  public:
+    FilterProcessor(const DsoSettingsPostProcessing *postprocessing, unsigned physicalChannels);
+    virtual void process(PPresult *result) override;
+
+    /// \brief Sets the filters of the physical channels, can be called from any thread.
+    /// The settings are copied and used from the next record on.
+    void setFilters(const std::vector<DsoSettingsFilter> &filters);
+
+  private:
+    /// \brief The filter of one channel and the settings it was designed for.
+    struct ChannelFilter {
+        DsoSettingsFilter settings;
+        double interval = 0.0;
+        bool designed = false;
+        FirFilter fir;
+        BiquadCascade iir;
+    };
+
+    /// \brief Designs the filter of a channel for its settings and the sample interval.
+    static void design(ChannelFilter &filter);
+
+    const unsigned physicalChannels;
+    std::vector<std::unique_ptr<ChannelFilter>> filters; ///< One filter for each physical channel
+    std::vector<DsoSettingsFilter> settings;             ///< The settings of the filters of the current record
+    std::vector<DsoSettingsFilter> pendingSettings;      ///< Set by setFilters(), used with the next record
+    bool settingsChanged = false;                        ///< The pending settings are new
+    QMutex settingsMutex;                                ///< Guards the pending settings
+};
@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+
+#include "firfilter.h"
+#include "windowcache.h"
+
+namespace {
+/// Outputs of the direct convolution that are accumulated together, they stay in the L1 cache.
+const size_t DIRECT_BLOCK = 256;
+/// Relative cost of a multiply-add of the direct convolution, it runs on several SIMD lanes at once.
+const double DIRECT_COST = 0.25;
+/// Relative cost of a real FFT per length * log2(length).
+const double FFT_COST = 1.0;
+/// The overlap-save blocks are at least this many times longer than the filter.
+const unsigned MIN_BLOCK_FACTOR = 2;
+/// The longest block the cost model tries.
+const unsigned MAX_BLOCK_LENGTH = 1u << 20;
+
+/// \brief Low-pass taps without the window, sin(2 pi f n) / (pi n).
+double sinc(double frequency, double position) {
+    if (position == 0.0) return 2.0 * frequency;
+    return std::sin(2.0 * M_PI * frequency * position) / (M_PI * position);
+}
+} // namespace
+
+FirFilter::~FirFilter() { release(); }
+
+std::vector<double> FirFilter::design(Dso::FilterType type, unsigned length, double low, double high) {
+    // An odd length puts the center on a tap, that is needed for the spectral inversion
+    length |= 1;
+    low = std::min(std::max(low, 1e-6), 0.4999);
+    high = std::min(std::max(high, low), 0.4999);
+
+    const std::shared_ptr<const WindowCache::Table> window =
+        WindowCache::get()->table(Dso::WindowFunction::BLACKMAN, length);
+    const double center = (length - 1) / 2.0;
+    std::vector<double> taps(length);
+
+    // Low-pass with the cutoff that is needed by the type
+    auto lowpass = [&](double frequency, std::vector<double> &target) {
+        double sum = 0.0;
+        for (unsigned position = 0; position < length; ++position) {
+            target[position] = sinc(frequency, position - center) * (*window)[position];
+            sum += target[position];
+        }
+        // Unity gain at DC
+        for (double &tap : target) tap /= sum;
+    };
+
+    switch (type) {
+    case Dso::FilterType::HIGHPASS:
+        lowpass(low, taps);
+        for (double &tap : taps) tap = -tap;
+        taps[length / 2] += 1.0;
+        break;
+    case Dso::FilterType::BANDPASS: {
+        std::vector<double> lower(length);
+        lowpass(high, taps);
+        lowpass(low, lower);
+        for (unsigned position = 0; position < length; ++position) taps[position] -= lower[position];
+    } break;
+    default: // Dso::FilterType::LOWPASS
+        lowpass(low, taps);
+        break;
+    }
+    return taps;
+}
+
+void FirFilter::setTaps(std::vector<double> taps) {
+    coefficients = std::move(taps);
+    reversed.assign(coefficients.rbegin(), coefficients.rend());
+    history.clear();
+    // The frequency response has to be calculated again
+    release();
+}
+
+unsigned FirFilter::fftLength(size_t taps, size_t outputs) {
+    if (taps < 2 || outputs == 0) return 0;
+    const double directCost = DIRECT_COST * (double)taps * (double)outputs;
+
+    // Longer blocks need fewer transformations, but a block beyond the record is wasted
+    unsigned length = 1;
+    while (length < MIN_BLOCK_FACTOR * taps) length <<= 1;
+    unsigned best = 0;
+    double bestCost = directCost;
+    for (; length <= MAX_BLOCK_LENGTH; length <<= 1) {
+        const size_t step = length - taps + 1;
+        const double blocks = std::ceil((double)outputs / (double)step);
+        // One forward and one inverse transformation and the product of the bins
+        const double cost = blocks * (2.0 * FFT_COST * length * std::log2((double)length) + 2.0 * length);
+        if (cost < bestCost) {
+            bestCost = cost;
+            best = length;
+        }
+        if (step >= outputs) break;
+    }
+    return best;
+}
+
+void FirFilter::direct(const double *input, size_t count, double *output) const {
+    const size_t tapCount = reversed.size();
+    const double *taps = reversed.data();
+    double sums[DIRECT_BLOCK];
+
+    for (size_t offset = 0; offset < count; offset += DIRECT_BLOCK) {
+        const size_t blockCount = std::min(DIRECT_BLOCK, count - offset);
+        const double *blockInput = input + offset;
+        std::fill_n(sums, blockCount, 0.0);
+        // Every tap is applied to the whole block, the inner loop has no dependencies and is vectorized
+        for (size_t tap = 0; tap < tapCount; ++tap) {
+            const double factor = taps[tap];
+            const double *values = blockInput + tap;
+            for (size_t i = 0; i < blockCount; ++i) sums[i] += factor * values[i];
+        }
+        std::copy(sums, sums + blockCount, output + offset);
+    }
+}
+
+void FirFilter::release() {
+    if (forward) fftw_destroy_plan(forward);
+    if (inverse) fftw_destroy_plan(inverse);
+    fftw_free(block);
+    fftw_free(spectrum);
+    fftw_free(response);
+    forward = inverse = nullptr;
+    block = nullptr;
+    spectrum = response = nullptr;
+    blockLength = 0;
+}
+
+void FirFilter::prepare(unsigned length) {
+    if (length == blockLength) return;
+    release();
+    blockLength = length;
+    const unsigned binCount = length / 2 + 1;
+    block = fftw_alloc_real(length);
+    spectrum = fftw_alloc_complex(binCount);
+    response = fftw_alloc_complex(binCount);
+    forward = fftw_plan_dft_r2c_1d((int)length, block, spectrum, FFTW_ESTIMATE);
+    inverse = fftw_plan_dft_c2r_1d((int)length, spectrum, block, FFTW_ESTIMATE);
+
+    // The frequency response includes the scaling of the inverse transformation
+    std::fill_n(block, length, 0.0);
+    for (size_t tap = 0; tap < coefficients.size(); ++tap) block[tap] = coefficients[tap] / length;
+    fftw_execute_dft_r2c(forward, block, response);
+}
+
+void FirFilter::overlapSave(const double *input, size_t count, double *output, unsigned length) {
+    prepare(length);
+    const size_t overlap = coefficients.size() - 1;
+    const size_t step = length - overlap;
+    const unsigned binCount = length / 2 + 1;
+    // The input holds count + overlap samples
+    const size_t inputCount = count + overlap;
+
+    for (size_t offset = 0; offset < count; offset += step) {
+        const size_t available = std::min((size_t)length, inputCount - offset);
+        std::copy(input + offset, input + offset + available, block);
+        std::fill(block + available, block + length, 0.0);
+
+        fftw_execute(forward);
+        for (unsigned bin = 0; bin < binCount; ++bin) {
+            const double real = spectrum[bin][0] * response[bin][0] - spectrum[bin][1] * response[bin][1];
+            const double imag = spectrum[bin][0] * response[bin][1] + spectrum[bin][1] * response[bin][0];
+            spectrum[bin][0] = real;
+            spectrum[bin][1] = imag;
+        }
+        fftw_execute(inverse);
+
+        // The first outputs are wrapped around, the valid ones follow the overlap
+        const size_t outputCount = std::min(step, count - offset);
+        std::copy(block + overlap, block + overlap + outputCount, output + offset);
+    }
+}
+
+void FirFilter::process(std::vector<double> &samples, bool append) {
+    const size_t tapCount = coefficients.size();
+    const size_t count = samples.size();
+    if (tapCount == 0 || count == 0) return;
+
+    const size_t overlap = tapCount - 1;
+    const size_t delay = overlap / 2;
+    // A new stream starts as if the first sample had been there before
+    if (!append || history.size() != overlap) history.assign(overlap, samples.front());
+    // Single records read ahead to compensate the delay
+    const size_t padding = append ? 0 : delay;
+
+    extended.resize(overlap + count + padding);
+    std::copy(history.begin(), history.end(), extended.begin());
+    std::copy(samples.begin(), samples.end(), extended.begin() + (long)overlap);
+    std::fill(extended.begin() + (long)(overlap + count), extended.end(), samples.back());
+    std::copy(extended.begin() + (long)count, extended.begin() + (long)(count + overlap), history.begin());
+
+    const size_t outputs = count + padding;
+    filtered.resize(outputs);
+    const unsigned length = fftLength(tapCount, outputs);
+    if (length)
+        overlapSave(extended.data(), outputs, filtered.data(), length);
+    else
+        direct(extended.data(), outputs, filtered.data());
+
+    std::copy(filtered.begin() + (long)padding, filtered.end(), samples.begin());
+}
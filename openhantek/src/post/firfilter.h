@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <vector>
+
+#include <fftw3.h>
+
+#include "postprocessingsettings.h"
+
+/// \brief FIR filter that switches between direct convolution and FFT overlap-save.
+/// Short filters are convolved directly, the loop over a block of outputs is written so that the compiler can
+/// vectorize it. Long filters are convolved block by block in the frequency domain. A simple cost model compares
+/// the multiply-adds of both methods for the given record and picks the cheaper one.
+///
+/// The filter has linear phase, its delay of (taps - 1) / 2 samples is compensated for single records by reading
+/// ahead, the edges are extended with the first and last sample. Streamed records continue the previous one
+/// seamlessly, the output is delayed then since the following samples are not known yet.
+class FirFilter {
+  public:
+    ~FirFilter();
+
+    /// \brief Designs a windowed-sinc filter with a Blackman window.
+    /// \param type The filter type, low-, high- or band-pass.
+    /// \param length The number of taps, it is made odd.
+    /// \param low The cutoff, the lower edge of the band-pass, relative to the samplerate.
+    /// \param high The upper edge of the band-pass, relative to the samplerate.
+    /// \return The taps with unity gain in the passband.
+    static std::vector<double> design(Dso::FilterType type, unsigned length, double low, double high);
+
+    /// \brief Sets the taps and resets the state.
+    void setTaps(std::vector<double> taps);
+    const std::vector<double> &taps() const { return coefficients; }
+
+    /// \brief Filters the samples.
+    /// \param samples The samples, they are replaced by the filtered samples.
+    /// \param append true, if the samples continue the previous call.
+    void process(std::vector<double> &samples, bool append);
+
+    /// \brief Chooses the convolution method.
+    /// \param taps The number of taps.
+    /// \param outputs The number of samples to calculate.
+    /// \return The length of the FFT blocks, 0 if the direct convolution is cheaper.
+    static unsigned fftLength(size_t taps, size_t outputs);
+
+  private:
+    /// \brief Direct convolution, output[i] = sum(taps[k] * input[i + taps - 1 - k]).
+    void direct(const double *input, size_t count, double *output) const;
+    /// \brief Overlap-save convolution with blocks of the given length, same result as direct().
+    void overlapSave(const double *input, size_t count, double *output, unsigned length);
+    /// \brief Prepares the plans and the frequency response for the block length.
+    void prepare(unsigned length);
+    void release();
+
+    std::vector<double> coefficients; ///< The taps
+    std::vector<double> reversed;     ///< The taps in reverse order, for the direct convolution
+    std::vector<double> history;      ///< The last taps - 1 input samples of the previous call
+    std::vector<double> extended;     ///< The history, the input and the padding at the end
+    std::vector<double> filtered;     ///< The output, including the delay
+
+    unsigned blockLength = 0;          ///< The FFT length of the overlap-save method
+    double *block = nullptr;           ///< Input block, then the output block
+    fftw_complex *spectrum = nullptr;  ///< blockLength / 2 + 1 bins of the block
+    fftw_complex *response = nullptr;  ///< The frequency response, scaled by 1 / blockLength
+    fftw_plan forward = nullptr;       ///< block -> spectrum
+    fftw_plan inverse = nullptr;       ///< spectrum -> block
+};
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+
+#include "frequencyestimator.h"
+
+namespace {
+/// Width of the hysteresis band in parts of the peak-to-peak amplitude.
+const double HYSTERESIS = 0.1;
+} // namespace
+
+double FrequencyEstimator::zeroCrossing(const std::vector<double> &samples, double interval) {
+    if (samples.size() < 3 || interval <= 0) return 0.0;
+
+    const auto range = std::minmax_element(samples.begin(), samples.end());
+    const double minimum = *range.first;
+    const double maximum = *range.second;
+    if (!(maximum > minimum)) return 0.0;
+
+    const double level = (maximum + minimum) / 2.0;
+    const double upper = level + (maximum - minimum) * HYSTERESIS / 2.0;
+    const double lower = level - (maximum - minimum) * HYSTERESIS / 2.0;
+
+    // The signal is armed after it has been below the band, a crossing of the level is remembered and
+    // accepted when the signal reaches the top of the band.
+    bool armed = samples[0] < lower;
+    double candidate = -1.0;
+    double firstCrossing = 0.0;
+    double lastCrossing = 0.0;
+    unsigned crossings = 0;
+
+    for (size_t position = 1; position < samples.size(); ++position) {
+        const double previous = samples[position - 1];
+        const double value = samples[position];
+        if (!armed) {
+            if (value < lower) armed = true;
+            continue;
+        }
+
+        if (previous < level && value >= level)
+            candidate = (position - 1) + (level - previous) / (value - previous);
+
+        if (value < lower) {
+            candidate = -1.0;
+        } else if (value >= upper && candidate >= 0.0) {
+            if (crossings == 0) firstCrossing = candidate;
+            lastCrossing = candidate;
+            ++crossings;
+            candidate = -1.0;
+            armed = false;
+        }
+    }
+
+    if (crossings < 2) return 0.0;
+    return (crossings - 1) / ((lastCrossing - firstCrossing) * interval);
+}
@@ -0,0 +1,20 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <vector>
+
+/// \brief Time-domain frequency measurement.
+/// Counts the rising crossings of the mid level between minimum and maximum. A crossing is only accepted after
+/// the signal has left a hysteresis band around the mid level on both sides, so noise riding on a slow edge
+/// doesn't produce additional crossings. The crossing positions are interpolated between the two samples
+/// and the frequency is derived from the average period between the first and the last crossing. This takes
+/// two passes over the samples and no FFT.
+class FrequencyEstimator {
+  public:
+    /// \brief Measures the frequency of the signal.
+    /// \param samples The sample values.
+    /// \param interval The time between two samples in seconds.
+    /// \return The frequency in Hz, 0 if less than one full period was found.
+    static double zeroCrossing(const std::vector<double> &samples, double interval);
+};
@@ -2,11 +2,11 @@
 
 #include <QDebug>
 #include <QMutex>
+#include <algorithm>
 #include <exception>
 
 #include "post/graphgenerator.h"
 #include "post/ppresult.h"
-#include "post/softwaretrigger.h"
 #include "hantekdso/controlspecification.h"
 #include "scopesettings.h"
 #include "utils/printutils.h"
@@ -26,20 +26,15 @@ static const SampleValues &useVoltSamplesOf(ChannelID channel, const PPresult *r
     return result->data(channel)->voltage;
 }
 
-GraphGenerator::GraphGenerator(const DsoSettingsScope *scope, bool isSoftwareTriggerDevice)
-    : scope(scope), isSoftwareTriggerDevice(isSoftwareTriggerDevice) {}
+GraphGenerator::GraphGenerator(const DsoSettingsScope *scope) : scope(scope) {}
 
 bool GraphGenerator::isReady() const { return ready; }
 
 void GraphGenerator::generateGraphsTYvoltage(PPresult *result) {
-    unsigned preTrigSamples = 0;
-    unsigned postTrigSamples = 0;
-    unsigned swTriggerStart = 0;
-
-    // check trigger point for software trigger
-    if (isSoftwareTriggerDevice && scope->trigger.source < result->channelCount())
-        std::tie(preTrigSamples, postTrigSamples, swTriggerStart) = SoftwareTrigger::compute(result, scope);
-    result->softwareTriggerTriggered = postTrigSamples > preTrigSamples;
+    // The software trigger point has been determined on the raw data already
+    const unsigned triggerOffset = result->softwareTriggerOffset;
+    // The exact crossing lies in front of the trigger sample, shift the graph to keep it steady
+    const float triggerFraction = (float)result->softwareTriggerFraction;
 
     result->vaChannelVoltage.resize(scope->voltage.size());
     for (ChannelID channel = 0; channel < scope->voltage.size(); ++channel) {
@@ -58,7 +53,11 @@ void GraphGenerator::generateGraphsTYvoltage(PPresult *result) {
             qWarning() << "Sample count too high!";
             throw new std::runtime_error("Sample count too high!");
         }
-        sampleCount -= (swTriggerStart - preTrigSamples);
+        if (triggerOffset >= sampleCount) {
+            target.clear();
+            continue;
+        }
+        sampleCount -= triggerOffset;
         size_t neededSize = sampleCount * 2;
 
         // Set size directly to avoid reallocations
@@ -73,10 +72,10 @@ void GraphGenerator::generateGraphsTYvoltage(PPresult *result) {
         const float offset = (float)scope->voltage[channel].offset;
         const float invert = scope->voltage[channel].inverted ? -1.0f : 1.0f;
 
-        std::advance(dataIterator, swTriggerStart - preTrigSamples);
+        std::advance(dataIterator, triggerOffset);
 
         for (unsigned int position = 0; position < sampleCount; ++position) {
-            target.push_back(QVector3D(position * horizontalFactor - DIVS_TIME / 2,
+            target.push_back(QVector3D((position + triggerFraction) * horizontalFactor - DIVS_TIME / 2,
                                        (float)*(dataIterator++) / gain * invert + offset, 0.0));
         }
     }
@@ -108,6 +107,8 @@ void GraphGenerator::generateGraphsTYspectrum(PPresult *result) {
 
         // What's the horizontal distance between sampling points?
         float horizontalFactor = (float)(samples.interval / scope->horizontal.frequencybase);
+        // A zoomed spectrum doesn't start at 0 Hz
+        const float horizontalStart = (float)(samples.start / scope->horizontal.frequencybase) - DIVS_TIME / 2;
 
         // Fill vector array
         std::vector<double>::const_iterator dataIterator = samples.sample.begin();
@@ -115,17 +116,47 @@ void GraphGenerator::generateGraphsTYspectrum(PPresult *result) {
         const float offset = (float)scope->spectrum[channel].offset;
 
         for (unsigned int position = 0; position < sampleCount; ++position) {
-            target.push_back(QVector3D(position * horizontalFactor - DIVS_TIME / 2,
+            target.push_back(QVector3D(horizontalStart + position * horizontalFactor,
                                        (float)*(dataIterator++) / magnitude + offset, 0.0));
         }
     }
 }
 
+void GraphGenerator::generateGraphsTYhistogram(PPresult *result) {
+    result->vaChannelHistogram.resize(scope->voltage.size());
+    for (ChannelID channel = 0; channel < scope->voltage.size(); ++channel) {
+        ChannelGraph &target = result->vaChannelHistogram[channel];
+        target.clear();
+        if (!scope->voltage[channel].used || !result->data(channel)) continue;
+        const AmplitudeHistogram &histogram = result->data(channel)->histogram;
+        if (histogram.count.empty() || !histogram.total) continue;
+
+        // The fullest bin reaches a quarter of the screen width
+        const unsigned long long maximum = *std::max_element(histogram.count.begin(), histogram.count.end());
+        const float horizontalFactor = (float)DIVS_TIME / 4 / (float)maximum;
+        const float gain = (float)scope->gain(channel);
+        const float offset = (float)scope->voltage[channel].offset;
+        const float invert = scope->voltage[channel].inverted ? -1.0f : 1.0f;
+
+        // Bins far beyond the screen edges are skipped, the rest is clipped when drawn
+        const size_t binCount = histogram.count.size();
+        target.reserve(binCount);
+        for (size_t bin = 0; bin < binCount; ++bin) {
+            const float voltage = (float)(histogram.base + (bin + 0.5) * histogram.step);
+            const float position = voltage / gain * invert + offset;
+            if (position < -DIVS_VOLTAGE || position > DIVS_VOLTAGE) continue;
+            target.push_back(
+                QVector3D((float)histogram.count[bin] * horizontalFactor - DIVS_TIME / 2, position, 0.0));
+        }
+    }
+}
+
 void GraphGenerator::process(PPresult *data) {
     if (scope->horizontal.format == Dso::GraphFormat::TY) {
         ready = true;
         generateGraphsTYspectrum(data);
         generateGraphsTYvoltage(data);
+        generateGraphsTYhistogram(data);
     } else
         generateGraphsXY(data, scope);
 }
@@ -135,6 +166,7 @@ void GraphGenerator::generateGraphsXY(PPresult *result, const DsoSettingsScope *
 
     // Delete all spectrum graphs
     for (ChannelGraph &data : result->vaChannelSpectrum) data.clear();
+    for (ChannelGraph &data : result->vaChannelHistogram) data.clear();
 
     // Generate voltage graphs for pairs of channels
     for (ChannelID channel = 0; channel < scope->voltage.size(); channel += 2) {
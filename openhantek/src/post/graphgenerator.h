@@ -22,7 +22,7 @@ class GraphGenerator : public QObject, public Processor {
     Q_OBJECT
 
   public:
-    GraphGenerator(const DsoSettingsScope *scope, bool isSoftwareTriggerDevice);
+    GraphGenerator(const DsoSettingsScope *scope);
     void generateGraphsXY(PPresult *result, const DsoSettingsScope *scope);
 
     bool isReady() const;
@@ -30,11 +30,11 @@ class GraphGenerator : public QObject, public Processor {
   private:
     void generateGraphsTYvoltage(PPresult *result);
     void generateGraphsTYspectrum(PPresult *result);
+    void generateGraphsTYhistogram(PPresult *result);
 
   private:
     bool ready = false;
     const DsoSettingsScope *scope;
-    const bool isSoftwareTriggerDevice;
 
     // Processor interface
     private:
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "harmonicanalyzer.h"
+#include "windowcache.h"
+
+namespace {
+/// The main lobe of a tone is followed down to its first minimum, but not further than this number of bins.
+const size_t MAX_LOBE_WIDTH = 16;
+
+inline double decibel(double ratio) { return 10.0 * log10(ratio); }
+} // namespace
+
+HarmonicAnalyzer::HarmonicAnalyzer(const DsoSettingsPostProcessing *postprocessing) : postprocessing(postprocessing) {}
+
+void HarmonicAnalyzer::process(PPresult *result) {
+    for (ChannelID channel = 0; channel < result->channelCount(); ++channel) {
+        DataChannel *const channelData = result->modifyData(channel);
+        HarmonicAnalysis &analysis = channelData->harmonics;
+        analysis = HarmonicAnalysis();
+
+        // A zoomed spectrum doesn't contain the harmonics and the noise of the whole band
+        const SampleValues &spectrum = channelData->spectrum;
+        if (postprocessing->harmonics == 0 || spectrum.sample.size() < 8 || spectrum.interval <= 0 ||
+            spectrum.start != 0.0)
+            continue;
+
+        analyze(spectrum.sample, spectrum.interval, channelData->frequency, channelData->spectrumSamples, analysis);
+    }
+}
+
+double HarmonicAnalyzer::windowPower(unsigned length) {
+    if (window != postprocessing->spectrumWindow || windowLength != length) {
+        window = postprocessing->spectrumWindow;
+        windowLength = length;
+        const std::shared_ptr<const WindowCache::Table> table = WindowCache::get()->table(window, length);
+        double sum = 0.0;
+        for (double value : *table) sum += value * value;
+        windowMeanSquare = sum / length;
+    }
+    return windowMeanSquare;
+}
+
+bool HarmonicAnalyzer::findPeak(const std::vector<double> &power, size_t first, size_t last, Peak &peak) {
+    first = std::max<size_t>(first, 1);
+    last = std::min(last, power.size() - 2);
+    size_t maximum = 0;
+    for (size_t bin = first; bin <= last; ++bin) {
+        if (!used[bin] && (maximum == 0 || power[bin] > power[maximum])) maximum = bin;
+    }
+    if (maximum == 0 || power[maximum] <= 0.0) return false;
+
+    // Follow the main lobe down on both sides
+    peak.first = maximum;
+    while (peak.first > 0 && maximum - peak.first < MAX_LOBE_WIDTH && !used[peak.first - 1] &&
+           power[peak.first - 1] < power[peak.first])
+        --peak.first;
+    peak.last = maximum;
+    while (peak.last + 1 < power.size() && peak.last - maximum < MAX_LOBE_WIDTH && !used[peak.last + 1] &&
+           power[peak.last + 1] < power[peak.last])
+        ++peak.last;
+
+    // The logarithm of a windowed peak is close to a parabola
+    const double left = power[maximum - 1];
+    const double right = power[maximum + 1];
+    peak.bin = maximum;
+    if (left > 0.0 && right > 0.0) {
+        const double a = log(left);
+        const double b = log(power[maximum]);
+        const double c = log(right);
+        const double denominator = a - 2.0 * b + c;
+        if (denominator < 0.0) peak.bin += std::max(-0.5, std::min(0.5, 0.5 * (a - c) / denominator));
+    }
+
+    peak.power = 0.0;
+    for (size_t bin = peak.first; bin <= peak.last; ++bin) {
+        peak.power += power[bin];
+        used[bin] = 1;
+    }
+    return true;
+}
+
+void HarmonicAnalyzer::analyze(const std::vector<double> &power, double interval, double frequency,
+                               unsigned sampleCount, HarmonicAnalysis &analysis) {
+    const size_t binCount = power.size();
+    used.assign(binCount, 0);
+
+    // DC and its lobe are neither signal nor noise
+    size_t dcEnd = 0;
+    while (dcEnd + 1 < binCount && dcEnd < MAX_LOBE_WIDTH && power[dcEnd + 1] < power[dcEnd]) ++dcEnd;
+    std::fill(used.begin(), used.begin() + (long)dcEnd + 1, 1);
+
+    // Search the fundamental around the measured frequency, the whole spectrum if there is none
+    Peak fundamental;
+    const double expectedBin = frequency / interval;
+    bool found = false;
+    if (expectedBin > dcEnd && expectedBin < binCount - 2) {
+        const size_t range = 2 + (size_t)(expectedBin / 50);
+        const size_t center = (size_t)std::lround(expectedBin);
+        found = findPeak(power, center > range ? center - range : 1, center + range, fundamental);
+    }
+    if (!found && !findPeak(power, dcEnd + 1, binCount, fundamental)) return;
+
+    // The harmonics are searched at the multiples of the interpolated fundamental
+    Peak harmonic;
+    double harmonicPower = 0.0;
+    for (unsigned order = 2; order <= postprocessing->harmonics; ++order) {
+        const double harmonicBin = fundamental.bin * order;
+        if (harmonicBin + 1 >= binCount - 1) break;
+        const size_t center = (size_t)std::lround(harmonicBin);
+        if (findPeak(power, center - 2, center + 2, harmonic)) {
+            harmonicPower += harmonic.power;
+            analysis.harmonics.push_back(decibel(harmonic.power / fundamental.power));
+        } else {
+            // All bins around the harmonic belong to other tones already
+            analysis.harmonics.push_back(-std::numeric_limits<double>::infinity());
+        }
+    }
+
+    // The noise in the bins of the tones is estimated from the average noise of the other bins
+    double totalPower = 0.0;
+    size_t noiseBins = 0;
+    for (size_t bin = dcEnd + 1; bin < binCount; ++bin) {
+        totalPower += power[bin];
+        if (!used[bin]) ++noiseBins;
+    }
+    double noisePower = std::max(0.0, totalPower - fundamental.power - harmonicPower);
+    if (noiseBins > 0) noisePower *= (double)(binCount - dcEnd - 1) / noiseBins;
+    noisePower = std::max(noisePower, std::numeric_limits<double>::min());
+    harmonicPower = std::max(harmonicPower, std::numeric_limits<double>::min());
+
+    analysis.valid = true;
+    analysis.fundamental = fundamental.bin * interval;
+    // Zero-padding interpolates the spectrum, a lobe covers more bins than the samples would give
+    const unsigned transformLength = 2 * (unsigned)(binCount - 1);
+    if (sampleCount == 0 || sampleCount > transformLength) sampleCount = transformLength;
+    const double lobePower = fundamental.power * sampleCount / transformLength;
+    analysis.amplitude = sqrt(lobePower / windowPower(sampleCount) / 2.0);
+    analysis.thd = decibel(harmonicPower / fundamental.power);
+    analysis.thdN = decibel((harmonicPower + noisePower) / fundamental.power);
+    analysis.snr = decibel(fundamental.power / noisePower);
+    analysis.sinad = -analysis.thdN;
+    analysis.enob = (analysis.sinad - 1.76) / 6.02;
+}
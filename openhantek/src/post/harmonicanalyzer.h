@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "postprocessingsettings.h"
+#include "processor.h"
+
+/// \brief Measures the harmonic distortion and the noise of each channel.
+/// Runs between the SpectrumGenerator and the SpectrumAverager on the power spectrum of the frame, so no
+/// additional transformation is needed. The fundamental is searched around the measured signal frequency and
+/// located with sub-bin precision by a Gaussian interpolation of the peak. The power of a tone is the sum of
+/// the bins of its main lobe, the remaining bins are noise.
+class HarmonicAnalyzer : public Processor {
+  public:
+    HarmonicAnalyzer(const DsoSettingsPostProcessing *postprocessing);
+    virtual void process(PPresult *result) override;
+
+  private:
+    /// \brief Bins of a tone in the spectrum.
+    struct Peak {
+        size_t first = 0;    ///< First bin of the main lobe
+        size_t last = 0;     ///< Last bin of the main lobe
+        double bin = 0.0;    ///< Interpolated position of the maximum
+        double power = 0.0;  ///< Power of the main lobe
+    };
+
+    /// \brief Analyzes one channel.
+    void analyze(const std::vector<double> &power, double interval, double frequency, unsigned sampleCount,
+                 HarmonicAnalysis &analysis);
+    /// \brief Finds the main lobe of the highest peak between first and last and marks its bins as used.
+    bool findPeak(const std::vector<double> &power, size_t first, size_t last, Peak &peak);
+    /// \brief Returns the mean square of the window function, it scales the lobe power into the tone power.
+    double windowPower(unsigned length);
+
+    const DsoSettingsPostProcessing *postprocessing;
+    std::vector<unsigned char> used; ///< Bins that belong to a tone or to DC
+
+    Dso::WindowFunction window = Dso::WindowFunction::RECTANGULAR;
+    unsigned windowLength = 0;
+    double windowMeanSquare = 1.0;
+};
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+
+#include "histogramgenerator.h"
+
+namespace {
+/// Number of private sub-histograms, consecutive samples are counted into different ones.
+const unsigned SUB_HISTOGRAMS = 4;
+} // namespace
+
+HistogramGenerator::HistogramGenerator(const DsoSettingsPostProcessing *postprocessing)
+    : postprocessing(postprocessing) {}
+
+void HistogramGenerator::count(const SampleCodes &codes, unsigned bins) {
+    subHistograms.assign(SUB_HISTOGRAMS * bins, 0);
+    uint32_t *const sub0 = subHistograms.data();
+    uint32_t *const sub1 = sub0 + bins;
+    uint32_t *const sub2 = sub1 + bins;
+    uint32_t *const sub3 = sub2 + bins;
+    // A code out of range would write beyond the bins, the mask keeps it inside
+    const unsigned mask = bins - 1;
+    const int shift = codes.shift;
+    const short *code = codes.code.data();
+    const size_t size = codes.code.size();
+
+    size_t position = 0;
+    for (; position + SUB_HISTOGRAMS <= size; position += SUB_HISTOGRAMS) {
+        ++sub0[(unsigned)(code[position] + shift) & mask];
+        ++sub1[(unsigned)(code[position + 1] + shift) & mask];
+        ++sub2[(unsigned)(code[position + 2] + shift) & mask];
+        ++sub3[(unsigned)(code[position + 3] + shift) & mask];
+    }
+    for (; position < size; ++position) ++sub0[(unsigned)(code[position] + shift) & mask];
+}
+
+void HistogramGenerator::process(PPresult *result) {
+    const Dso::HistogramMode mode = postprocessing->histogram;
+    if (resetRequested.exchange(false) || mode == Dso::HistogramMode::OFF) accumulators.clear();
+    if (mode == Dso::HistogramMode::OFF) return;
+    if (accumulators.size() < result->channelCount()) accumulators.resize(result->channelCount());
+
+    for (ChannelID channel = 0; channel < result->channelCount(); ++channel) {
+        DataChannel *const channelData = result->modifyData(channel);
+        const SampleCodes &codes = channelData->codes;
+        AmplitudeHistogram &histogram = accumulators[channel];
+        if (codes.code.empty() || codes.bits > 16) continue;
+
+        // The bins of another gain or offset have a different voltage and can't be added
+        const unsigned bins = 1u << codes.bits;
+        if (mode == Dso::HistogramMode::FRAME || histogram.count.size() != bins || histogram.step != codes.step ||
+            histogram.base != codes.base) {
+            histogram = AmplitudeHistogram();
+            histogram.count.assign(bins, 0);
+            histogram.step = codes.step;
+            histogram.base = codes.base;
+        }
+
+        count(codes, bins);
+        for (unsigned sub = 0; sub < SUB_HISTOGRAMS; ++sub) {
+            const uint32_t *const counts = subHistograms.data() + sub * bins;
+            for (unsigned bin = 0; bin < bins; ++bin) histogram.count[bin] += counts[bin];
+        }
+        histogram.total += codes.code.size();
+        ++histogram.frames;
+
+        channelData->histogram = histogram;
+    }
+}
@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "postprocessingsettings.h"
+#include "processor.h"
+
+/// \brief Counts the raw ADC codes of the physical channels into an amplitude histogram.
+/// Every code has its own bin, 256 for the 8 bit devices and 1024 for the DSO-5200. The codes are counted into
+/// several private sub-histograms in turn, so neighbouring samples with the same code don't wait for each other's
+/// increment, and the sub-histograms are summed afterwards. In the accumulating mode the histogram continues across
+/// frames until it is reset or the gain or offset changes the voltage of the codes. The codes are taken before the
+/// filters, so the histogram shows the signal as it was sampled.
+class HistogramGenerator : public Processor {
+  public:
+    HistogramGenerator(const DsoSettingsPostProcessing *postprocessing);
+    virtual void process(PPresult *result) override;
+    virtual bool needsCodes() const override { return postprocessing->histogram != Dso::HistogramMode::OFF; }
+
+    /// \brief Restarts the accumulated histograms with the next frame, can be called from any thread.
+    void reset() { resetRequested = true; }
+
+  private:
+    /// \brief Counts the codes of one frame into frameCount.
+    void count(const SampleCodes &codes, unsigned bins);
+
+    const DsoSettingsPostProcessing *postprocessing;
+    std::vector<AmplitudeHistogram> accumulators; ///< The histogram of each channel
+    std::vector<uint32_t> subHistograms;          ///< SUB_HISTOGRAMS * bins counters of the current frame
+    std::atomic<bool> resetRequested{false};
+};
@@ -0,0 +1,350 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+
+#include "masktester.h"
+#include "scopesettings.h"
+#include "viewconstants.h"
+
+namespace {
+/// Resolution of the golden waveform, its columns are independent of the samplerate.
+const unsigned GOLDEN_COLUMNS_PER_DIV = 100;
+/// More failed frames are dropped while the writer is busy.
+const size_t MAX_PENDING_FRAMES = 16;
+/// Sample positions of the longest record that is tested.
+const size_t MAX_POSITIONS = 1u << 20;
+/// Segments of each golden envelope on the screen.
+const size_t OUTLINE_SEGMENTS = 1000;
+
+const double INF = std::numeric_limits<double>::infinity();
+} // namespace
+
+MaskTester::MaskTester(const DsoSettingsScope *scope, const DsoSettingsPostProcessing *postprocessing)
+    : scope(scope), flushTask([this]() { flush(); }) {
+    writer.setMaxThreadCount(1);
+    const DsoSettingsMask &mask = postprocessing->mask;
+    setMask(mask);
+    if (mask.goldenTimebase > 0.0 && mask.goldenMinimum.size() == mask.goldenMaximum.size()) {
+        goldenWaveform.minimum = mask.goldenMinimum;
+        goldenWaveform.maximum = mask.goldenMaximum;
+        goldenWaveform.timebase = mask.goldenTimebase;
+    }
+}
+
+MaskTester::~MaskTester() {
+    writer.waitForDone();
+    // Frames that were added while the last flush was running
+    flush();
+}
+
+void MaskTester::golden(DsoSettingsMask &mask) const {
+    QMutexLocker locker(&goldenMutex);
+    mask.goldenMinimum = goldenWaveform.minimum;
+    mask.goldenMaximum = goldenWaveform.maximum;
+    mask.goldenTimebase = goldenWaveform.timebase;
+}
+
+void MaskTester::setMask(const DsoSettingsMask &mask) {
+    QMutexLocker locker(&settingsMutex);
+    pendingSettings = mask;
+    pendingSettings.goldenMinimum.clear();
+    pendingSettings.goldenMaximum.clear();
+    settingsChanged = true;
+}
+
+std::vector<std::vector<QPointF>> MaskTester::parsePolygons(const QString &text) {
+    std::vector<std::vector<QPointF>> polygons;
+    for (const QString &polygonText : text.split(';', QString::SkipEmptyParts)) {
+        std::vector<QPointF> polygon;
+        for (const QString &pointText : polygonText.simplified().split(' ', QString::SkipEmptyParts)) {
+            const QStringList coordinates = pointText.split(',');
+            if (coordinates.size() != 2) continue;
+            bool okX = false, okY = false;
+            const double x = coordinates[0].toDouble(&okX);
+            const double y = coordinates[1].toDouble(&okY);
+            if (okX && okY) polygon.push_back(QPointF(x, y));
+        }
+        if (polygon.size() >= 3) polygons.push_back(polygon);
+    }
+    return polygons;
+}
+
+void MaskTester::capture(const std::vector<double> &samples, unsigned offset, double fraction, double interval) {
+    const size_t columns = (size_t)(DIVS_TIME * GOLDEN_COLUMNS_PER_DIV);
+    const double columnWidth = scope->horizontal.timebase / GOLDEN_COLUMNS_PER_DIV;
+    std::vector<double> minimum(columns, INF);
+    std::vector<double> maximum(columns, -INF);
+
+    // The line between two samples passes all columns in between, both levels count for each of them
+    size_t used = 0;
+    for (size_t position = offset; position + 1 < samples.size(); ++position) {
+        const double time = (position - offset + fraction) * interval;
+        const size_t first = (size_t)(time / columnWidth);
+        if (first >= columns) break;
+        const size_t last = std::min((size_t)((time + interval) / columnWidth), columns - 1);
+        const double low = std::min(samples[position], samples[position + 1]);
+        const double high = std::max(samples[position], samples[position + 1]);
+        for (size_t column = first; column <= last; ++column) {
+            minimum[column] = std::min(minimum[column], low);
+            maximum[column] = std::max(maximum[column], high);
+        }
+        used = last + 1;
+    }
+    // A short record leaves the columns at the end empty, they are not tested
+    minimum.resize(used);
+    maximum.resize(used);
+
+    {
+        QMutexLocker locker(&goldenMutex);
+        goldenWaveform.minimum.swap(minimum);
+        goldenWaveform.maximum.swap(maximum);
+        goldenWaveform.timebase = scope->horizontal.timebase;
+        ++goldenWaveform.version;
+    }
+    emit goldenCaptured();
+}
+
+void MaskTester::compile(const DsoSettingsMask &mask, double interval) {
+    const double gain = scope->gain(mask.channel);
+    const DsoSettingsScopeVoltage &voltage = scope->voltage[mask.channel];
+    unsigned version;
+    {
+        QMutexLocker locker(&goldenMutex);
+        version = goldenWaveform.version;
+    }
+    // The tolerances only apply to the golden waveform, the polygons replace it
+    const bool maskChanged =
+        mask.mode != compiledMode || mask.channel != compiledChannel ||
+        (mask.mode == Dso::MaskMode::POLYGONS ? mask.polygons != compiledPolygons
+                                              : mask.timeTolerance != compiledTimeTolerance ||
+                                                    mask.voltageTolerance != compiledVoltageTolerance);
+    if (compiled && !maskChanged && interval == compiledInterval && scope->horizontal.timebase == compiledTimebase &&
+        gain == compiledGain && voltage.offset == compiledOffset && voltage.inverted == compiledInverted &&
+        version == compiledVersion)
+        return;
+
+    compiled = true;
+    compiledMode = mask.mode;
+    compiledChannel = mask.channel;
+    compiledTimeTolerance = mask.timeTolerance;
+    compiledVoltageTolerance = mask.voltageTolerance;
+    compiledPolygons = mask.polygons;
+    compiledInterval = interval;
+    compiledTimebase = scope->horizontal.timebase;
+    compiledGain = gain;
+    compiledOffset = voltage.offset;
+    compiledInverted = voltage.inverted;
+    compiledVersion = version;
+
+    allowed = Band();
+    forbidden.clear();
+    outline.clear();
+    // Every sample position on the screen
+    const size_t count = (size_t)std::min((double)MAX_POSITIONS, DIVS_TIME * compiledTimebase / interval + 1.0);
+    if (mask.mode == Dso::MaskMode::GOLDEN)
+        compileGolden(mask, count, interval);
+    else if (mask.mode == Dso::MaskMode::POLYGONS)
+        compilePolygons(mask, count, interval);
+}
+
+void MaskTester::compileGolden(const DsoSettingsMask &mask, size_t count, double interval) {
+    QMutexLocker locker(&goldenMutex);
+    const size_t columns = goldenWaveform.minimum.size();
+    if (!columns || goldenWaveform.timebase <= 0.0) return;
+    const double columnWidth = goldenWaveform.timebase / GOLDEN_COLUMNS_PER_DIV;
+    const double timeTolerance = mask.timeTolerance * compiledTimebase;
+    const double voltageTolerance = mask.voltageTolerance * compiledGain;
+
+    allowed.lower.assign(count, -INF);
+    allowed.upper.assign(count, INF);
+    for (size_t position = 0; position < count; ++position) {
+        // The samples may be anywhere within the tolerance around the golden waveform
+        const double time = position * interval;
+        const double first = std::floor((time - timeTolerance) / columnWidth);
+        const double last = std::floor((time + timeTolerance) / columnWidth);
+        if (last < 0.0 || first >= (double)columns) continue;
+        const size_t end = std::min((size_t)last + 1, columns);
+        double lower = INF, upper = -INF;
+        for (size_t column = (size_t)std::max(first, 0.0); column < end; ++column) {
+            lower = std::min(lower, goldenWaveform.minimum[column]);
+            upper = std::max(upper, goldenWaveform.maximum[column]);
+        }
+        allowed.lower[position] = lower - voltageTolerance;
+        allowed.upper[position] = upper + voltageTolerance;
+    }
+    outlineBand(allowed, interval);
+}
+
+void MaskTester::compilePolygons(const DsoSettingsMask &mask, size_t count, double interval) {
+    const double invert = compiledInverted ? -1.0 : 1.0;
+    const double horizontalFactor = interval / compiledTimebase;
+
+    for (const std::vector<QPointF> &polygon : parsePolygons(mask.polygons)) {
+        Band band;
+        band.lower.assign(count, INF);
+        band.upper.assign(count, -INF);
+        for (size_t position = 0; position < count; ++position) {
+            // The vertical extent of the polygon at this position, exact for convex polygons
+            const double x = position * horizontalFactor - DIVS_TIME / 2;
+            double bottom = INF, top = -INF;
+            for (size_t point = 0; point < polygon.size(); ++point) {
+                const QPointF &a = polygon[point];
+                const QPointF &b = polygon[(point + 1) % polygon.size()];
+                if (a.x() == b.x() || x < std::min(a.x(), b.x()) || x > std::max(a.x(), b.x())) continue;
+                const double y = a.y() + (x - a.x()) * (b.y() - a.y()) / (b.x() - a.x());
+                bottom = std::min(bottom, y);
+                top = std::max(top, y);
+            }
+            if (bottom > top) continue;
+            const double first = (bottom - compiledOffset) * compiledGain * invert;
+            const double second = (top - compiledOffset) * compiledGain * invert;
+            band.lower[position] = std::min(first, second);
+            band.upper[position] = std::max(first, second);
+        }
+        forbidden.push_back(std::move(band));
+
+        for (size_t point = 0; point < polygon.size(); ++point) {
+            const QPointF &a = polygon[point];
+            const QPointF &b = polygon[(point + 1) % polygon.size()];
+            outline.push_back(QVector3D((float)a.x(), (float)a.y(), 0.0f));
+            outline.push_back(QVector3D((float)b.x(), (float)b.y(), 0.0f));
+        }
+    }
+}
+
+void MaskTester::outlineBand(const Band &band, double interval) {
+    const size_t count = band.lower.size();
+    if (count < 2) return;
+    const float horizontalFactor = (float)(interval / compiledTimebase);
+    const float invert = compiledInverted ? -1.0f : 1.0f;
+    const float gain = (float)compiledGain;
+    const float offset = (float)compiledOffset;
+    const size_t step = std::max((size_t)1, count / OUTLINE_SEGMENTS);
+
+    for (const std::vector<double> *levels : {&band.lower, &band.upper}) {
+        for (size_t position = 0; position + step < count; position += step) {
+            const double from = (*levels)[position];
+            const double to = (*levels)[position + step];
+            if (std::isinf(from) || std::isinf(to)) continue;
+            outline.push_back(QVector3D(position * horizontalFactor - DIVS_TIME / 2,
+                                        (float)from / gain * invert + offset, 0.0f));
+            outline.push_back(QVector3D((position + step) * horizontalFactor - DIVS_TIME / 2,
+                                        (float)to / gain * invert + offset, 0.0f));
+        }
+    }
+}
+
+unsigned long long MaskTester::countHits(const double *samples, size_t count) {
+    violated.assign(count, 0);
+    unsigned char *const flags = violated.data();
+
+    // One pass per band without branches, the compiler vectorizes the compares
+    if (!allowed.lower.empty()) {
+        const double *const lower = allowed.lower.data();
+        const double *const upper = allowed.upper.data();
+        for (size_t position = 0; position < count; ++position)
+            flags[position] |= (unsigned char)((samples[position] < lower[position]) |
+                                               (samples[position] > upper[position]));
+    }
+    for (const Band &band : forbidden) {
+        const double *const lower = band.lower.data();
+        const double *const upper = band.upper.data();
+        for (size_t position = 0; position < count; ++position)
+            flags[position] |= (unsigned char)((samples[position] > lower[position]) &
+                                               (samples[position] < upper[position]));
+    }
+
+    unsigned long long hits = 0;
+    for (size_t position = 0; position < count; ++position) hits += flags[position];
+    return hits;
+}
+
+void MaskTester::process(PPresult *result) {
+    {
+        QMutexLocker locker(&settingsMutex);
+        if (settingsChanged) std::swap(settings, pendingSettings);
+        settingsChanged = false;
+    }
+    const DsoSettingsMask &mask = settings;
+    if (resetRequested.exchange(false)) counters = MaskTestResult();
+
+    // A streamed record or one without trigger has no fixed position on the screen
+    if (result->append || !result->softwareTriggerTriggered || mask.channel >= result->channelCount() ||
+        mask.channel >= scope->voltage.size())
+        return;
+    const SampleValues &samples = result->data(mask.channel)->voltage;
+    const unsigned offset = result->softwareTriggerOffset;
+    if (samples.sample.size() <= offset || samples.interval <= 0.0) return;
+
+    // The request waits for a frame that can be captured
+    if (captureRequested.exchange(false))
+        capture(samples.sample, offset, result->softwareTriggerFraction, samples.interval);
+    if (mask.mode == Dso::MaskMode::OFF || !scope->voltage[mask.channel].used) {
+        compiled = false;
+        return;
+    }
+
+    // The limits are compiled for the first sample on the screen, the trigger fraction is below one sample
+    compile(mask, samples.interval);
+    const size_t limits = allowed.lower.empty() ? (forbidden.empty() ? 0 : forbidden.front().lower.size())
+                                                : allowed.lower.size();
+    const size_t count = std::min(limits, samples.sample.size() - offset);
+    const unsigned long long hits = countHits(samples.sample.data() + offset, count);
+
+    counters.tested = true;
+    counters.hits = hits;
+    ++counters.frames;
+    counters.totalHits += hits;
+    if (hits) ++counters.failedFrames;
+    result->maskTest = counters;
+    result->vaMask = outline;
+    if (!hits) return;
+
+    if (mask.action == Dso::MaskAction::STOP)
+        emit failed();
+    else if (mask.action == Dso::MaskAction::SAVE && !mask.folder.isEmpty()) {
+        FailedFrame frame;
+        frame.fileName = QDir(mask.folder).filePath(
+            QString("mask-%1-%2.csv")
+                .arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss-zzz"))
+                .arg(counters.frames));
+        frame.samples = samples.sample;
+        frame.interval = samples.interval;
+        frame.start = -(offset + result->softwareTriggerFraction) * samples.interval;
+        {
+            QMutexLocker locker(&pendingMutex);
+            if (pending.size() >= MAX_PENDING_FRAMES) return;
+            pending.push_back(std::move(frame));
+        }
+        if (!flushQueued.exchange(true)) writer.start(&flushTask);
+    }
+}
+
+void MaskTester::flush() {
+    flushQueued = false;
+    for (;;) {
+        FailedFrame frame;
+        {
+            QMutexLocker locker(&pendingMutex);
+            if (pending.empty()) return;
+            frame = std::move(pending.front());
+            pending.pop_front();
+        }
+
+        QFile file(frame.fileName);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) continue;
+        QString text("time,voltage\n");
+        for (size_t position = 0; position < frame.samples.size(); ++position) {
+            text += QString("%1,%2\n")
+                        .arg(frame.start + position * frame.interval, 0, 'g', 10)
+                        .arg(frame.samples[position], 0, 'g', 10);
+        }
+        file.write(text.toUtf8());
+    }
+}
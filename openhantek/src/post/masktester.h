@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <vector>
+
+#include <QMutex>
+#include <QObject>
+#include <QPointF>
+#include <QString>
+#include <QThreadPool>
+
+#include "pooltask.h"
+#include "postprocessingsettings.h"
+#include "processor.h"
+
+struct DsoSettingsScope;
+
+/// \brief Tests every frame of a voltage channel against a mask and counts the failures.
+/// The mask is either the golden waveform plus or minus a tolerance or a set of forbidden polygons on the screen.
+/// Both are compiled into the allowed and forbidden levels of every sample position on the screen whenever the
+/// mask, the timebase, the samplerate or the gain changes. A frame is then tested with one compare pass per band
+/// that doesn't branch and is vectorized. Failing frames are saved by a separate thread, the failure that stops the
+/// acquisition is reported by a signal. The mask settings are handed over as a copy, the GUI thread may change its
+/// own anytime.
+class MaskTester : public QObject, public Processor {
+    Q_OBJECT
+
+  public:
+    MaskTester(const DsoSettingsScope *scope, const DsoSettingsPostProcessing *postprocessing);
+    ~MaskTester();
+    virtual void process(PPresult *result) override;
+
+    /// \brief The next frame of the tested channel becomes the golden waveform, can be called from any thread.
+    void captureGolden() { captureRequested = true; }
+    /// \brief Restarts the counters with the next frame, can be called from any thread.
+    void reset() { resetRequested = true; }
+    /// \brief Copies the golden waveform into the mask settings, so it is saved with them.
+    void golden(DsoSettingsMask &mask) const;
+    /// \brief Sets the mask for the next frames, can be called from any thread.
+    /// The golden waveform of the settings is ignored, it only changes by a capture.
+    void setMask(const DsoSettingsMask &mask);
+
+    /// \brief Parses the polygons of the mask settings.
+    /// \param text The points "x,y" in screen divisions, separated by spaces, a semicolon ends a polygon.
+    /// \return The polygons with at least three points.
+    static std::vector<std::vector<QPointF>> parsePolygons(const QString &text);
+
+  signals:
+    void goldenCaptured(); ///< A new golden waveform was captured, it can be read with golden()
+    void failed();         ///< A frame violated the mask and the action is Dso::MaskAction::STOP
+
+  private:
+    /// \brief The levels of each sample position, a band with lower > upper contains nothing.
+    struct Band {
+        std::vector<double> lower;
+        std::vector<double> upper;
+    };
+    /// \brief The golden waveform, its minimum and maximum in columns of 1 / GOLDEN_COLUMNS_PER_DIV div.
+    struct Golden {
+        std::vector<double> minimum;
+        std::vector<double> maximum;
+        double timebase = 0.0;
+        unsigned version = 0; ///< Counts the captures, the limits are compiled again for a new one
+    };
+    /// \brief A frame that violated the mask and waits to be saved.
+    struct FailedFrame {
+        QString fileName;
+        std::vector<double> samples;
+        double interval;
+        double start; ///< Time of the first sample relative to the left edge of the screen
+    };
+
+    /// \brief Compiles the limits again if the mask or the scope settings have changed.
+    void compile(const DsoSettingsMask &mask, double interval);
+    void compileGolden(const DsoSettingsMask &mask, size_t count, double interval);
+    void compilePolygons(const DsoSettingsMask &mask, size_t count, double interval);
+    /// \brief Adds the envelope of a band to the outline, for the golden waveform.
+    void outlineBand(const Band &band, double interval);
+    /// \brief Makes the samples the new golden waveform.
+    void capture(const std::vector<double> &samples, unsigned offset, double fraction, double interval);
+    /// \return The number of samples that violate the mask.
+    unsigned long long countHits(const double *samples, size_t count);
+    /// \brief Writes the failed frames, runs in the writer thread.
+    void flush();
+
+    const DsoSettingsScope *scope;
+
+    QMutex settingsMutex;            ///< Guards the pending settings
+    DsoSettingsMask settings;        ///< The mask of the current frame, without the golden waveform
+    DsoSettingsMask pendingSettings; ///< Set by setMask(), used with the next frame
+    bool settingsChanged = false;    ///< The pending settings are new
+
+    mutable QMutex goldenMutex;
+    Golden goldenWaveform;
+
+    // The settings the limits were compiled for
+    bool compiled = false;
+    Dso::MaskMode compiledMode = Dso::MaskMode::OFF;
+    unsigned compiledChannel = 0;
+    double compiledTimeTolerance = 0.0;
+    double compiledVoltageTolerance = 0.0;
+    QString compiledPolygons;
+    double compiledInterval = 0.0;
+    double compiledTimebase = 0.0;
+    double compiledGain = 0.0;
+    double compiledOffset = 0.0;
+    bool compiledInverted = false;
+    unsigned compiledVersion = 0;
+
+    Band allowed;                        ///< The allowed levels, empty if there are only forbidden regions
+    std::vector<Band> forbidden;         ///< The forbidden levels of each polygon
+    std::vector<unsigned char> violated; ///< The flags of the samples that violate the mask
+    ChannelGraph outline;                ///< The mask for the screen
+    MaskTestResult counters;
+
+    std::atomic<bool> captureRequested{false};
+    std::atomic<bool> resetRequested{false};
+
+    QMutex pendingMutex;
+    std::deque<FailedFrame> pending; ///< Failed frames that are not saved yet
+    std::atomic<bool> flushQueued{false};
+    PoolTask flushTask;
+    QThreadPool writer; ///< A single thread, the frames are saved in order
+};
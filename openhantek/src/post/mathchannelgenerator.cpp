@@ -1,47 +1,169 @@
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <memory>
+
+#include "fftthreads.h"
 #include "mathchannelgenerator.h"
+#include "pooltask.h"
 #include "scopesettings.h"
 #include "post/postprocessingsettings.h"
 #include "enums.h"
 
 MathChannelGenerator::MathChannelGenerator(const DsoSettingsScope *scope, unsigned physicalChannels)
-    : physicalChannels(physicalChannels), scope(scope) {}
+    : physicalChannels(physicalChannels), scope(scope) {
+    // The calling thread calculates a channel as well
+    pool.setMaxThreadCount((int)std::max(1u, FftThreads::get()->threadBudget() - 1));
+    for (const DsoSettingsScopeVoltage &voltage : scope->voltage) expressions.push_back(voltage.mathExpression);
+}
 
 MathChannelGenerator::~MathChannelGenerator() {}
 
+void MathChannelGenerator::setExpression(ChannelID channel, const QString &expression) {
+    QMutexLocker locker(&expressionMutex);
+    if (channel < expressions.size()) expressions[channel] = expression;
+}
+
+QString MathChannelGenerator::expressionText(ChannelID channel) const {
+    switch (Dso::getMathMode(scope->voltage[channel])) {
+    case Dso::MathMode::ADD_CH1_CH2:
+        return "CH1+CH2";
+    case Dso::MathMode::SUB_CH2_FROM_CH1:
+        return "CH1-CH2";
+    case Dso::MathMode::SUB_CH1_FROM_CH2:
+        return "CH2-CH1";
+    case Dso::MathMode::EXPRESSION: {
+        QMutexLocker locker(&expressionMutex);
+        return channel < expressions.size() ? expressions[channel] : QString();
+    }
+    }
+    return QString();
+}
+
+void MathChannelGenerator::updateLevels() {
+    const unsigned mathChannels = (unsigned)programs.size();
+    for (Program &program : programs) program.level = UINT_MAX;
+
+    // Every pass resolves at least one channel, unless the remaining ones form a cycle
+    for (unsigned pass = 0; pass < mathChannels; ++pass) {
+        bool changed = false;
+        for (Program &program : programs) {
+            if (program.level != UINT_MAX || !program.expression.isValid()) continue;
+            unsigned level = 0;
+            for (ChannelID input : program.expression.inputs()) {
+                if (input < physicalChannels) continue;
+                const unsigned inputLevel = programs[input - physicalChannels].level;
+                level = inputLevel == UINT_MAX ? UINT_MAX : std::max(level, inputLevel + 1);
+                if (level == UINT_MAX) break;
+            }
+            if (level == UINT_MAX) continue;
+            program.level = level;
+            changed = true;
+        }
+        if (!changed) break;
+    }
+}
+
+void MathChannelGenerator::calculate(ChannelID channel, PPresult *result) {
+    Program &program = programs[channel - physicalChannels];
+    DataChannel *const channelData = result->modifyData(channel);
+    std::vector<double> &resultData = channelData->voltage.sample;
+    channelData->generation = 0;
+
+    // All inputs need samples, the result is as long as the shortest one
+    std::vector<const std::vector<double> *> inputs(result->channelCount(), nullptr);
+    size_t length = SIZE_MAX;
+    for (ChannelID input : program.expression.inputs()) {
+        inputs[input] = &result->data(input)->voltage.sample;
+        length = std::min(length, inputs[input]->size());
+    }
+    if (program.expression.inputs().empty() || length == 0) {
+        resultData.clear();
+        program.cached = false;
+        return;
+    }
+
+    // Set sampling interval
+    const double interval = result->data(program.expression.inputs().front())->voltage.interval;
+    channelData->voltage.interval = interval;
+
+    // Reuse the last result if no input changed, streamed records always continue the calculation
+    std::vector<unsigned long long> generations;
+    bool reusable = !result->append;
+    for (ChannelID input : program.expression.inputs()) {
+        generations.push_back(result->data(input)->generation);
+        reusable = reusable && generations.back() != 0;
+    }
+    if (reusable && program.cached && interval == program.cachedInterval && generations == program.cachedGenerations) {
+        resultData = program.cachedOutput;
+        channelData->generation = program.generation;
+        return;
+    }
+
+    // Calculate values and write them into the sample buffer
+    program.expression.evaluate(inputs, length, interval, resultData, result->append);
+
+    program.cached = reusable;
+    if (!reusable) return;
+    program.cachedGenerations.swap(generations);
+    program.cachedInterval = interval;
+    program.cachedOutput = resultData;
+    channelData->generation = ++program.generation;
+}
+
 void MathChannelGenerator::process(PPresult *result) {
-    bool channelsHaveData = !result->data(0)->voltage.sample.empty() && !result->data(1)->voltage.sample.empty();
-    if (!channelsHaveData) return;
+    const unsigned mathChannels = result->channelCount() - std::min(physicalChannels, result->channelCount());
+    programs.resize(mathChannels);
 
+    // Compile the expressions only if they have been changed
+    bool compiled = false;
     for (ChannelID channel = physicalChannels; channel < result->channelCount(); ++channel) {
-        DataChannel *const channelData = result->modifyData(channel);
-
-        // Math channel enabled?
-        if (!scope->voltage[channel].used && !scope->spectrum[channel].used) continue;
-
-        // Set sampling interval
-        channelData->voltage.interval = result->data(0)->voltage.interval;
-
-        // Resize the sample vector
-        std::vector<double> &resultData = channelData->voltage.sample;
-        resultData.resize(std::min(result->data(0)->voltage.sample.size(), result->data(1)->voltage.sample.size()));
-
-        // Calculate values and write them into the sample buffer
-        std::vector<double>::const_iterator ch1Iterator = result->data(0)->voltage.sample.begin();
-        std::vector<double>::const_iterator ch2Iterator = result->data(1)->voltage.sample.begin();
-        for (std::vector<double>::iterator it = resultData.begin(); it != resultData.end(); ++it) {
-            switch (Dso::getMathMode(scope->voltage[physicalChannels])) {
-            case Dso::MathMode::ADD_CH1_CH2:
-                *it = *ch1Iterator + *ch2Iterator;
-                break;
-            case Dso::MathMode::SUB_CH2_FROM_CH1:
-                *it = *ch1Iterator - *ch2Iterator;
-                break;
-            case Dso::MathMode::SUB_CH1_FROM_CH2:
-                *it = *ch2Iterator - *ch1Iterator;
-                break;
-            }
-            ++ch1Iterator;
-            ++ch2Iterator;
+        Program &program = programs[channel - physicalChannels];
+        const QString text = expressionText(channel);
+        if (program.text == text) continue;
+        program.text = text;
+        program.expression.compile(text, physicalChannels, mathChannels);
+        program.cached = false;
+        compiled = true;
+    }
+    if (compiled) updateLevels();
+
+    // Shown channels need all channels they read
+    std::vector<ChannelID> pending;
+    for (ChannelID channel = physicalChannels; channel < result->channelCount(); ++channel) {
+        programs[channel - physicalChannels].needed = scope->anyUsed(channel);
+        if (programs[channel - physicalChannels].needed) pending.push_back(channel);
+    }
+    unsigned maxLevel = 0;
+    while (!pending.empty()) {
+        Program &program = programs[pending.back() - physicalChannels];
+        pending.pop_back();
+        if (program.level == UINT_MAX) continue;
+        maxLevel = std::max(maxLevel, program.level);
+        for (ChannelID input : program.expression.inputs()) {
+            if (input < physicalChannels || programs[input - physicalChannels].needed) continue;
+            programs[input - physicalChannels].needed = true;
+            pending.push_back(input);
+        }
+    }
+
+    // Calculate the levels one after another, the channels of a level are independent
+    std::vector<ChannelID> channels;
+    std::vector<std::unique_ptr<PoolTask>> tasks;
+    for (unsigned level = 0; level <= maxLevel; ++level) {
+        channels.clear();
+        for (ChannelID channel = physicalChannels; channel < result->channelCount(); ++channel) {
+            const Program &program = programs[channel - physicalChannels];
+            if (program.needed && program.level == level) channels.push_back(channel);
+        }
+
+        tasks.clear();
+        for (size_t index = 1; index < channels.size(); ++index) {
+            const ChannelID channel = channels[index];
+            tasks.emplace_back(new PoolTask([this, channel, result]() { calculate(channel, result); }));
+            pool.start(tasks.back().get());
         }
+        if (!channels.empty()) calculate(channels.front(), result);
+        if (!tasks.empty()) pool.waitForDone();
     }
 }
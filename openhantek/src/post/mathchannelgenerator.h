@@ -2,18 +2,59 @@
 
 #pragma once
 
+#include <vector>
+
+#include <QMutex>
+#include <QString>
+#include <QThreadPool>
+
+#include "mathexpression.h"
 #include "processor.h"
 
 struct DsoSettingsScope;
 class PPresult;
 
+/// \brief Calculates the math channels.
+/// Every math channel has its own expression, which may read the physical channels and other math channels. The
+/// channels are evaluated in the order of their dependencies: all channels of one level only read channels of the
+/// lower levels and are calculated in parallel. A channel whose inputs and expression did not change since the last
+/// record reuses its previous result, the inputs are identified by the generation stamp of their samples.
 class MathChannelGenerator : public Processor
 {
 public:
     MathChannelGenerator(const DsoSettingsScope *scope, unsigned physicalChannels);
     virtual ~MathChannelGenerator();
     virtual void process(PPresult *) override;
+
+    /// \brief Sets the expression of a math channel for the EXPRESSION mode, can be called from any thread.
+    /// The expression is compiled with the next record.
+    void setExpression(ChannelID channel, const QString &expression);
 private:
+    /// \brief The compiled expression of a math channel and its cached result.
+    struct Program {
+        QString text; ///< The source of the expression, it is only compiled again if this changes
+        MathExpression expression;
+        unsigned level = 0;  ///< Length of the longest chain of math channels this one depends on
+        bool needed = false; ///< The channel is shown or read by a shown channel
+
+        std::vector<unsigned long long> cachedGenerations; ///< The generations of the inputs of the cached result
+        double cachedInterval = 0.0;
+        std::vector<double> cachedOutput;
+        bool cached = false;
+        unsigned long long generation = 0; ///< Counted up for every cached result
+    };
+
+    /// \return The expression the math channel should calculate.
+    QString expressionText(ChannelID channel) const;
+    /// \brief Sorts the math channels by their dependencies, channels in a cycle get no level.
+    void updateLevels();
+    /// \brief Calculates one math channel, its inputs are complete.
+    void calculate(ChannelID channel, PPresult *result);
+
     const unsigned physicalChannels;
     const DsoSettingsScope *scope;
+    std::vector<Program> programs;    ///< One program for each math channel
+    QThreadPool pool;                 ///< Threads for the independent channels of a level
+    std::vector<QString> expressions; ///< Expression of each channel, set by the GUI thread
+    mutable QMutex expressionMutex;   ///< Guards the expressions
 };
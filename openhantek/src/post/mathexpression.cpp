@@ -0,0 +1,426 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <string>
+
+#include <QCoreApplication>
+#include <QLocale>
+
+#include "mathexpression.h"
+
+namespace {
+/// Number of samples in a register. A few registers fit into the L1 cache together with the input blocks.
+const size_t BLOCK_SIZE = 1024;
+
+typedef MathExpression::Operation Operation;
+typedef MathExpression::Operand Operand;
+
+/// \brief Recursive descent parser that emits the program while parsing.
+/// Temporary registers are allocated like a stack, an operation releases its operands before it allocates the
+/// register for its result. All operations are written so that the result may overwrite an operand.
+class Compiler {
+  public:
+    Compiler(const std::string &text, unsigned physicalChannels, unsigned mathChannels)
+        : text(text), physicalChannels(physicalChannels), channelCount(physicalChannels + mathChannels) {}
+
+    bool run(std::vector<MathExpression::Instruction> &program, std::vector<double> &constantValues,
+             unsigned &registerCount, std::vector<ChannelID> &inputs, Operand &result, QString &error) {
+        Value value = expression();
+        skipSpaces();
+        if (this->error.isEmpty() && position < text.size())
+            fail(QCoreApplication::tr("Unexpected '%1'").arg(QChar::fromLatin1(text[position])));
+        if (!this->error.isEmpty()) {
+            error = this->error;
+            return false;
+        }
+
+        result = operand(value);
+        program = std::move(this->program);
+        constantValues = std::move(this->constantValues);
+        registerCount = maxRegister;
+        inputs.clear();
+        for (ChannelID channel = 0; channel < channelCount; ++channel)
+            if (channelUsed[channel]) inputs.push_back(channel);
+        return true;
+    }
+
+  private:
+    /// \brief Result of a subexpression, numbers are kept until they are needed as an operand.
+    struct Value {
+        enum Kind { NUMBER, CHANNEL, REGISTER } kind = NUMBER;
+        unsigned index = 0;
+        double number = 0.0;
+    };
+
+    void fail(const QString &message) {
+        if (error.isEmpty()) error = message;
+        // Stop parsing
+        position = text.size();
+    }
+
+    void skipSpaces() {
+        while (position < text.size() && isspace((unsigned char)text[position])) ++position;
+    }
+
+    bool accept(char character) {
+        skipSpaces();
+        if (position < text.size() && text[position] == character) {
+            ++position;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char character) {
+        if (!accept(character)) fail(QCoreApplication::tr("'%1' expected").arg(QChar::fromLatin1(character)));
+    }
+
+    Operand operand(const Value &value) {
+        Operand operand;
+        switch (value.kind) {
+        case Value::NUMBER:
+            operand.kind = Operand::CONSTANT;
+            operand.index = (unsigned)constantValues.size();
+            constantValues.push_back(value.number);
+            break;
+        case Value::CHANNEL:
+            operand.kind = Operand::CHANNEL;
+            operand.index = value.index;
+            break;
+        case Value::REGISTER:
+            operand.kind = Operand::REGISTER;
+            operand.index = value.index;
+            break;
+        }
+        return operand;
+    }
+
+    void release(const Value &value) {
+        if (value.kind == Value::REGISTER && value.index + 1 == nextRegister) --nextRegister;
+    }
+
+    Value allocate() {
+        Value value;
+        value.kind = Value::REGISTER;
+        value.index = nextRegister++;
+        maxRegister = std::max(maxRegister, nextRegister);
+        return value;
+    }
+
+    Value generate(Operation operation, const Value &first, const Value *second = nullptr) {
+        MathExpression::Instruction instruction;
+        instruction.operation = operation;
+        instruction.first = operand(first);
+        if (second) {
+            instruction.second = operand(*second);
+            release(*second);
+        }
+        release(first);
+        Value target = allocate();
+        instruction.target = target.index;
+        program.push_back(instruction);
+        return target;
+    }
+
+    Value binary(Operation operation, const Value &first, const Value &second) {
+        if (first.kind == Value::NUMBER && second.kind == Value::NUMBER) {
+            Value folded;
+            switch (operation) {
+            case Operation::ADD:
+                folded.number = first.number + second.number;
+                break;
+            case Operation::SUB:
+                folded.number = first.number - second.number;
+                break;
+            case Operation::MUL:
+                folded.number = first.number * second.number;
+                break;
+            default: // Operation::DIV
+                folded.number = first.number / second.number;
+                break;
+            }
+            return folded;
+        }
+        return generate(operation, first, &second);
+    }
+
+    Value unary(Operation operation, const Value &argument) {
+        if (argument.kind == Value::NUMBER && operation != Operation::INTEGRAL) {
+            Value folded;
+            switch (operation) {
+            case Operation::NEG:
+                folded.number = -argument.number;
+                break;
+            case Operation::ABS:
+                folded.number = std::abs(argument.number);
+                break;
+            case Operation::SQRT:
+                folded.number = std::sqrt(argument.number);
+                break;
+            default: // Operation::DDT
+                folded.number = 0.0;
+                break;
+            }
+            return folded;
+        }
+        return generate(operation, argument);
+    }
+
+    Value expression() {
+        Value value = term();
+        for (;;) {
+            if (accept('+'))
+                value = binary(Operation::ADD, value, term());
+            else if (accept('-'))
+                value = binary(Operation::SUB, value, term());
+            else
+                return value;
+        }
+    }
+
+    Value term() {
+        Value value = factor();
+        for (;;) {
+            if (accept('*'))
+                value = binary(Operation::MUL, value, factor());
+            else if (accept('/'))
+                value = binary(Operation::DIV, value, factor());
+            else
+                return value;
+        }
+    }
+
+    Value factor() {
+        if (accept('-')) return unary(Operation::NEG, factor());
+        if (accept('+')) return factor();
+        return primary();
+    }
+
+    Value argument() {
+        expect('(');
+        Value value = expression();
+        expect(')');
+        return value;
+    }
+
+    Value primary() {
+        skipSpaces();
+        if (position >= text.size()) {
+            fail(QCoreApplication::tr("Unexpected end of expression"));
+            return Value();
+        }
+
+        if (accept('(')) {
+            Value value = expression();
+            expect(')');
+            return value;
+        }
+
+        const char first = text[position];
+        if (isdigit((unsigned char)first) || first == '.') {
+            // The number always uses a decimal point, independent of the locale
+            const size_t start = position;
+            while (position < text.size() && (isdigit((unsigned char)text[position]) || text[position] == '.'))
+                ++position;
+            if (position < text.size() && (text[position] == 'e' || text[position] == 'E')) {
+                size_t exponent = position + 1;
+                if (exponent < text.size() && (text[exponent] == '+' || text[exponent] == '-')) ++exponent;
+                if (exponent < text.size() && isdigit((unsigned char)text[exponent])) {
+                    position = exponent;
+                    while (position < text.size() && isdigit((unsigned char)text[position])) ++position;
+                }
+            }
+            bool ok = false;
+            Value value;
+            const QString number = QString::fromLatin1(text.c_str() + start, (int)(position - start));
+            value.number = QLocale::c().toDouble(number, &ok);
+            if (!ok) fail(QCoreApplication::tr("Invalid number"));
+            return value;
+        }
+
+        if (!isalpha((unsigned char)first)) {
+            fail(QCoreApplication::tr("Unexpected '%1'").arg(QChar::fromLatin1(first)));
+            return Value();
+        }
+
+        std::string name;
+        while (position < text.size() && (isalnum((unsigned char)text[position]) || text[position] == '_'))
+            name += (char)tolower((unsigned char)text[position++]);
+
+        // CHn or Mn
+        const size_t digits = name.compare(0, 2, "ch") == 0 ? 2 : name.compare(0, 1, "m") == 0 ? 1 : 0;
+        if (digits && name.size() > digits && name.size() < digits + 6 &&
+            std::all_of(name.begin() + (long)digits, name.end(), [](char c) { return isdigit((unsigned char)c); })) {
+            const unsigned number = (unsigned)std::stoul(name.substr(digits));
+            const bool math = digits == 1;
+            const unsigned first = math ? physicalChannels : 0;
+            const unsigned count = math ? channelCount - physicalChannels : physicalChannels;
+            if (number < 1 || number > count) {
+                fail(math ? QCoreApplication::tr("Unknown math channel M%1").arg(number)
+                          : QCoreApplication::tr("Unknown channel CH%1").arg(number));
+                return Value();
+            }
+            Value value;
+            value.kind = Value::CHANNEL;
+            value.index = first + number - 1;
+            channelUsed[value.index] = true;
+            return value;
+        }
+
+        if (name == "pi" || name == "e") {
+            Value value;
+            value.number = name == "pi" ? M_PI : M_E;
+            return value;
+        }
+        if (name == "abs") return unary(Operation::ABS, argument());
+        if (name == "sqrt") return unary(Operation::SQRT, argument());
+        if (name == "integral") return unary(Operation::INTEGRAL, argument());
+        if (name == "ddt") return unary(Operation::DDT, argument());
+        if (name == "d") {
+            // d/dt(...)
+            const size_t start = position;
+            if (accept('/')) {
+                skipSpaces();
+                if (text.compare(position, 2, "dt") == 0) {
+                    position += 2;
+                    return unary(Operation::DDT, argument());
+                }
+            }
+            position = start;
+        }
+
+        fail(QCoreApplication::tr("Unknown name '%1'").arg(QString::fromStdString(name)));
+        return Value();
+    }
+
+    const std::string &text;
+    const unsigned physicalChannels;
+    const unsigned channelCount;
+    size_t position = 0;
+    QString error;
+
+    std::vector<MathExpression::Instruction> program;
+    std::vector<double> constantValues;
+    unsigned nextRegister = 0;
+    unsigned maxRegister = 0;
+    std::vector<bool> channelUsed = std::vector<bool>(channelCount, false);
+};
+} // namespace
+
+bool MathExpression::compile(const QString &text, unsigned physicalChannels, unsigned mathChannels, QString *error) {
+    valid = false;
+    const std::string source = text.toStdString();
+    QString message;
+    Compiler compiler(source, physicalChannels, mathChannels);
+    if (!compiler.run(program, constantValues, registerCount, inputChannels, result, message)) {
+        if (error) *error = message;
+        program.clear();
+        inputChannels.clear();
+        return false;
+    }
+
+    // The constant blocks never change
+    constants.resize(constantValues.size() * BLOCK_SIZE);
+    for (size_t constant = 0; constant < constantValues.size(); ++constant)
+        std::fill_n(constants.begin() + (long)(constant * BLOCK_SIZE), BLOCK_SIZE, constantValues[constant]);
+    registers.resize(registerCount * BLOCK_SIZE);
+    states.clear();
+
+    valid = true;
+    return true;
+}
+
+void MathExpression::evaluate(const std::vector<const std::vector<double> *> &channels, size_t length,
+                              double interval, std::vector<double> &output, bool append) {
+    output.resize(valid ? length : 0);
+    if (!valid) return;
+
+    if (!append || states.size() != program.size()) states.assign(program.size(), State());
+    const double rate = interval > 0.0 ? 1.0 / interval : 0.0;
+
+    for (size_t offset = 0; offset < length; offset += BLOCK_SIZE) {
+        const size_t count = std::min(BLOCK_SIZE, length - offset);
+
+        auto values = [&](const Operand &operand) -> const double * {
+            switch (operand.kind) {
+            case Operand::REGISTER:
+                return registers.data() + operand.index * BLOCK_SIZE;
+            case Operand::CHANNEL:
+                return channels[operand.index]->data() + offset;
+            default: // Operand::CONSTANT
+                return constants.data() + operand.index * BLOCK_SIZE;
+            }
+        };
+
+        for (size_t step = 0; step < program.size(); ++step) {
+            const Instruction &instruction = program[step];
+            double *target = registers.data() + instruction.target * BLOCK_SIZE;
+            const double *first = values(instruction.first);
+            const double *second = instruction.operation < Operation::NEG ? values(instruction.second) : nullptr;
+            State &state = states[step];
+
+            switch (instruction.operation) {
+            case Operation::ADD:
+                for (size_t i = 0; i < count; ++i) target[i] = first[i] + second[i];
+                break;
+            case Operation::SUB:
+                for (size_t i = 0; i < count; ++i) target[i] = first[i] - second[i];
+                break;
+            case Operation::MUL:
+                for (size_t i = 0; i < count; ++i) target[i] = first[i] * second[i];
+                break;
+            case Operation::DIV:
+                for (size_t i = 0; i < count; ++i) target[i] = first[i] / second[i];
+                break;
+            case Operation::NEG:
+                for (size_t i = 0; i < count; ++i) target[i] = -first[i];
+                break;
+            case Operation::ABS:
+                for (size_t i = 0; i < count; ++i) target[i] = std::abs(first[i]);
+                break;
+            case Operation::SQRT:
+                for (size_t i = 0; i < count; ++i) target[i] = std::sqrt(first[i]);
+                break;
+            case Operation::DDT: {
+                // Backwards, so the target may be the operand
+                const double head = first[0];
+                const double tail = first[count - 1];
+                for (size_t i = count - 1; i > 0; --i) target[i] = (first[i] - first[i - 1]) * rate;
+                if (state.started)
+                    target[0] = (head - state.previous) * rate;
+                else
+                    target[0] = count > 1 ? target[1] : 0.0;
+                state.previous = tail;
+                state.started = true;
+            } break;
+            case Operation::INTEGRAL: {
+                // Trapezoidal rule, the integral starts with 0 at the first sample
+                size_t i = 0;
+                if (!state.started) {
+                    state.previous = first[0];
+                    target[0] = 0.0;
+                    state.started = true;
+                    i = 1;
+                }
+                double sum = state.sum;
+                double previous = state.previous;
+                const double halfInterval = interval / 2.0;
+                for (; i < count; ++i) {
+                    const double value = first[i];
+                    sum += (previous + value) * halfInterval;
+                    previous = value;
+                    target[i] = sum;
+                }
+                state.sum = sum;
+                state.previous = previous;
+            } break;
+            }
+        }
+
+        const double *resultValues = values(result);
+        std::copy(resultValues, resultValues + count, output.begin() + (long)offset);
+    }
+}
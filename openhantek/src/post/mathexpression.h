@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <vector>
+
+#include <QString>
+
+#include "hantekprotocol/types.h"
+
+/// \brief Expression of a math channel, compiled into operations on blocks of samples.
+/// The expression is parsed once into a short program for a register machine whose registers hold a block of
+/// samples each. Every operation is a simple loop over a whole block, so there is no dispatch per sample and the
+/// loops can be vectorized by the compiler. Constant subexpressions are folded while compiling.
+///
+/// Supported are the channels CH1 ... CHn, the math channels M1 ... Mn, numbers, the constants pi and e, the
+/// operators + - * / with the usual precedence, parentheses and the functions abs(), sqrt(), d/dt() (or ddt()) and
+/// integral().
+class MathExpression {
+  public:
+    /// \brief Compiles an expression, the previous program is replaced.
+    /// \param text The expression, e.g. "CH1*CH2" or "integral(abs(CH1))".
+    /// \param physicalChannels The number of channels CHn the expression may refer to.
+    /// \param mathChannels The number of math channels Mn, they follow the physical channels.
+    /// \param error The description of the error, if the expression is invalid.
+    /// \return true, if the expression was compiled.
+    bool compile(const QString &text, unsigned physicalChannels, unsigned mathChannels = 0, QString *error = nullptr);
+
+    /// \return true, if a valid expression has been compiled.
+    bool isValid() const { return valid; }
+    /// \return The channels the expression reads, in ascending order. Math channels follow the physical ones.
+    const std::vector<ChannelID> &inputs() const { return inputChannels; }
+
+    /// \brief Evaluates the expression.
+    /// \param channels The samples of each channel, only the inputs() need to be valid.
+    /// \param length The number of samples to calculate, no input may be shorter.
+    /// \param interval The time between two samples in seconds, needed for d/dt and integral.
+    /// \param output The calculated samples.
+    /// \param append true, if the samples continue the previous call. d/dt and integral keep their state then.
+    void evaluate(const std::vector<const std::vector<double> *> &channels, size_t length, double interval,
+                  std::vector<double> &output, bool append = false);
+
+    /// \brief The operations of the program.
+    enum class Operation : unsigned char { ADD, SUB, MUL, DIV, NEG, ABS, SQRT, DDT, INTEGRAL };
+
+    /// \brief Location of a block of values.
+    struct Operand {
+        enum Kind : unsigned char { REGISTER, CHANNEL, CONSTANT } kind = CONSTANT;
+        unsigned index = 0; ///< Register, channel or index of the constant
+    };
+
+    /// \brief One step of the program, operates on a whole block.
+    struct Instruction {
+        Operation operation;
+        unsigned target; ///< Register that receives the result
+        Operand first;
+        Operand second; ///< Unused by unary operations
+    };
+
+  private:
+    /// \brief Running values of d/dt and integral between the blocks.
+    struct State {
+        double previous = 0.0;
+        double sum = 0.0;
+        bool started = false;
+    };
+
+    bool valid = false;
+    std::vector<Instruction> program;
+    Operand result;                     ///< The location of the final value
+    std::vector<double> constantValues; ///< Constants that are used as operands
+    unsigned registerCount = 0;
+    std::vector<ChannelID> inputChannels;
+
+    // Working memory, kept between the evaluations
+    std::vector<double> registers; ///< registerCount blocks
+    std::vector<double> constants; ///< One block filled with each of the constantValues
+    std::vector<State> states;     ///< One state for each instruction
+};
@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+#include <cmath>
+
+#include "measurementprocessor.h"
+#include "scopesettings.h"
+
+namespace {
+/// Independent accumulators of the statistics pass, the compiler maps them onto the SIMD lanes.
+const size_t LANES = 4;
+/// Bins of the histogram for top and base.
+const unsigned HISTOGRAM_BINS = 256;
+/// The most common level of a half of the histogram is top or base only if it holds this share of all samples.
+const double LEVEL_SHARE = 0.05;
+/// The reference levels of the timing measurements relative to the amplitude.
+const double LOW_LEVEL = 0.1;
+const double MIDDLE_LEVEL = 0.5;
+const double HIGH_LEVEL = 0.9;
+
+/// \brief Time of the crossing of level between the samples before position and at position.
+inline double crossing(size_t position, double previous, double value, double level, double interval) {
+    return ((double)position - 1.0 + (level - previous) / (value - previous)) * interval;
+}
+} // namespace
+
+MeasurementProcessor::MeasurementProcessor(const DsoSettingsScope *scope) : scope(scope) {}
+
+void MeasurementProcessor::process(PPresult *result) {
+    for (ChannelID channel = 0; channel < result->channelCount(); ++channel) {
+        DataChannel *const channelData = result->modifyData(channel);
+        Measurements &measurements = channelData->measurements;
+        measurements = Measurements();
+
+        const SampleValues &voltage = channelData->voltage;
+        if (channel >= scope->voltage.size() || !scope->voltage[channel].used || voltage.sample.empty()) continue;
+
+        measureStatistics(voltage.sample, measurements);
+        measureLevels(voltage.sample, measurements);
+        measureTiming(voltage.sample, voltage.interval, measurements);
+        measurements.valid = true;
+    }
+}
+
+void MeasurementProcessor::measureStatistics(const std::vector<double> &samples, Measurements &measurements) {
+    const size_t count = samples.size();
+    const double *values = samples.data();
+
+    double minimum[LANES], maximum[LANES], sum[LANES], squares[LANES];
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        minimum[lane] = maximum[lane] = values[0];
+        sum[lane] = squares[lane] = 0.0;
+    }
+    // Every lane has its own accumulators, so the loop has no dependency between neighbouring samples
+    size_t position = 0;
+    for (; position + LANES <= count; position += LANES) {
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            const double value = values[position + lane];
+            minimum[lane] = std::min(minimum[lane], value);
+            maximum[lane] = std::max(maximum[lane], value);
+            sum[lane] += value;
+            squares[lane] += value * value;
+        }
+    }
+    for (; position < count; ++position) {
+        const double value = values[position];
+        minimum[0] = std::min(minimum[0], value);
+        maximum[0] = std::max(maximum[0], value);
+        sum[0] += value;
+        squares[0] += value * value;
+    }
+    for (size_t lane = 1; lane < LANES; ++lane) {
+        minimum[0] = std::min(minimum[0], minimum[lane]);
+        maximum[0] = std::max(maximum[0], maximum[lane]);
+        sum[0] += sum[lane];
+        squares[0] += squares[lane];
+    }
+
+    measurements.minimum = minimum[0];
+    measurements.maximum = maximum[0];
+    measurements.peakToPeak = maximum[0] - minimum[0];
+    measurements.mean = sum[0] / (double)count;
+    measurements.rms = std::sqrt(squares[0] / (double)count);
+}
+
+void MeasurementProcessor::measureLevels(const std::vector<double> &samples, Measurements &measurements) {
+    const double minimum = measurements.minimum;
+    const double mean = measurements.mean;
+    measurements.top = measurements.maximum;
+    measurements.base = minimum;
+    measurements.amplitude = measurements.peakToPeak;
+
+    if (measurements.peakToPeak <= 0.0) return;
+
+    histogramCount.assign(HISTOGRAM_BINS, 0);
+    histogramSum.assign(HISTOGRAM_BINS, 0.0);
+    const double scale = HISTOGRAM_BINS / measurements.peakToPeak;
+    // The deviation from the mean is summed again instead of using the sum of squares, which would cancel out
+    // for a small signal on a large offset
+    double deviation = 0.0;
+    for (const double value : samples) {
+        const unsigned bin = std::min((unsigned)((value - minimum) * scale), HISTOGRAM_BINS - 1);
+        ++histogramCount[bin];
+        histogramSum[bin] += value;
+        deviation += (value - mean) * (value - mean);
+    }
+    measurements.acRms = std::sqrt(deviation / (double)samples.size());
+
+    // The most common level of each half, a sine or a triangle has none and uses the extremes
+    const unsigned minimalCount = (unsigned)std::ceil(LEVEL_SHARE * (double)samples.size());
+    const auto lowerHalf = histogramCount.begin() + HISTOGRAM_BINS / 2;
+    const auto baseBin = std::max_element(histogramCount.begin(), lowerHalf);
+    const auto topBin = std::max_element(lowerHalf, histogramCount.end());
+    if (*baseBin >= minimalCount) measurements.base = histogramSum[baseBin - histogramCount.begin()] / *baseBin;
+    if (*topBin >= minimalCount) measurements.top = histogramSum[topBin - histogramCount.begin()] / *topBin;
+
+    measurements.amplitude = measurements.top - measurements.base;
+    if (measurements.amplitude > 0.0) {
+        measurements.overshoot = (measurements.maximum - measurements.top) / measurements.amplitude;
+        measurements.undershoot = (measurements.base - measurements.minimum) / measurements.amplitude;
+    }
+}
+
+void MeasurementProcessor::measureTiming(const std::vector<double> &samples, double interval,
+                                         Measurements &measurements) {
+    if (measurements.amplitude <= 0.0 || interval <= 0.0) return;
+    const double low = measurements.base + LOW_LEVEL * measurements.amplitude;
+    const double middle = measurements.base + MIDDLE_LEVEL * measurements.amplitude;
+    const double high = measurements.base + HIGH_LEVEL * measurements.amplitude;
+
+    // The signal is low below the low level and high above the high level, an edge is only complete if it
+    // passes both, noise around a single level doesn't count
+    enum class State { UNKNOWN, LOW, HIGH };
+    State state = samples.front() < low ? State::LOW : samples.front() > high ? State::HIGH : State::UNKNOWN;
+
+    double lowCrossing = 0.0, middleCrossing = 0.0, highCrossing = 0.0; ///< The last crossing of each level
+    double riseSum = 0.0, fallSum = 0.0;
+    unsigned rises = 0, falls = 0;
+    double firstRising = 0.0, lastRising = 0.0, lastFalling = 0.0; ///< 50 % crossings of complete edges
+    double positiveSum = 0.0, negativeSum = 0.0;
+    unsigned positiveCount = 0, negativeCount = 0;
+
+    for (size_t position = 1; position < samples.size(); ++position) {
+        const double previous = samples[position - 1];
+        const double value = samples[position];
+        if (value > previous) {
+            if (previous < low && value >= low) lowCrossing = crossing(position, previous, value, low, interval);
+            if (previous < middle && value >= middle)
+                middleCrossing = crossing(position, previous, value, middle, interval);
+            if (previous < high && value >= high) {
+                highCrossing = crossing(position, previous, value, high, interval);
+                if (state == State::LOW) {
+                    riseSum += highCrossing - lowCrossing;
+                    if (rises == 0) firstRising = middleCrossing;
+                    if (falls > 0) {
+                        negativeSum += middleCrossing - lastFalling;
+                        ++negativeCount;
+                    }
+                    lastRising = middleCrossing;
+                    ++rises;
+                }
+                state = State::HIGH;
+            }
+        } else if (value < previous) {
+            if (previous > high && value <= high) highCrossing = crossing(position, previous, value, high, interval);
+            if (previous > middle && value <= middle)
+                middleCrossing = crossing(position, previous, value, middle, interval);
+            if (previous > low && value <= low) {
+                lowCrossing = crossing(position, previous, value, low, interval);
+                if (state == State::HIGH) {
+                    fallSum += lowCrossing - highCrossing;
+                    if (rises > 0) {
+                        positiveSum += middleCrossing - lastRising;
+                        ++positiveCount;
+                    }
+                    lastFalling = middleCrossing;
+                    ++falls;
+                }
+                state = State::LOW;
+            }
+        }
+    }
+
+    if (rises > 0) measurements.riseTime = riseSum / rises;
+    if (falls > 0) measurements.fallTime = fallSum / falls;
+    if (rises > 1) measurements.period = (lastRising - firstRising) / (rises - 1);
+    if (positiveCount > 0) measurements.positiveWidth = positiveSum / positiveCount;
+    if (negativeCount > 0) measurements.negativeWidth = negativeSum / negativeCount;
+    if (measurements.period > 0.0 && positiveCount > 0)
+        measurements.dutyCycle = measurements.positiveWidth / measurements.period;
+}
@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <vector>
+
+#include "processor.h"
+
+struct DsoSettingsScope;
+
+/// \brief Measures the levels and the timing of the voltage channels.
+/// Runs after the filters and the math channels, so the GUI only has to print the results. The measurement needs
+/// three passes over the samples: The first one gathers minimum, maximum, sum and sum of squares together, the
+/// second one builds a histogram for top and base and the deviation from the mean, the third one follows the
+/// crossings of the 10 %, 50 % and 90 % levels for all timing measurements at once.
+class MeasurementProcessor : public Processor {
+  public:
+    MeasurementProcessor(const DsoSettingsScope *scope);
+    virtual void process(PPresult *result) override;
+
+  private:
+    /// \brief Minimum, maximum, peak-to-peak, mean and RMS.
+    static void measureStatistics(const std::vector<double> &samples, Measurements &measurements);
+    /// \brief Top, base, the derived levels and the AC RMS.
+    void measureLevels(const std::vector<double> &samples, Measurements &measurements);
+    /// \brief Rise and fall time, period, pulse widths and duty cycle.
+    static void measureTiming(const std::vector<double> &samples, double interval, Measurements &measurements);
+
+    const DsoSettingsScope *scope;
+    std::vector<unsigned> histogramCount; ///< Samples in each bin
+    std::vector<double> histogramSum;     ///< Sum of the samples in each bin, gives the exact level of a bin
+};
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include "measurementstatistics.h"
+#include "utils/printutils.h"
+
+void MeasurementStatistics::process(PPresult *result) {
+    if (resetRequested.exchange(false)) channels.clear();
+    if (channels.size() < result->channelCount()) channels.resize(result->channelCount());
+
+    for (ChannelID channel = 0; channel < result->channelCount(); ++channel) {
+        DataChannel *const channelData = result->modifyData(channel);
+        std::vector<MeasurementStatistic> &statistics = channels[channel];
+        if (statistics.size() != Dso::MEASUREMENT_COUNT) statistics.resize(Dso::MEASUREMENT_COUNT);
+
+        if (channelData->measurements.valid) {
+            for (Dso::Measurement measurement : Dso::MeasurementEnum) {
+                double measured;
+                if (value(*channelData, measurement, measured)) statistics[(unsigned)measurement].add(measured);
+            }
+        }
+        channelData->statistics = statistics;
+    }
+}
+
+bool MeasurementStatistics::value(const DataChannel &data, Dso::Measurement measurement, double &value) {
+    const Measurements &measurements = data.measurements;
+    if (!measurements.valid) return false;
+    switch (measurement) {
+    case Dso::Measurement::MINIMUM:
+        value = measurements.minimum;
+        return true;
+    case Dso::Measurement::MAXIMUM:
+        value = measurements.maximum;
+        return true;
+    case Dso::Measurement::PEAK_TO_PEAK:
+        value = measurements.peakToPeak;
+        return true;
+    case Dso::Measurement::MEAN:
+        value = measurements.mean;
+        return true;
+    case Dso::Measurement::RMS:
+        value = measurements.rms;
+        return true;
+    case Dso::Measurement::AC_RMS:
+        value = measurements.acRms;
+        return true;
+    case Dso::Measurement::TOP:
+        value = measurements.top;
+        return true;
+    case Dso::Measurement::BASE:
+        value = measurements.base;
+        return true;
+    case Dso::Measurement::AMPLITUDE:
+        value = measurements.amplitude;
+        return true;
+    case Dso::Measurement::OVERSHOOT:
+        value = measurements.overshoot;
+        return measurements.amplitude > 0.0;
+    case Dso::Measurement::UNDERSHOOT:
+        value = measurements.undershoot;
+        return measurements.amplitude > 0.0;
+    // The timing measurements are 0 if there was no complete edge or period
+    case Dso::Measurement::RISE_TIME:
+        value = measurements.riseTime;
+        break;
+    case Dso::Measurement::FALL_TIME:
+        value = measurements.fallTime;
+        break;
+    case Dso::Measurement::FREQUENCY:
+        value = data.frequency;
+        break;
+    case Dso::Measurement::PERIOD:
+        value = measurements.period;
+        break;
+    case Dso::Measurement::POSITIVE_WIDTH:
+        value = measurements.positiveWidth;
+        break;
+    case Dso::Measurement::NEGATIVE_WIDTH:
+        value = measurements.negativeWidth;
+        break;
+    case Dso::Measurement::DUTY_CYCLE:
+        value = measurements.dutyCycle;
+        break;
+    }
+    return value > 0.0;
+}
+
+QString MeasurementStatistics::valueString(Dso::Measurement measurement, double value) {
+    switch (measurement) {
+    case Dso::Measurement::OVERSHOOT:
+    case Dso::Measurement::UNDERSHOOT:
+    case Dso::Measurement::DUTY_CYCLE:
+        return QString("%L1 %").arg(value * 100.0, 0, 'f', 1);
+    case Dso::Measurement::FREQUENCY:
+        return valueToString(value, UNIT_HERTZ, 5);
+    case Dso::Measurement::RISE_TIME:
+    case Dso::Measurement::FALL_TIME:
+    case Dso::Measurement::PERIOD:
+    case Dso::Measurement::POSITIVE_WIDTH:
+    case Dso::Measurement::NEGATIVE_WIDTH:
+        return valueToString(value, UNIT_SECONDS, 4);
+    default:
+        return valueToString(value, UNIT_VOLTS, 4);
+    }
+}
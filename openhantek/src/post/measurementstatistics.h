@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include <QString>
+
+#include "postprocessingsettings.h"
+#include "processor.h"
+
+/// \brief Accumulates the statistics of the measurements across frames.
+/// Runs after the MeasurementProcessor and the SpectrumGenerator, which measures the frequency. Each measurement of
+/// each channel keeps only its running minimum, maximum, mean and sum of squared deviations, so a frame costs a few
+/// operations per measurement, independent of the number of frames so far. The statistics are copied into every
+/// result for the GUI.
+class MeasurementStatistics : public Processor {
+  public:
+    virtual void process(PPresult *result) override;
+
+    /// \brief Restarts the statistics with the next frame, can be called from any thread.
+    void reset() { resetRequested = true; }
+
+    /// \brief Returns a measurement of a channel.
+    /// \param data The analyzed data of the channel.
+    /// \param measurement The measurement.
+    /// \param value The measured value.
+    /// \return false, if the measurement wasn't possible, e.g. the rise time of a signal without edges.
+    static bool value(const DataChannel &data, Dso::Measurement measurement, double &value);
+    /// \brief Formats a value of a measurement with its unit, the ratios in percent.
+    static QString valueString(Dso::Measurement measurement, double value);
+
+  private:
+    std::vector<std::vector<MeasurementStatistic>> channels; ///< The statistics of each channel
+    std::atomic<bool> resetRequested{false};
+};
@@ -0,0 +1,17 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <functional>
+
+#include <QRunnable>
+
+/// \brief Runs a function in a thread pool, the runnable is owned by the caller.
+class PoolTask : public QRunnable {
+  public:
+    explicit PoolTask(std::function<void()> function) : function(std::move(function)) { setAutoDelete(false); }
+    void run() override { function(); }
+
+  private:
+    std::function<void()> function;
+};
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "postprocessing.h"
 
 PostProcessing::PostProcessing(unsigned channelCount) : channelCount(channelCount) {
@@ -6,9 +8,14 @@ PostProcessing::PostProcessing(unsigned channelCount) : channelCount(channelCoun
 
 void PostProcessing::registerProcessor(Processor *processor) { processors.push_back(processor); }
 
-void PostProcessing::convertData(const DSOsamples *source, PPresult *destination) {
+void PostProcessing::convertData(const DSOsamples *source, PPresult *destination, bool codes) {
     QReadLocker locker(&source->lock);
 
+    destination->append = source->append;
+    destination->softwareTriggerTriggered = source->triggered;
+    destination->softwareTriggerOffset = source->triggerOffset;
+    destination->softwareTriggerFraction = source->triggerFraction;
+
     for (ChannelID channel = 0; channel < source->data.size(); ++channel) {
         const std::vector<double> &rawChannelData = source->data.at(channel);
 
@@ -17,12 +24,23 @@ void PostProcessing::convertData(const DSOsamples *source, PPresult *destination
         DataChannel *const channelData = destination->modifyData(channel);
         channelData->voltage.interval = 1.0 / source->samplerate;
         channelData->voltage.sample = rawChannelData;
+        channelData->generation = source->sequence;
+
+        if (codes && channel < source->codes.size()) {
+            SampleCodes &channelCodes = channelData->codes;
+            channelCodes.code = source->codes[channel];
+            channelCodes.bits = source->codeBits;
+            channelCodes.shift = source->codeShift;
+            channelCodes.step = source->codeStep[channel];
+            channelCodes.base = source->codeBase[channel];
+        }
     }
 }
 
 void PostProcessing::input(const DSOsamples *data) {
     currentData.reset(new PPresult(channelCount));
-    convertData(data, currentData.get());
+    const bool codes = std::any_of(processors.begin(), processors.end(), [](Processor *p) { return p->needsCodes(); });
+    convertData(data, currentData.get(), codes);
     for (Processor *p : processors) p->process(currentData.get());
     std::shared_ptr<PPresult> res = std::move(currentData);
     emit processingFinished(res);
@@ -37,7 +37,8 @@ class PostProcessing : public QObject {
     std::vector<Processor *> processors;
     ///
     std::unique_ptr<PPresult> currentData;
-    static void convertData(const DSOsamples *source, PPresult *destination);
+    /// Copies the samples into the result, the raw codes only if `codes` is true.
+    static void convertData(const DSOsamples *source, PPresult *destination, bool codes);
   public slots:
     /**
      * Start processing new data. The actual data may be processed in another thread if you have moved
@@ -5,8 +5,20 @@
 
 namespace Dso {
 
-Enum<Dso::MathMode, Dso::MathMode::ADD_CH1_CH2, Dso::MathMode::SUB_CH1_FROM_CH2> MathModeEnum;
+Enum<Dso::MathMode, Dso::MathMode::ADD_CH1_CH2, Dso::MathMode::EXPRESSION> MathModeEnum;
 Enum<Dso::WindowFunction, Dso::WindowFunction::RECTANGULAR, Dso::WindowFunction::FLATTOP> WindowFunctionEnum;
+Enum<Dso::FrequencyEstimator, Dso::FrequencyEstimator::ZEROCROSSING, Dso::FrequencyEstimator::AUTOCORRELATION>
+    FrequencyEstimatorEnum;
+Enum<Dso::SpectrumAveraging, Dso::SpectrumAveraging::OFF, Dso::SpectrumAveraging::MINHOLD> SpectrumAveragingEnum;
+Enum<Dso::SpectrumLength, Dso::SpectrumLength::RECORD, Dso::SpectrumLength::ZEROPAD> SpectrumLengthEnum;
+Enum<Dso::FilterType, Dso::FilterType::OFF, Dso::FilterType::CUSTOM> FilterTypeEnum;
+Enum<Dso::FilterDesign, Dso::FilterDesign::FIR, Dso::FilterDesign::IIR> FilterDesignEnum;
+Enum<Dso::HistogramMode, Dso::HistogramMode::OFF, Dso::HistogramMode::ACCUMULATE> HistogramModeEnum;
+Enum<Dso::MaskMode, Dso::MaskMode::OFF, Dso::MaskMode::POLYGONS> MaskModeEnum;
+Enum<Dso::MaskAction, Dso::MaskAction::NONE, Dso::MaskAction::SAVE> MaskActionEnum;
+Enum<Dso::Protocol, Dso::Protocol::OFF, Dso::Protocol::I2C> ProtocolEnum;
+Enum<Dso::Parity, Dso::Parity::NONE, Dso::Parity::ODD> ParityEnum;
+Enum<Dso::Measurement, Dso::Measurement::MINIMUM, Dso::Measurement::DUTY_CYCLE> MeasurementEnum;
 
 /// \brief Return string representation of the given math mode.
 /// \param mode The ::MathMode that should be returned as string.
@@ -19,6 +31,8 @@ QString mathModeString(MathMode mode) {
         return QCoreApplication::tr("CH1 - CH2");
     case MathMode::SUB_CH1_FROM_CH2:
         return QCoreApplication::tr("CH2 - CH1");
+    case MathMode::EXPRESSION:
+        return QCoreApplication::tr("Expression");
     }
     return QString();
 }
@@ -60,4 +74,205 @@ QString windowFunctionString(WindowFunction window) {
     }
     return QString();
 }
+
+/// \brief Return string representation of the given frequency estimator.
+/// \param estimator The ::FrequencyEstimator that should be returned as string.
+/// \return The string that should be used in labels etc.
+QString frequencyEstimatorString(FrequencyEstimator estimator) {
+    switch (estimator) {
+    case FrequencyEstimator::ZEROCROSSING:
+        return QCoreApplication::tr("Zero crossings");
+    case FrequencyEstimator::AUTOCORRELATION:
+        return QCoreApplication::tr("Autocorrelation");
+    }
+    return QString();
+}
+
+/// \brief Return string representation of the given spectrum averaging mode.
+/// \param averaging The ::SpectrumAveraging that should be returned as string.
+/// \return The string that should be used in labels etc.
+QString spectrumAveragingString(SpectrumAveraging averaging) {
+    switch (averaging) {
+    case SpectrumAveraging::OFF:
+        return QCoreApplication::tr("Off");
+    case SpectrumAveraging::RMS:
+        return QCoreApplication::tr("RMS");
+    case SpectrumAveraging::EXPONENTIAL:
+        return QCoreApplication::tr("Exponential");
+    case SpectrumAveraging::MAXHOLD:
+        return QCoreApplication::tr("Max hold");
+    case SpectrumAveraging::MINHOLD:
+        return QCoreApplication::tr("Min hold");
+    }
+    return QString();
+}
+
+/// \brief Return string representation of the given spectrum length mode.
+/// \param length The ::SpectrumLength that should be returned as string.
+/// \return The string that should be used in labels etc.
+QString spectrumLengthString(SpectrumLength length) {
+    switch (length) {
+    case SpectrumLength::RECORD:
+        return QCoreApplication::tr("Record length");
+    case SpectrumLength::TRUNCATE:
+        return QCoreApplication::tr("Truncate to fast length");
+    case SpectrumLength::ZEROPAD:
+        return QCoreApplication::tr("Zero-pad to fast length");
+    }
+    return QString();
+}
+
+/// \brief Return string representation of the given filter type.
+/// \param type The ::FilterType that should be returned as string.
+/// \return The string that should be used in labels etc.
+QString filterTypeString(FilterType type) {
+    switch (type) {
+    case FilterType::OFF:
+        return QCoreApplication::tr("Off");
+    case FilterType::LOWPASS:
+        return QCoreApplication::tr("Low-pass");
+    case FilterType::HIGHPASS:
+        return QCoreApplication::tr("High-pass");
+    case FilterType::BANDPASS:
+        return QCoreApplication::tr("Band-pass");
+    case FilterType::CUSTOM:
+        return QCoreApplication::tr("Custom taps");
+    }
+    return QString();
+}
+
+/// \brief Return string representation of the given filter design.
+/// \param design The ::FilterDesign that should be returned as string.
+/// \return The string that should be used in labels etc.
+QString filterDesignString(FilterDesign design) {
+    switch (design) {
+    case FilterDesign::FIR:
+        return QCoreApplication::tr("FIR (windowed sinc)");
+    case FilterDesign::IIR:
+        return QCoreApplication::tr("IIR (Butterworth)");
+    }
+    return QString();
+}
+
+/// \brief Return string representation of the given histogram mode.
+/// \param mode The ::HistogramMode that should be returned as string.
+/// \return The string that should be used in labels etc.
+QString histogramModeString(HistogramMode mode) {
+    switch (mode) {
+    case HistogramMode::OFF:
+        return QCoreApplication::tr("Off");
+    case HistogramMode::FRAME:
+        return QCoreApplication::tr("Current frame");
+    case HistogramMode::ACCUMULATE:
+        return QCoreApplication::tr("Accumulated");
+    }
+    return QString();
+}
+
+/// \brief Return string representation of the given mask mode.
+/// \param mode The ::MaskMode that should be returned as string.
+/// \return The string that should be used in labels etc.
+QString maskModeString(MaskMode mode) {
+    switch (mode) {
+    case MaskMode::OFF:
+        return QCoreApplication::tr("Off");
+    case MaskMode::GOLDEN:
+        return QCoreApplication::tr("Golden waveform");
+    case MaskMode::POLYGONS:
+        return QCoreApplication::tr("Polygons");
+    }
+    return QString();
+}
+
+/// \brief Return string representation of the given mask action.
+/// \param action The ::MaskAction that should be returned as string.
+/// \return The string that should be used in labels etc.
+QString maskActionString(MaskAction action) {
+    switch (action) {
+    case MaskAction::NONE:
+        return QCoreApplication::tr("Count only");
+    case MaskAction::STOP:
+        return QCoreApplication::tr("Stop");
+    case MaskAction::SAVE:
+        return QCoreApplication::tr("Save the frame");
+    }
+    return QString();
+}
+
+/// \brief Return string representation of the given protocol.
+/// \param protocol The ::Protocol that should be returned as string.
+/// \return The string that should be used in labels etc.
+QString protocolString(Protocol protocol) {
+    switch (protocol) {
+    case Protocol::OFF:
+        return QCoreApplication::tr("Off");
+    case Protocol::UART:
+        return QCoreApplication::tr("UART");
+    case Protocol::SPI:
+        return QCoreApplication::tr("SPI");
+    case Protocol::I2C:
+        return QCoreApplication::tr("I2C");
+    }
+    return QString();
+}
+
+/// \brief Return string representation of the given parity.
+/// \param parity The ::Parity that should be returned as string.
+/// \return The string that should be used in labels etc.
+QString parityString(Parity parity) {
+    switch (parity) {
+    case Parity::NONE:
+        return QCoreApplication::tr("None");
+    case Parity::EVEN:
+        return QCoreApplication::tr("Even");
+    case Parity::ODD:
+        return QCoreApplication::tr("Odd");
+    }
+    return QString();
+}
+
+/// \brief Return string representation of the given measurement.
+/// \param measurement The ::Measurement that should be returned as string.
+/// \return The string that should be used in labels etc.
+QString measurementString(Measurement measurement) {
+    switch (measurement) {
+    case Measurement::MINIMUM:
+        return QCoreApplication::tr("Minimum");
+    case Measurement::MAXIMUM:
+        return QCoreApplication::tr("Maximum");
+    case Measurement::PEAK_TO_PEAK:
+        return QCoreApplication::tr("Peak-to-peak");
+    case Measurement::MEAN:
+        return QCoreApplication::tr("Mean");
+    case Measurement::RMS:
+        return QCoreApplication::tr("RMS");
+    case Measurement::AC_RMS:
+        return QCoreApplication::tr("AC RMS");
+    case Measurement::TOP:
+        return QCoreApplication::tr("Top");
+    case Measurement::BASE:
+        return QCoreApplication::tr("Base");
+    case Measurement::AMPLITUDE:
+        return QCoreApplication::tr("Amplitude");
+    case Measurement::OVERSHOOT:
+        return QCoreApplication::tr("Overshoot");
+    case Measurement::UNDERSHOOT:
+        return QCoreApplication::tr("Undershoot");
+    case Measurement::RISE_TIME:
+        return QCoreApplication::tr("Rise time");
+    case Measurement::FALL_TIME:
+        return QCoreApplication::tr("Fall time");
+    case Measurement::FREQUENCY:
+        return QCoreApplication::tr("Frequency");
+    case Measurement::PERIOD:
+        return QCoreApplication::tr("Period");
+    case Measurement::POSITIVE_WIDTH:
+        return QCoreApplication::tr("Positive width");
+    case Measurement::NEGATIVE_WIDTH:
+        return QCoreApplication::tr("Negative width");
+    case Measurement::DUTY_CYCLE:
+        return QCoreApplication::tr("Duty cycle");
+    }
+    return QString();
+}
 }
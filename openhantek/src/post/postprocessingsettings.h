@@ -2,12 +2,15 @@
 
 #include "utils/enumclass.h"
 #include <QMetaType>
+#include <QString>
+#include <vector>
 namespace Dso {
 
 /// \enum MathMode
 /// \brief The different math modes for the math-channel.
-enum class MathMode : unsigned { ADD_CH1_CH2, SUB_CH2_FROM_CH1, SUB_CH1_FROM_CH2 };
-extern Enum<Dso::MathMode, Dso::MathMode::ADD_CH1_CH2, Dso::MathMode::SUB_CH1_FROM_CH2> MathModeEnum;
+/// EXPRESSION evaluates the free-form expression of the channel, see MathExpression.
+enum class MathMode : unsigned { ADD_CH1_CH2, SUB_CH2_FROM_CH1, SUB_CH1_FROM_CH2, EXPRESSION };
+extern Enum<Dso::MathMode, Dso::MathMode::ADD_CH1_CH2, Dso::MathMode::EXPRESSION> MathModeEnum;
 
 template<class T>
 inline MathMode getMathMode(T& t) { return (MathMode)t.couplingOrMathIndex; }
@@ -35,15 +38,241 @@ enum class WindowFunction : int {
 };
 extern Enum<Dso::WindowFunction, Dso::WindowFunction::RECTANGULAR, Dso::WindowFunction::FLATTOP> WindowFunctionEnum;
 
+/// \enum FrequencyEstimator
+/// \brief The algorithms that measure the signal frequency.
+enum class FrequencyEstimator : int {
+    ZEROCROSSING,   ///< Averaged period between rising crossings with hysteresis, O(n)
+    AUTOCORRELATION ///< Peak of the autocorrelation, needs two FFTs per channel
+};
+extern Enum<Dso::FrequencyEstimator, Dso::FrequencyEstimator::ZEROCROSSING, Dso::FrequencyEstimator::AUTOCORRELATION>
+    FrequencyEstimatorEnum;
+
+/// \enum SpectrumAveraging
+/// \brief The averaging modes for the spectrum.
+/// All modes work on the power of each frequency bin.
+enum class SpectrumAveraging : int {
+    OFF,         ///< Every frame is shown as it is
+    RMS,         ///< Linear average of the last count frames
+    EXPONENTIAL, ///< Exponential average with a weight of 1/count for each new frame
+    MAXHOLD,     ///< Maximum of all frames
+    MINHOLD      ///< Minimum of all frames
+};
+extern Enum<Dso::SpectrumAveraging, Dso::SpectrumAveraging::OFF, Dso::SpectrumAveraging::MINHOLD>
+    SpectrumAveragingEnum;
+
+/// \enum SpectrumLength
+/// \brief How the record is fitted to the length of the transformation.
+enum class SpectrumLength : int {
+    RECORD,   ///< The whole record is transformed, regardless of its prime factors
+    TRUNCATE, ///< The record is shortened to the next fast length
+    ZEROPAD   ///< The record is padded with zeros to the next fast length
+};
+extern Enum<Dso::SpectrumLength, Dso::SpectrumLength::RECORD, Dso::SpectrumLength::ZEROPAD> SpectrumLengthEnum;
+
+/// \enum FilterType
+/// \brief The filters that can be applied to a channel.
+enum class FilterType : int {
+    OFF,      ///< The samples are not filtered
+    LOWPASS,  ///< Passes the frequencies below the lower cutoff
+    HIGHPASS, ///< Passes the frequencies above the lower cutoff
+    BANDPASS, ///< Passes the frequencies between the lower and the upper cutoff
+    CUSTOM    ///< FIR filter with the taps given by the user
+};
+extern Enum<Dso::FilterType, Dso::FilterType::OFF, Dso::FilterType::CUSTOM> FilterTypeEnum;
+
+/// \enum FilterDesign
+/// \brief How the low-, high- and band-pass filters are realized.
+enum class FilterDesign : int {
+    FIR, ///< Windowed-sinc FIR filter with linear phase, the delay is compensated
+    IIR  ///< Butterworth IIR filter as a cascade of biquads, needs far less operations
+};
+extern Enum<Dso::FilterDesign, Dso::FilterDesign::FIR, Dso::FilterDesign::IIR> FilterDesignEnum;
+
+/// \enum HistogramMode
+/// \brief The amplitude histogram of the ADC codes.
+enum class HistogramMode : int {
+    OFF,       ///< No histogram
+    FRAME,     ///< The histogram of the current frame
+    ACCUMULATE ///< The histogram of all frames since the last reset or a change of the gain or offset
+};
+extern Enum<Dso::HistogramMode, Dso::HistogramMode::OFF, Dso::HistogramMode::ACCUMULATE> HistogramModeEnum;
+
+/// \enum MaskMode
+/// \brief Where the limits of the mask test come from.
+enum class MaskMode : int {
+    OFF,     ///< No mask test
+    GOLDEN,  ///< The captured golden waveform plus or minus a tolerance
+    POLYGONS ///< Forbidden regions given as polygons on the screen
+};
+extern Enum<Dso::MaskMode, Dso::MaskMode::OFF, Dso::MaskMode::POLYGONS> MaskModeEnum;
+
+/// \enum MaskAction
+/// \brief What happens when a frame violates the mask.
+enum class MaskAction : int {
+    NONE, ///< The failure is only counted
+    STOP, ///< The acquisition stops
+    SAVE  ///< The frame is saved as CSV file
+};
+extern Enum<Dso::MaskAction, Dso::MaskAction::NONE, Dso::MaskAction::SAVE> MaskActionEnum;
+
+/// \enum Protocol
+/// \brief The serial protocol that is decoded from the thresholded channels.
+enum class Protocol : int {
+    OFF,  ///< No decoder
+    UART, ///< Asynchronous serial data on one channel
+    SPI,  ///< Clock and data, without chip select
+    I2C   ///< SCL and SDA
+};
+extern Enum<Dso::Protocol, Dso::Protocol::OFF, Dso::Protocol::I2C> ProtocolEnum;
+
+/// \enum Parity
+/// \brief The parity bit of an UART word.
+enum class Parity : int {
+    NONE, ///< No parity bit
+    EVEN, ///< The number of ones including the parity bit is even
+    ODD   ///< The number of ones including the parity bit is odd
+};
+extern Enum<Dso::Parity, Dso::Parity::NONE, Dso::Parity::ODD> ParityEnum;
+
+/// \enum Measurement
+/// \brief The automatic measurements, their statistics are accumulated across frames.
+enum class Measurement : int {
+    MINIMUM,        ///< Lowest sample (V)
+    MAXIMUM,        ///< Highest sample (V)
+    PEAK_TO_PEAK,   ///< Maximum - minimum (V)
+    MEAN,           ///< Average of the samples (V)
+    RMS,            ///< Root mean square (V)
+    AC_RMS,         ///< Root mean square without the mean (V)
+    TOP,            ///< Most common high level (V)
+    BASE,           ///< Most common low level (V)
+    AMPLITUDE,      ///< Top - base (V)
+    OVERSHOOT,      ///< Maximum above the top relative to the amplitude
+    UNDERSHOOT,     ///< Minimum below the base relative to the amplitude
+    RISE_TIME,      ///< 10 % to 90 % (s)
+    FALL_TIME,      ///< 90 % to 10 % (s)
+    FREQUENCY,      ///< The frequency of the estimator of the spectrum settings (Hz)
+    PERIOD,         ///< Between rising crossings of 50 % (s)
+    POSITIVE_WIDTH, ///< Rising to falling crossing of 50 % (s)
+    NEGATIVE_WIDTH, ///< Falling to rising crossing of 50 % (s)
+    DUTY_CYCLE      ///< Positive width relative to the period
+};
+extern Enum<Dso::Measurement, Dso::Measurement::MINIMUM, Dso::Measurement::DUTY_CYCLE> MeasurementEnum;
+const unsigned MEASUREMENT_COUNT = (unsigned)Measurement::DUTY_CYCLE + 1;
+/// \brief Returns the bit of a measurement in a mask of measurements.
+inline unsigned measurementBit(Measurement measurement) { return 1u << (unsigned)measurement; }
+
 QString mathModeString(MathMode mode);
 QString windowFunctionString(WindowFunction window);
+QString frequencyEstimatorString(FrequencyEstimator estimator);
+QString spectrumAveragingString(SpectrumAveraging averaging);
+QString spectrumLengthString(SpectrumLength length);
+QString filterTypeString(FilterType type);
+QString filterDesignString(FilterDesign design);
+QString histogramModeString(HistogramMode mode);
+QString maskModeString(MaskMode mode);
+QString maskActionString(MaskAction action);
+QString protocolString(Protocol protocol);
+QString parityString(Parity parity);
+QString measurementString(Measurement measurement);
+
+/// \brief Return the label of a math channel, the expression itself in the EXPRESSION mode.
+template <class T> inline QString mathChannelString(const T &t) {
+    return getMathMode(t) == MathMode::EXPRESSION ? t.mathExpression : mathModeString(getMathMode(t));
+}
 }
 
 Q_DECLARE_METATYPE(Dso::MathMode)
 Q_DECLARE_METATYPE(Dso::WindowFunction)
+Q_DECLARE_METATYPE(Dso::FrequencyEstimator)
+Q_DECLARE_METATYPE(Dso::SpectrumAveraging)
+Q_DECLARE_METATYPE(Dso::SpectrumLength)
+Q_DECLARE_METATYPE(Dso::FilterType)
+Q_DECLARE_METATYPE(Dso::FilterDesign)
+Q_DECLARE_METATYPE(Dso::HistogramMode)
+Q_DECLARE_METATYPE(Dso::MaskMode)
+Q_DECLARE_METATYPE(Dso::MaskAction)
+Q_DECLARE_METATYPE(Dso::Protocol)
+Q_DECLARE_METATYPE(Dso::Parity)
+
+/// \brief The filter of a physical channel.
+struct DsoSettingsFilter {
+    Dso::FilterType type = Dso::FilterType::OFF;
+    Dso::FilterDesign design = Dso::FilterDesign::FIR;
+    double low = 1e3;     ///< Cutoff of the low- and high-pass, lower edge of the band-pass (Hz)
+    double high = 10e3;   ///< Upper edge of the band-pass (Hz)
+    unsigned taps = 101;  ///< Length of the FIR filter, odd
+    unsigned order = 4;   ///< Order of the IIR filter at each edge, even
+    QString coefficients; ///< Taps of the custom FIR filter, separated by commas or spaces
+};
+
+/// \brief The measurements that are recorded for the long-term trend.
+struct DsoSettingsDatalogger {
+    bool enabled = false; ///< The measurements of the used voltage channels are logged
+    unsigned measurements = Dso::measurementBit(Dso::Measurement::PEAK_TO_PEAK) |
+                            Dso::measurementBit(Dso::Measurement::RMS) |
+                            Dso::measurementBit(Dso::Measurement::FREQUENCY); ///< Mask of the logged measurements
+    QString file; ///< The 1 s buckets are appended to this file, nothing is written if empty
+};
+
+/// \brief The pass/fail test of a voltage channel against a mask.
+struct DsoSettingsMask {
+    Dso::MaskMode mode = Dso::MaskMode::OFF;
+    unsigned channel = 0;          ///< The tested voltage channel
+    double timeTolerance = 0.1;    ///< Horizontal tolerance around the golden waveform (div)
+    double voltageTolerance = 0.2; ///< Vertical tolerance around the golden waveform (div)
+    QString polygons; ///< Forbidden regions on the screen in div, "x,y x,y x,y" with a semicolon between polygons
+    Dso::MaskAction action = Dso::MaskAction::NONE;
+    QString folder;                    ///< The failing frames are saved here
+    std::vector<double> goldenMinimum; ///< Lowest level of the golden waveform in each of its columns (V)
+    std::vector<double> goldenMaximum; ///< Highest level of the golden waveform in each of its columns (V)
+    double goldenTimebase = 0.0;       ///< The timebase the golden waveform was captured at (s/div)
+};
+
+/// \brief The eye diagram of a voltage channel.
+struct DsoSettingsEye {
+    bool enabled = false;       ///< The eye is accumulated while its dock is shown
+    unsigned channel = 0;       ///< The folded voltage channel
+    bool recoverBitRate = true; ///< The bit rate is recovered from the crossings of the signal
+    double bitRate = 1e6;       ///< The configured bit rate (Hz)
+    unsigned unitIntervals = 2; ///< Shown unit intervals, 1 or 2
+    unsigned persistence = 0;   ///< Frames until the old hits fade, a power of two, 0 keeps all hits
+};
+
+/// \brief The serial protocol decoder.
+/// The data channel is the UART line, the SPI data line or SDA, the clock channel is the SPI clock or SCL.
+struct DsoSettingsDecoder {
+    Dso::Protocol protocol = Dso::Protocol::OFF;
+    unsigned dataChannel = 0;       ///< The voltage channel with the data
+    unsigned clockChannel = 1;      ///< The voltage channel with the clock, unused for UART
+    bool automaticThreshold = true; ///< The threshold lies in the middle between top and base of each channel
+    double threshold = 1.4;         ///< The fixed threshold (V)
+    unsigned baudRate = 9600;       ///< UART symbols per second
+    unsigned dataBits = 8;          ///< UART data bits, 5 to 9
+    Dso::Parity parity = Dso::Parity::NONE;
+    unsigned stopBits = 1;          ///< UART stop bits, 1 or 2
+    bool uartInverted = false;      ///< The UART line idles low
+    bool spiRisingEdge = true;      ///< SPI data is sampled at the rising clock edge
+    bool spiMsbFirst = true;        ///< SPI words start with the most significant bit
+    unsigned spiWordBits = 8;       ///< Bits of a SPI word, 4 to 32
+};
 
 struct DsoSettingsPostProcessing {
     Dso::WindowFunction spectrumWindow = Dso::WindowFunction::HANN; ///< Window function for DFT
     double spectrumReference = 0.0;                                 ///< Reference level for spectrum in dBm
     double spectrumLimit = -20.0; ///< Minimum magnitude of the spectrum (Avoids peaks)
+    Dso::SpectrumLength spectrumLength = Dso::SpectrumLength::RECORD; ///< Fitting of the record to the FFT length
+    unsigned spectrumThreadThreshold = 0; ///< Minimum length of multithreaded FFTs, 0 for the tuned length
+    unsigned spectrumSegment = 0; ///< Segment length of the Welch method, 0 transforms the whole record at once
+    double spectrumOverlap = 0.5; ///< Overlap of the Welch segments (0 <= overlap < 1)
+    bool spectrumZoom = false;    ///< Zoom-FFT of the band between the markers
+    Dso::SpectrumAveraging spectrumAveraging = Dso::SpectrumAveraging::OFF; ///< Averaging of the spectrum frames
+    unsigned spectrumAverages = 8; ///< Number of frames for the RMS and exponential averaging
+    Dso::FrequencyEstimator frequencyEstimator = Dso::FrequencyEstimator::ZEROCROSSING; ///< Frequency measurement
+    unsigned harmonics = 10; ///< Highest harmonic of the distortion measurement, 0 turns the measurement off
+    std::vector<DsoSettingsFilter> filter; ///< Filter of each physical channel
+    Dso::HistogramMode histogram = Dso::HistogramMode::OFF; ///< Amplitude histogram of the physical channels
+    DsoSettingsDatalogger datalogger;      ///< Long-term recording of the measurements
+    DsoSettingsMask mask;                  ///< Pass/fail test of every frame
+    DsoSettingsEye eye;                    ///< Eye diagram of a serial signal
+    DsoSettingsDecoder decoder;            ///< Serial protocol decoder
 };
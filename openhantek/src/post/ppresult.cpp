@@ -2,6 +2,7 @@
 
 #include "ppresult.h"
 #include <QDebug>
+#include <cmath>
 #include <stdexcept>
 
 PPresult::PPresult(unsigned int channelCount) { analyzedData.resize(channelCount); }
@@ -18,17 +19,20 @@ unsigned int PPresult::sampleCount() const { return (unsigned)analyzedData[0].vo
 
 unsigned int PPresult::channelCount() const { return (unsigned)analyzedData.size(); }
 
-double DataChannel::computeAmplitude() const {
-    if (voltage.sample.empty()) return 0.0;
-    double minimalVoltage, maximalVoltage;
-    minimalVoltage = maximalVoltage = voltage.sample[0];
-
-    for (unsigned int position = 1; position < voltage.sample.size(); ++position) {
-        if (voltage.sample[position] < minimalVoltage)
-            minimalVoltage = voltage.sample[position];
-        else if (voltage.sample[position] > maximalVoltage)
-            maximalVoltage = voltage.sample[position];
+void MeasurementStatistic::add(double value) {
+    ++count;
+    if (count == 1) {
+        minimum = maximum = mean = value;
+        sumOfSquares = 0.0;
+        return;
     }
+    if (value < minimum) minimum = value;
+    if (value > maximum) maximum = value;
+    const double delta = value - mean;
+    mean += delta / (double)count;
+    sumOfSquares += delta * (value - mean);
+}
 
-    return maximalVoltage - minimalVoltage;
+double MeasurementStatistic::deviation() const {
+    return count > 1 ? std::sqrt(sumOfSquares / (double)(count - 1)) : 0.0;
 }
@@ -12,20 +12,143 @@
 struct SampleValues {
     std::vector<double> sample; ///< Vector holding the sampling data
     double interval = 0.0;      ///< The interval between two sample values
+    double start = 0.0;         ///< The position of the first sample value, the lower band edge of a zoomed spectrum
+};
+
+/// \brief Struct for the raw ADC codes of a physical channel.
+struct SampleCodes {
+    std::vector<short> code; ///< The codes as read from the device, empty for math channels
+    unsigned bits = 8;       ///< Resolution of the ADC
+    int shift = 0;           ///< Added to a code to get its position above the lowest code
+    double step = 0.0;       ///< Voltage of one code step (V)
+    double base = 0.0;       ///< Voltage of the lowest code (V)
+};
+
+/// \brief Struct for the amplitude histogram of a physical channel.
+/// There is one bin for each ADC code, bin i holds the samples with the voltage base + i * step.
+struct AmplitudeHistogram {
+    std::vector<unsigned long long> count; ///< Samples in each bin, empty if there is no histogram
+    unsigned long long total = 0;          ///< Samples in all bins
+    unsigned frames = 0;                   ///< Number of accumulated frames
+    double step = 0.0;                     ///< Voltage of one bin (V)
+    double base = 0.0;                     ///< Voltage of the first bin (V)
+};
+
+/// \brief Struct for the harmonic distortion and noise measurements of a channel.
+struct HarmonicAnalysis {
+    bool valid = false;            ///< false, if there was no spectrum or no fundamental
+    double fundamental = 0.0;      ///< Interpolated frequency of the fundamental (Hz)
+    double amplitude = 0.0;        ///< RMS value of the fundamental (V)
+    std::vector<double> harmonics; ///< Level of the harmonics 2, 3, ... relative to the fundamental (dBc)
+    double thd = 0.0;              ///< Total harmonic distortion (dB)
+    double thdN = 0.0;             ///< Total harmonic distortion plus noise (dB)
+    double snr = 0.0;              ///< Signal to noise ratio (dB)
+    double sinad = 0.0;            ///< Signal to noise and distortion ratio (dB)
+    double enob = 0.0;             ///< Effective number of bits
+};
+
+/// \brief Struct for the voltage and timing measurements of a channel.
+/// The levels of the timing measurements are relative to top and base, the times are averaged over all complete
+/// edges and periods of the record and are 0 if there was none.
+struct Measurements {
+    bool valid = false;          ///< false, if the channel had no samples
+    double minimum = 0.0;        ///< Lowest sample (V)
+    double maximum = 0.0;        ///< Highest sample (V)
+    double peakToPeak = 0.0;     ///< maximum - minimum (V)
+    double mean = 0.0;           ///< Average of the samples (V)
+    double rms = 0.0;            ///< Root mean square (V)
+    double acRms = 0.0;          ///< Root mean square without the mean, the standard deviation (V)
+    double top = 0.0;            ///< Most common high level, the maximum if there is none (V)
+    double base = 0.0;           ///< Most common low level, the minimum if there is none (V)
+    double amplitude = 0.0;      ///< top - base (V)
+    double overshoot = 0.0;      ///< (maximum - top) / amplitude
+    double undershoot = 0.0;     ///< (base - minimum) / amplitude
+    double riseTime = 0.0;       ///< From 10 % to 90 % of the amplitude (s)
+    double fallTime = 0.0;       ///< From 90 % to 10 % of the amplitude (s)
+    double period = 0.0;         ///< Between two rising crossings of 50 % (s)
+    double positiveWidth = 0.0;  ///< From a rising to the next falling crossing of 50 % (s)
+    double negativeWidth = 0.0;  ///< From a falling to the next rising crossing of 50 % (s)
+    double dutyCycle = 0.0;      ///< positiveWidth / period
+};
+
+/// \brief Running statistics of one measurement across frames.
+/// Updated by Welford's algorithm, which needs no history and stays accurate for a large count.
+struct MeasurementStatistic {
+    unsigned long long count = 0; ///< Number of frames that had this measurement
+    double minimum = 0.0;
+    double maximum = 0.0;
+    double mean = 0.0;
+    double sumOfSquares = 0.0;    ///< Sum of the squared deviations from the mean
+
+    /// \brief Adds the value of a frame.
+    void add(double value);
+    /// \return The sample standard deviation, 0 for less than two values.
+    double deviation() const;
+};
+
+/// \brief Struct for the result of the mask test.
+struct MaskTestResult {
+    bool tested = false;                 ///< false, if the test is off or the frame could not be tested
+    unsigned long long hits = 0;         ///< Samples of this frame that violate the mask
+    unsigned long long frames = 0;       ///< Tested frames since the last reset
+    unsigned long long failedFrames = 0; ///< Frames with at least one hit since the last reset
+    unsigned long long totalHits = 0;    ///< Hits since the last reset
+};
+
+/// \brief Struct for the eye diagram, the hit density of the folded unit intervals.
+struct EyeDiagram {
+    std::vector<unsigned> density; ///< Hits of each bin, row by row from the bottom of the screen, empty if not shown
+    unsigned columns = 0;          ///< Bins in each row, they cover the unit intervals
+    unsigned rows = 0;             ///< Bins in each column, they cover the screen height
+    unsigned maximum = 0;          ///< The highest count of a bin
+    unsigned unitIntervals = 1;    ///< Number of shown unit intervals
+    unsigned channel = 0;          ///< The folded voltage channel
+    unsigned frames = 0;           ///< Accumulated frames
+    double unitInterval = 0.0;     ///< The bit period (s)
+    bool measured = false;         ///< false, if there are not enough hits for the measurements
+    double height = 0.0;           ///< (Top - 3 sigma) - (base + 3 sigma) in the center of the eye (V)
+    double width = 0.0;            ///< Unit interval - 6 sigma of the crossing times (s)
+    double jitterRms = 0.0;        ///< Standard deviation of the crossing times (s)
+    double jitterPeakToPeak = 0.0; ///< Span of the crossing times (s)
+};
+
+/// \brief A word or a bus condition found by the protocol decoder.
+struct DecodedPacket {
+    enum class Type { DATA, ADDRESS, START, STOP };
+    Type type = Type::DATA;
+    double start = 0.0;        ///< Begin of the first bit relative to the left edge of the screen (s)
+    double end = 0.0;          ///< End of the last bit relative to the left edge of the screen (s)
+    unsigned value = 0;        ///< The data word, the 7 bit address of an I2C address
+    bool read = false;         ///< An I2C address with the read bit
+    bool acknowledged = false; ///< The I2C receiver acknowledged the word
+    bool error = false;        ///< Wrong UART parity or stop bit, an incomplete SPI word
+};
+
+/// \brief The result of the protocol decoder.
+struct ProtocolDecode {
+    bool decoded = false;               ///< false, if the decoder is off
+    bool acknowledges = false;          ///< The words have an acknowledge bit, for I2C
+    std::vector<DecodedPacket> packets; ///< Sorted by time, in roll mode with the packets of the previous frames
 };
 
 /// \brief Struct for the analyzed data.
 struct DataChannel {
     SampleValues voltage;   ///< The time-domain voltage levels (V)
     SampleValues spectrum;  ///< The frequency-domain power levels (dB)
+    SampleCodes codes;      ///< The raw ADC codes the voltage was converted from
+    AmplitudeHistogram histogram; ///< Distribution of the ADC codes
+    HarmonicAnalysis harmonics; ///< Distortion and noise of the signal
+    Measurements measurements;  ///< Levels and timing of the signal
+    std::vector<MeasurementStatistic> statistics; ///< Of each measurement since the last reset, see Dso::Measurement
+    unsigned spectrumSamples = 0; ///< Windowed samples per transformation, less than its length if zero-padded
+    unsigned long long generation = 0; ///< Identifies the voltage samples for cached results, 0 if not reusable
 
     double frequency = 0.0; ///< The frequency of the signal
-    // Calculate peak-to-peak voltage
-    double computeAmplitude() const;
 };
 
 typedef std::vector<QVector3D> ChannelGraph;
 typedef std::vector<ChannelGraph> ChannelsGraphs;
+typedef std::vector<unsigned char> SpectrogramRow;
 
 /// Post processing results
 class PPresult {
@@ -42,10 +165,19 @@ class PPresult {
     unsigned int sampleCount() const;
     unsigned int channelCount() const;
 
+    bool append = false;                    ///< true, if the samples continue the previous record (roll mode)
     bool softwareTriggerTriggered = false;
+    unsigned softwareTriggerOffset = 0;     ///< Index of the first sample to display, set by the software trigger
+    double softwareTriggerFraction = 0.0;   ///< Sub-sample distance between the crossing and the first sample
+    MaskTestResult maskTest;                ///< Pass/fail test of the frame
+    EyeDiagram eye;                         ///< Accumulated eye diagram
+    ProtocolDecode decode;                  ///< Packets of the serial protocol decoder
 
     ChannelsGraphs vaChannelSpectrum;
     ChannelsGraphs vaChannelVoltage;
+    ChannelsGraphs vaChannelHistogram; ///< Histogram overlay at the left edge of the screen
+    ChannelGraph vaMask;               ///< Outline of the mask, pairs of vertices for GL_LINES
+    std::vector<SpectrogramRow> spectrogramRows; ///< Newest spectrogram row of each channel, empty if not shown
   private:
     std::vector<DataChannel> analyzedData; ///< The analyzed data for each channel
 };
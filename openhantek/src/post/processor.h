@@ -5,4 +5,6 @@
 class Processor {
 public:
     virtual void process(PPresult*) = 0;
+    /// \return true, if the processor reads the raw ADC codes, otherwise they are not copied into the result.
+    virtual bool needsCodes() const { return false; }
 };
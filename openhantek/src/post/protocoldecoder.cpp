@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include "protocoldecoder.h"
+
+namespace {
+/// Hysteresis of the thresholds relative to the amplitude of the channel.
+const double HYSTERESIS = 0.1;
+/// Packets kept in roll mode.
+const size_t MAX_PACKETS = 10000;
+
+/// \return true, if a decoder has to restart with these settings.
+bool changed(const DsoSettingsDecoder &a, const DsoSettingsDecoder &b) {
+    return a.protocol != b.protocol || a.dataChannel != b.dataChannel || a.clockChannel != b.clockChannel ||
+           a.automaticThreshold != b.automaticThreshold || a.threshold != b.threshold || a.baudRate != b.baudRate ||
+           a.dataBits != b.dataBits || a.parity != b.parity || a.stopBits != b.stopBits ||
+           a.uartInverted != b.uartInverted || a.spiRisingEdge != b.spiRisingEdge ||
+           a.spiMsbFirst != b.spiMsbFirst || a.spiWordBits != b.spiWordBits;
+}
+} // namespace
+
+ProtocolDecoder::ProtocolDecoder(const DsoSettingsPostProcessing *postprocessing) : postprocessing(postprocessing) {}
+
+void ProtocolDecoder::threshold(const DataChannel *channelData, BitStream &stream, bool append) const {
+    const Measurements &measurements = channelData->measurements;
+    double level = postprocessing->decoder.threshold;
+    double hysteresis = 0.0;
+    if (measurements.valid) {
+        if (postprocessing->decoder.automaticThreshold) level = (measurements.top + measurements.base) / 2;
+        hysteresis = measurements.amplitude * HYSTERESIS / 2;
+    }
+    stream.threshold(channelData->voltage.sample, level - hysteresis, level + hysteresis, append);
+}
+
+void ProtocolDecoder::process(PPresult *result) {
+    const DsoSettingsDecoder &settings = postprocessing->decoder;
+    const bool usesClock = settings.protocol != Dso::Protocol::UART;
+    if (settings.protocol == Dso::Protocol::OFF || settings.dataChannel >= result->channelCount() ||
+        (usesClock && settings.clockChannel >= result->channelCount())) {
+        decoded.protocol = Dso::Protocol::OFF;
+        packets.clear();
+        return;
+    }
+    const DataChannel *const dataChannel = result->data(settings.dataChannel);
+    const DataChannel *const clockChannel = usesClock ? result->data(settings.clockChannel) : nullptr;
+    const double interval = dataChannel->voltage.interval;
+    if (dataChannel->voltage.sample.empty() || interval <= 0.0 ||
+        (clockChannel && clockChannel->voltage.sample.empty()))
+        return;
+
+    // Only the samples of the roll mode continue the previous frame
+    const bool append = result->append && !changed(settings, decoded) && interval == decodedInterval;
+    if (!append) {
+        uart.reset();
+        spi.reset();
+        i2c.reset();
+        packets.clear();
+        position = 0.0;
+    }
+    decoded = settings;
+    decodedInterval = interval;
+
+    threshold(dataChannel, data, append);
+    if (clockChannel) threshold(clockChannel, clock, append);
+
+    found.clear();
+    switch (settings.protocol) {
+    case Dso::Protocol::UART:
+        uart.configure(1.0 / (settings.baudRate * interval), settings.dataBits, settings.parity, settings.stopBits,
+                       settings.uartInverted);
+        uart.decode(data, position, found);
+        break;
+    case Dso::Protocol::SPI:
+        spi.configure(settings.spiRisingEdge, settings.spiMsbFirst, settings.spiWordBits);
+        spi.decode(clock, data, position, found);
+        break;
+    case Dso::Protocol::I2C:
+        i2c.decode(clock, data, position, found);
+        break;
+    default:
+        break;
+    }
+    packets.insert(packets.end(), found.begin(), found.end());
+    while (packets.size() > MAX_PACKETS) packets.pop_front();
+
+    // The times are relative to the left edge of the screen, like the graph of the samples
+    const double origin = position + result->softwareTriggerOffset + result->softwareTriggerFraction;
+    result->decode.decoded = true;
+    result->decode.acknowledges = settings.protocol == Dso::Protocol::I2C;
+    result->decode.packets.assign(packets.begin(), packets.end());
+    for (DecodedPacket &packet : result->decode.packets) {
+        packet.start = (packet.start - origin) * interval;
+        packet.end = (packet.end - origin) * interval;
+    }
+    position += data.size();
+}
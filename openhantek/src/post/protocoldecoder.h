@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <deque>
+
+#include "bitstream.h"
+#include "postprocessingsettings.h"
+#include "processor.h"
+#include "serialdecoders.h"
+
+/// \brief Decodes UART, SPI or I2C from the voltage channels.
+/// The channels are thresholded into packed bit streams, the decoders only walk their edges. In roll mode the
+/// decoders continue across the frames and the packets of the previous frames are kept up to a limit, otherwise every
+/// frame is decoded on its own.
+class ProtocolDecoder : public Processor {
+  public:
+    ProtocolDecoder(const DsoSettingsPostProcessing *postprocessing);
+    virtual void process(PPresult *result) override;
+
+  private:
+    /// \brief Thresholds a channel with the automatic or the fixed threshold.
+    void threshold(const DataChannel *channelData, BitStream &stream, bool append) const;
+
+    const DsoSettingsPostProcessing *postprocessing;
+
+    DsoSettingsDecoder decoded; ///< The settings of the previous frame
+    double decodedInterval = 0.0;
+
+    BitStream data;
+    BitStream clock;
+    UartDecoder uart;
+    SpiDecoder spi;
+    I2cDecoder i2c;
+
+    double position = 0.0;             ///< Position of the first sample of the next frame since the restart
+    std::vector<DecodedPacket> found;  ///< The packets of the current frame
+    std::deque<DecodedPacket> packets; ///< The kept packets, their start and end are positions
+};
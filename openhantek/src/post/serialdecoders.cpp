@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+
+#include "serialdecoders.h"
+
+namespace {
+/// A pause of the SPI clock longer than this many bits ends a word.
+const double SPI_WORD_GAP = 4.0;
+
+DecodedPacket packet(DecodedPacket::Type type, double start, double end, unsigned value = 0) {
+    DecodedPacket result;
+    result.type = type;
+    result.start = start;
+    result.end = end;
+    result.value = value;
+    return result;
+}
+} // namespace
+
+void UartDecoder::configure(double bitLength, unsigned dataBits, Dso::Parity parity, unsigned stopBits,
+                            bool inverted) {
+    this->bitLength = bitLength;
+    this->dataBits = dataBits;
+    this->parity = parity;
+    this->stopBits = stopBits;
+    this->inverted = inverted;
+}
+
+void UartDecoder::reset() {
+    receiving = false;
+    idle = 0.0;
+}
+
+void UartDecoder::decode(const BitStream &line, double position, std::vector<DecodedPacket> &packets) {
+    const std::vector<size_t> &edges = line.edges();
+    const double end = position + line.size();
+    const unsigned parityBits = parity == Dso::Parity::NONE ? 0 : 1;
+    const unsigned totalBits = 1 + dataBits + parityBits + stopBits;
+    // The start bit is a low level of the line, a high one if it is inverted
+    const bool startLevel = inverted;
+    size_t edge = 0;
+
+    for (;;) {
+        if (!receiving) {
+            while (edge < edges.size() && (position + edges[edge] < idle || line.bit(edges[edge]) != startLevel))
+                ++edge;
+            if (edge == edges.size()) return;
+            wordStart = position + edges[edge++];
+            receiving = true;
+            bitIndex = 0;
+            value = 0;
+            ones = 0;
+            error = false;
+        }
+
+        // Only the bits whose middle lies in this frame, the others are sampled with the next frame
+        while (bitIndex < totalBits) {
+            const double middle = wordStart + (bitIndex + 0.5) * bitLength;
+            if (middle >= end) return;
+            const bool high = line.bit((size_t)(middle - position)) != inverted;
+            if (bitIndex == 0) {
+                // A start bit that is gone in its middle was a glitch
+                if (high) break;
+            } else if (bitIndex <= dataBits) {
+                value |= (unsigned)high << (bitIndex - 1);
+                ones += high;
+            } else if (bitIndex <= dataBits + parityBits) {
+                ones += high;
+            } else if (!high) {
+                error = true; // Framing error, the stop bit is missing
+            }
+            ++bitIndex;
+        }
+        receiving = false;
+        if (bitIndex < totalBits) {
+            idle = wordStart + 0.5 * bitLength;
+            continue;
+        }
+
+        if (parity == Dso::Parity::EVEN && (ones & 1)) error = true;
+        if (parity == Dso::Parity::ODD && !(ones & 1)) error = true;
+        DecodedPacket word = packet(DecodedPacket::Type::DATA, wordStart, wordStart + totalBits * bitLength, value);
+        word.error = error;
+        packets.push_back(word);
+        // The next start bit may follow the middle of the first stop bit
+        idle = wordStart + (1 + dataBits + parityBits + 0.5) * bitLength;
+    }
+}
+
+void SpiDecoder::configure(bool risingEdge, bool msbFirst, unsigned wordBits) {
+    this->risingEdge = risingEdge;
+    this->msbFirst = msbFirst;
+    this->wordBits = wordBits;
+}
+
+void SpiDecoder::reset() {
+    bits = 0;
+    value = 0;
+    bitPeriod = 0.0;
+}
+
+void SpiDecoder::decode(const BitStream &clock, const BitStream &data, double position,
+                        std::vector<DecodedPacket> &packets) {
+    for (size_t edge : clock.edges()) {
+        if (clock.bit(edge) != risingEdge || edge >= data.size()) continue;
+        const double now = position + edge;
+
+        if (bits > 0) {
+            // The clock paused within a word, the word is kept as an incomplete one
+            if (bitPeriod > 0.0 && now - lastEdge > SPI_WORD_GAP * bitPeriod) {
+                DecodedPacket word = packet(DecodedPacket::Type::DATA, wordStart - bitPeriod / 2,
+                                            lastEdge + bitPeriod / 2, value);
+                word.error = true;
+                packets.push_back(word);
+                bits = 0;
+                value = 0;
+            } else {
+                bitPeriod = now - lastEdge;
+            }
+        }
+        if (bits == 0) wordStart = now;
+
+        const unsigned high = data.bit(edge);
+        value = msbFirst ? (value << 1) | high : value | (high << bits);
+        ++bits;
+        lastEdge = now;
+        if (bits == wordBits) {
+            packets.push_back(
+                packet(DecodedPacket::Type::DATA, wordStart - bitPeriod / 2, lastEdge + bitPeriod / 2, value));
+            bits = 0;
+            value = 0;
+        }
+    }
+}
+
+void I2cDecoder::reset() {
+    phase = Phase::IDLE;
+    bits = 0;
+    value = 0;
+}
+
+void I2cDecoder::decode(const BitStream &scl, const BitStream &sda, double position,
+                        std::vector<DecodedPacket> &packets) {
+    const std::vector<size_t> &clockEdges = scl.edges();
+    const std::vector<size_t> &dataEdges = sda.edges();
+    const size_t count = std::min(scl.size(), sda.size());
+    size_t clockEdge = 0, dataEdge = 0;
+
+    // Both edge lists in the order of time, at the same sample the clock edge comes first
+    while (clockEdge < clockEdges.size() || dataEdge < dataEdges.size()) {
+        const bool isClock = dataEdge == dataEdges.size() ||
+                             (clockEdge < clockEdges.size() && clockEdges[clockEdge] <= dataEdges[dataEdge]);
+        const size_t edge = isClock ? clockEdges[clockEdge++] : dataEdges[dataEdge++];
+        if (edge >= count) continue;
+        const double now = position + edge;
+
+        if (!isClock) {
+            // SDA changes while SCL is high only for the conditions
+            if (!scl.bit(edge)) continue;
+            if (!sda.bit(edge)) {
+                packets.push_back(packet(DecodedPacket::Type::START, now, now));
+                phase = Phase::ADDRESS;
+            } else {
+                packets.push_back(packet(DecodedPacket::Type::STOP, now, now));
+                phase = Phase::IDLE;
+            }
+            bits = 0;
+            value = 0;
+            continue;
+        }
+
+        // The data is valid at the rising edge of SCL
+        if (phase == Phase::IDLE || !scl.bit(edge)) continue;
+        if (bits == 0) wordStart = now;
+        const bool high = sda.bit(edge);
+        if (bits < 8) {
+            value = (value << 1) | (unsigned)high;
+            ++bits;
+            continue;
+        }
+
+        DecodedPacket word;
+        if (phase == Phase::ADDRESS) {
+            word = packet(DecodedPacket::Type::ADDRESS, wordStart, now, value >> 1);
+            word.read = value & 1;
+            phase = Phase::DATA;
+        } else {
+            word = packet(DecodedPacket::Type::DATA, wordStart, now, value);
+        }
+        word.acknowledged = !high;
+        packets.push_back(word);
+        bits = 0;
+        value = 0;
+    }
+}
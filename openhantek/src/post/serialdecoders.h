@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <vector>
+
+#include "bitstream.h"
+#include "postprocessingsettings.h"
+#include "ppresult.h"
+
+// The decoders are state machines that walk the edges of the bit streams of a frame. A word that isn't complete at
+// the end of a frame is continued with the next frame, so the caller resets them if the frames are not contiguous.
+// The positions are counted in samples since the last reset, the start and end of the packets are positions too.
+
+/// \brief Decodes asynchronous serial words: a start bit, the data bits starting with the least significant one, an
+/// optional parity bit and the stop bits. The bits are sampled in their middle, timed from the edge of the start bit.
+class UartDecoder {
+  public:
+    /// \param bitLength The length of a bit (samples).
+    void configure(double bitLength, unsigned dataBits, Dso::Parity parity, unsigned stopBits, bool inverted);
+    void reset();
+    /// \param line The thresholded line.
+    /// \param position The position of the first sample of the frame.
+    /// \param packets The found words are appended here.
+    void decode(const BitStream &line, double position, std::vector<DecodedPacket> &packets);
+
+  private:
+    double bitLength = 1.0;
+    unsigned dataBits = 8;
+    Dso::Parity parity = Dso::Parity::NONE;
+    unsigned stopBits = 1;
+    bool inverted = false;
+
+    bool receiving = false;
+    double wordStart = 0.0; ///< The edge of the start bit
+    unsigned bitIndex = 0;  ///< The next sampled bit, 0 is the start bit
+    unsigned value = 0;
+    unsigned ones = 0; ///< The high data and parity bits
+    bool error = false;
+    double idle = 0.0; ///< A start bit can't begin before this position
+};
+
+/// \brief Decodes SPI words from the clock and one data line.
+/// Without a chip select the words are counted from the first clock edge, a pause of the clock longer than a few
+/// bits drops an incomplete word and starts the next one.
+class SpiDecoder {
+  public:
+    void configure(bool risingEdge, bool msbFirst, unsigned wordBits);
+    void reset();
+    /// \param clock The thresholded clock.
+    /// \param data The thresholded data, sampled at the clock edges.
+    /// \param position The position of the first sample of the frame.
+    /// \param packets The found words are appended here.
+    void decode(const BitStream &clock, const BitStream &data, double position, std::vector<DecodedPacket> &packets);
+
+  private:
+    bool risingEdge = true;
+    bool msbFirst = true;
+    unsigned wordBits = 8;
+
+    unsigned bits = 0; ///< The bits of the current word
+    unsigned value = 0;
+    double wordStart = 0.0;
+    double lastEdge = 0.0;
+    double bitPeriod = 0.0; ///< Distance of the last two sampling edges of a word
+};
+
+/// \brief Decodes I2C transfers from SCL and SDA.
+/// A falling SDA while SCL is high is a start condition, a rising SDA a stop condition. The first word after a start
+/// condition is the address, each word is followed by the acknowledge bit.
+class I2cDecoder {
+  public:
+    void reset();
+    /// \param scl The thresholded clock.
+    /// \param sda The thresholded data.
+    /// \param position The position of the first sample of the frame.
+    /// \param packets The found words and conditions are appended here.
+    void decode(const BitStream &scl, const BitStream &sda, double position, std::vector<DecodedPacket> &packets);
+
+  private:
+    enum class Phase { IDLE, ADDRESS, DATA };
+    Phase phase = Phase::IDLE;
+    unsigned bits = 0; ///< The bits of the current word including the acknowledge bit
+    unsigned value = 0;
+    double wordStart = 0.0;
+};
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+#include <cmath>
+
+#include "spectrogramgenerator.h"
+
+#include "scopesettings.h"
+#include "viewconstants.h"
+#include "viewsettings.h"
+
+SpectrogramGenerator::SpectrogramGenerator(const DsoSettingsScope *scope, const DsoSettingsView *view)
+    : scope(scope), view(view) {}
+
+void SpectrogramGenerator::process(PPresult *result) {
+    if (!view->spectrogram) return;
+
+    result->spectrogramRows.resize(scope->spectrum.size());
+    for (ChannelID channel = 0; channel < scope->spectrum.size() && channel < result->channelCount(); ++channel) {
+        const DataChannel *channelData = result->data(channel);
+        if (!scope->spectrum[channel].used || !channelData || channelData->spectrum.sample.empty() ||
+            channelData->spectrum.interval <= 0)
+            continue;
+
+        const SampleValues &spectrum = channelData->spectrum;
+        const long binCount = (long)spectrum.sample.size();
+
+        // Map the visible dB range to 0..255
+        const double magnitude = scope->spectrum[channel].magnitude;
+        const double bottom = (-DIVS_VOLTAGE / 2 - scope->spectrum[channel].offset) * magnitude;
+        const double scale = 255.0 / (DIVS_VOLTAGE * magnitude);
+
+        // Frequency range of one column in bins, the left border of the screen is 0 Hz
+        const double binsPerColumn =
+            DIVS_TIME * scope->horizontal.frequencybase / SPECTROGRAM_COLUMNS / spectrum.interval;
+        const double firstBin = -spectrum.start / spectrum.interval;
+
+        SpectrogramRow &row = result->spectrogramRows[channel];
+        row.assign(SPECTROGRAM_COLUMNS, 0);
+        for (unsigned column = 0; column < SPECTROGRAM_COLUMNS; ++column) {
+            // Every column shows at least one bin, the highest if it covers several
+            const double columnStart = firstBin + column * binsPerColumn;
+            const long first = std::max(0L, (long)std::ceil(columnStart));
+            const long last = std::min(binCount - 1, std::max(first, (long)std::ceil(columnStart + binsPerColumn) - 1));
+            if (first > last) continue;
+
+            const double peak = *std::max_element(spectrum.sample.begin() + first, spectrum.sample.begin() + last + 1);
+            row[column] = (unsigned char)std::min(std::max((peak - bottom) * scale + 0.5, 0.0), 255.0);
+        }
+    }
+}
@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include "processor.h"
+
+struct DsoSettingsScope;
+struct DsoSettingsView;
+
+/// \brief Converts the spectrum of each channel into a row of the spectrogram.
+/// The row covers the frequency range of the screen with a fixed number of columns, each column holds the
+/// highest bin it covers. The magnitude is quantized to 8 bit, 0 is the bottom and 255 the top of the screen.
+/// Runs after the SpectrumAverager, only the newest row is passed on, the history is kept by the display.
+class SpectrogramGenerator : public Processor {
+  public:
+    SpectrogramGenerator(const DsoSettingsScope *scope, const DsoSettingsView *view);
+    virtual void process(PPresult *result) override;
+
+  private:
+    const DsoSettingsScope *scope;
+    const DsoSettingsView *view;
+};
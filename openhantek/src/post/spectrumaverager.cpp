@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+#include <cmath>
+
+#include "spectrumaverager.h"
+
+#include "scopesettings.h"
+
+namespace {
+/// The RMS history of a channel holds at most this many values, long spectra are averaged over fewer frames.
+const size_t MAX_HISTORY_VALUES = 1u << 24;
+
+/// \brief Converts a power value into dB, limited to the given minimum.
+inline double decibel(double power, double offset, double limit) {
+    return std::max(10.0 * log10(power) + offset, limit);
+}
+
+/// \brief Combines each bin of the new frame with the running buffer and writes the dB value back to the frame.
+template <class Combine>
+void combineFrame(std::vector<double> &power, std::vector<double> &spectrum, double offset, double limit,
+                  Combine combine) {
+    for (size_t bin = 0; bin < spectrum.size(); ++bin) {
+        power[bin] = combine(power[bin], spectrum[bin]);
+        spectrum[bin] = decibel(power[bin], offset, limit);
+    }
+}
+
+/// \return The number of frames in the RMS history for spectra with the given number of bins.
+inline unsigned historyDepth(unsigned averages, size_t bins) {
+    return (unsigned)std::max((size_t)1, std::min((size_t)averages, MAX_HISTORY_VALUES / std::max(bins, (size_t)1)));
+}
+} // namespace
+
+SpectrumAverager::SpectrumAverager(const DsoSettingsScope *scope, const DsoSettingsPostProcessing *postprocessing)
+    : scope(scope), postprocessing(postprocessing) {}
+
+void SpectrumAverager::process(PPresult *result) {
+    if (accumulators.size() < result->channelCount()) accumulators.resize(result->channelCount());
+
+    for (ChannelID channel = 0; channel < result->channelCount(); ++channel) {
+        DataChannel *const channelData = result->modifyData(channel);
+        Accumulator &accumulator = accumulators[channel];
+
+        if (channelData->spectrum.sample.empty()) {
+            accumulator.frames = 0;
+            continue;
+        }
+
+        // Restart the averaging if the bins don't describe the same thing anymore
+        const DsoSettingsScopeVoltage &voltage = scope->voltage[channel];
+        if (accumulator.interval != channelData->spectrum.interval ||
+            accumulator.start != channelData->spectrum.start ||
+            accumulator.window != postprocessing->spectrumWindow ||
+            accumulator.averaging != postprocessing->spectrumAveraging ||
+            accumulator.averages != postprocessing->spectrumAverages ||
+            accumulator.gainStepIndex != voltage.gainStepIndex ||
+            accumulator.couplingOrMathIndex != voltage.couplingOrMathIndex) {
+            accumulator.frames = 0;
+            accumulator.interval = channelData->spectrum.interval;
+            accumulator.start = channelData->spectrum.start;
+            accumulator.window = postprocessing->spectrumWindow;
+            accumulator.averaging = postprocessing->spectrumAveraging;
+            accumulator.averages = postprocessing->spectrumAverages;
+            accumulator.gainStepIndex = voltage.gainStepIndex;
+            accumulator.couplingOrMathIndex = voltage.couplingOrMathIndex;
+        }
+
+        accumulate(accumulator, channelData->spectrum.sample);
+    }
+}
+
+void SpectrumAverager::accumulate(Accumulator &accumulator, std::vector<double> &spectrum) const {
+    // dB values relative to the reference level
+    const double offset = 60 - postprocessing->spectrumReference;
+    const double limit = postprocessing->spectrumLimit - postprocessing->spectrumReference;
+
+    // The first frame starts the buffer, assign() reuses its memory
+    if (postprocessing->spectrumAveraging == Dso::SpectrumAveraging::OFF || accumulator.frames == 0 ||
+        accumulator.power.size() != spectrum.size()) {
+        if (postprocessing->spectrumAveraging != Dso::SpectrumAveraging::OFF) {
+            accumulator.power.assign(spectrum.begin(), spectrum.end());
+            accumulator.frames = 1;
+        }
+        if (postprocessing->spectrumAveraging == Dso::SpectrumAveraging::RMS) {
+            const unsigned depth = historyDepth(postprocessing->spectrumAverages, spectrum.size());
+            accumulator.history.assign((size_t)depth * spectrum.size(), 0.0);
+            std::copy(spectrum.begin(), spectrum.end(), accumulator.history.begin());
+            accumulator.next = 1 % depth;
+        } else {
+            std::vector<double>().swap(accumulator.history);
+        }
+        for (double &value : spectrum) value = decibel(value, offset, limit);
+        return;
+    }
+
+    const unsigned averages = std::max(1u, postprocessing->spectrumAverages);
+    accumulator.frames = std::min(accumulator.frames + 1, averages);
+
+    switch (postprocessing->spectrumAveraging) {
+    case Dso::SpectrumAveraging::RMS: {
+        // The new frame replaces the oldest one in the ring and in the running sum
+        const size_t bins = spectrum.size();
+        const unsigned depth = (unsigned)(accumulator.history.size() / bins);
+        accumulator.frames = std::min(accumulator.frames, depth);
+        double *const sum = accumulator.power.data();
+        double *const slot = accumulator.history.data() + (size_t)accumulator.next * bins;
+        const double scale = 1.0 / accumulator.frames;
+        for (size_t bin = 0; bin < bins; ++bin) {
+            sum[bin] += spectrum[bin] - slot[bin];
+            slot[bin] = spectrum[bin];
+            spectrum[bin] = decibel(sum[bin] * scale, offset, limit);
+        }
+        // The sum is built again once per round, rounding errors of the subtractions don't accumulate
+        if (++accumulator.next == depth) {
+            accumulator.next = 0;
+            std::copy(accumulator.history.begin(), accumulator.history.begin() + (long)bins, sum);
+            for (unsigned frame = 1; frame < depth; ++frame) {
+                const double *const values = accumulator.history.data() + (size_t)frame * bins;
+                for (size_t bin = 0; bin < bins; ++bin) sum[bin] += values[bin];
+            }
+        }
+    } break;
+    case Dso::SpectrumAveraging::EXPONENTIAL: {
+        const double weight = 1.0 / averages;
+        combineFrame(accumulator.power, spectrum, offset, limit,
+                     [weight](double average, double power) { return average + (power - average) * weight; });
+    } break;
+    case Dso::SpectrumAveraging::MAXHOLD:
+        combineFrame(accumulator.power, spectrum, offset, limit,
+                     [](double hold, double power) { return std::max(hold, power); });
+        break;
+    case Dso::SpectrumAveraging::MINHOLD:
+        combineFrame(accumulator.power, spectrum, offset, limit,
+                     [](double hold, double power) { return std::min(hold, power); });
+        break;
+    case Dso::SpectrumAveraging::OFF:
+        break;
+    }
+}
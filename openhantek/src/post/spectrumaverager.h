@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "postprocessingsettings.h"
+#include "processor.h"
+
+struct DsoSettingsScope;
+
+/// \brief Averages the power spectrum over several frames and converts it into dB.
+/// Runs after the SpectrumGenerator. Each channel keeps a running buffer of the power per frequency bin, so
+/// a frame costs one pass over the bins and no allocation. The RMS average also keeps the last frames in a ring,
+/// the oldest frame is subtracted from the running sum when a new one is added. The buffers are restarted
+/// whenever a setting that changes the meaning of the bins is modified.
+class SpectrumAverager : public Processor {
+  public:
+    SpectrumAverager(const DsoSettingsScope *scope, const DsoSettingsPostProcessing *postprocessing);
+    virtual void process(PPresult *result) override;
+
+  private:
+    /// \brief The running buffer of one channel and the settings it was started with.
+    struct Accumulator {
+        std::vector<double> power;   ///< Averaged power of each bin, the sum of the history for RMS
+        std::vector<double> history; ///< The last frames of the RMS average, one after the other
+        unsigned next = 0;           ///< Slot of the history that is replaced by the next frame
+        unsigned frames = 0;         ///< Number of frames in the buffer
+
+        double interval = 0.0;
+        double start = 0.0;
+        Dso::WindowFunction window = Dso::WindowFunction::RECTANGULAR;
+        Dso::SpectrumAveraging averaging = Dso::SpectrumAveraging::OFF;
+        unsigned averages = 0;
+        unsigned gainStepIndex = 0;
+        unsigned couplingOrMathIndex = 0;
+    };
+
+    /// \brief Adds a frame to the buffer and replaces the frame with the dB values of the buffer.
+    void accumulate(Accumulator &accumulator, std::vector<double> &spectrum) const;
+
+    const DsoSettingsScope *scope;
+    const DsoSettingsPostProcessing *postprocessing;
+    std::vector<Accumulator> accumulators; ///< One accumulator for each channel
+};
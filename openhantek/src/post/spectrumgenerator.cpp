@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0+
 
 #define _USE_MATH_DEFINES
+#include <algorithm>
 #include <cmath>
 
 #include <QColor>
@@ -9,21 +10,76 @@
 
 #include <fftw3.h>
 
+#include "fftsize.h"
+#include "fftthreads.h"
+#include "frequencyestimator.h"
 #include "spectrumgenerator.h"
+#include "welchestimator.h"
+#include "windowcache.h"
+#include "zoomfft.h"
 
 #include "glscope.h"
 #include "settings.h"
 #include "utils/printutils.h"
+#include "viewconstants.h"
+
+namespace {
+/// \brief Calculates the power of the frequency bins.
+/// \param bins The complex frequency bins.
+/// \param count The number of bins.
+/// \param scale The factor that normalizes the squared magnitudes.
+/// \param target The power values, needs to hold count values.
+void binPower(const fftw_complex *bins, size_t count, double scale, double *target) {
+    for (size_t bin = 0; bin < count; ++bin)
+        target[bin] = (bins[bin][0] * bins[bin][0] + bins[bin][1] * bins[bin][1]) * scale;
+}
+} // namespace
+
+SpectrumGenerator::Transform::~Transform() {
+    if (forward) fftw_destroy_plan(forward);
+    if (inverse) fftw_destroy_plan(inverse);
+    fftw_free(real);
+    fftw_free(bins);
+}
+
+void SpectrumGenerator::Transform::resize(unsigned length, unsigned threads) {
+    if (this->length == length && this->threads == threads) return;
+
+    if (forward) fftw_destroy_plan(forward);
+    if (inverse) fftw_destroy_plan(inverse);
+    inverse = nullptr;
+    fftw_free(real);
+    fftw_free(bins);
+
+    this->length = length;
+    this->threads = threads;
+    real = fftw_alloc_real(length);
+    bins = fftw_alloc_complex(length / 2 + 1);
+    /// \todo Use FFTW_MEASURE to get fastest algorithm
+    FftThreads::Planning planning(threads);
+    forward = fftw_plan_dft_r2c_1d((int)length, real, bins, FFTW_ESTIMATE);
+}
+
+fftw_plan SpectrumGenerator::Transform::inversePlan() {
+    if (!inverse) {
+        FftThreads::Planning planning(threads);
+        inverse = fftw_plan_dft_c2r_1d((int)length, bins, real, FFTW_ESTIMATE);
+    }
+    return inverse;
+}
 
 /// \brief Analyzes the data from the dso.
 SpectrumGenerator::SpectrumGenerator(const DsoSettingsScope *scope, const DsoSettingsPostProcessing *postprocessing)
-    : scope(scope), postprocessing(postprocessing) {}
-
-SpectrumGenerator::~SpectrumGenerator() {
-    if (lastWindowBuffer) fftw_free(lastWindowBuffer);
+    : scope(scope), postprocessing(postprocessing) {
+    // The calling thread transforms segments as well
+    pool.setMaxThreadCount((int)std::max(1u, FftThreads::get()->threadBudget() - 1));
 }
 
 void SpectrumGenerator::process(PPresult *result) {
+    if (transforms.size() < result->channelCount()) transforms.resize(result->channelCount());
+    if (welchEstimators.size() < result->channelCount()) welchEstimators.resize(result->channelCount());
+    if (zoomFfts.size() < result->channelCount()) zoomFfts.resize(result->channelCount());
+
     // Calculate frequencies and spectrums
     for (ChannelID channel = 0; channel < result->channelCount(); ++channel) {
         DataChannel *const channelData = result->modifyData(channel);
@@ -35,193 +91,135 @@ void SpectrumGenerator::process(PPresult *result) {
             continue;
         }
 
-        // Calculate new window
-        size_t sampleCount = channelData->voltage.sample.size();
-        if (!lastWindowBuffer || lastWindow != postprocessing->spectrumWindow || lastRecordLength != sampleCount) {
-            if (lastWindowBuffer) fftw_free(lastWindowBuffer);
-            lastWindowBuffer = fftw_alloc_real(sampleCount);
-            lastRecordLength = (unsigned)sampleCount;
-
-            unsigned int windowEnd = lastRecordLength - 1;
-            lastWindow = postprocessing->spectrumWindow;
-
-            switch (postprocessing->spectrumWindow) {
-            case Dso::WindowFunction::HAMMING:
-                for (unsigned int windowPosition = 0; windowPosition < lastRecordLength; ++windowPosition)
-                    *(lastWindowBuffer + windowPosition) = 0.54 - 0.46 * cos(2.0 * M_PI * windowPosition / windowEnd);
-                break;
-            case Dso::WindowFunction::HANN:
-                for (unsigned int windowPosition = 0; windowPosition < lastRecordLength; ++windowPosition)
-                    *(lastWindowBuffer + windowPosition) = 0.5 * (1.0 - cos(2.0 * M_PI * windowPosition / windowEnd));
-                break;
-            case Dso::WindowFunction::COSINE:
-                for (unsigned int windowPosition = 0; windowPosition < lastRecordLength; ++windowPosition)
-                    *(lastWindowBuffer + windowPosition) = sin(M_PI * windowPosition / windowEnd);
-                break;
-            case Dso::WindowFunction::LANCZOS:
-                for (unsigned int windowPosition = 0; windowPosition < lastRecordLength; ++windowPosition) {
-                    double sincParameter = (2.0 * windowPosition / windowEnd - 1.0) * M_PI;
-                    if (sincParameter == 0)
-                        *(lastWindowBuffer + windowPosition) = 1;
-                    else
-                        *(lastWindowBuffer + windowPosition) = sin(sincParameter) / sincParameter;
-                }
-                break;
-            case Dso::WindowFunction::BARTLETT:
-                for (unsigned int windowPosition = 0; windowPosition < lastRecordLength; ++windowPosition)
-                    *(lastWindowBuffer + windowPosition) =
-                        2.0 / windowEnd * (windowEnd / 2 - std::abs((double)(windowPosition - windowEnd / 2.0)));
-                break;
-            case Dso::WindowFunction::TRIANGULAR:
-                for (unsigned int windowPosition = 0; windowPosition < lastRecordLength; ++windowPosition)
-                    *(lastWindowBuffer + windowPosition) =
-                        2.0 / lastRecordLength *
-                        (lastRecordLength / 2 - std::abs((double)(windowPosition - windowEnd / 2.0)));
-                break;
-            case Dso::WindowFunction::GAUSS: {
-                double sigma = 0.4;
-                for (unsigned int windowPosition = 0; windowPosition < lastRecordLength; ++windowPosition)
-                    *(lastWindowBuffer + windowPosition) =
-                        exp(-0.5 * pow(((windowPosition - windowEnd / 2) / (sigma * windowEnd / 2)), 2));
-            } break;
-            case Dso::WindowFunction::BARTLETTHANN:
-                for (unsigned int windowPosition = 0; windowPosition < lastRecordLength; ++windowPosition)
-                    *(lastWindowBuffer + windowPosition) = 0.62 -
-                                                           0.48 * std::abs((double)(windowPosition / windowEnd - 0.5)) -
-                                                           0.38 * cos(2.0 * M_PI * windowPosition / windowEnd);
-                break;
-            case Dso::WindowFunction::BLACKMAN: {
-                double alpha = 0.16;
-                for (unsigned int windowPosition = 0; windowPosition < lastRecordLength; ++windowPosition)
-                    *(lastWindowBuffer + windowPosition) = (1 - alpha) / 2 -
-                                                           0.5 * cos(2.0 * M_PI * windowPosition / windowEnd) +
-                                                           alpha / 2 * cos(4.0 * M_PI * windowPosition / windowEnd);
-            } break;
-            // case Dso::WindowFunction::WINDOW_KAISER:
-            // TODO WINDOW_KAISER
-            // double alpha = 3.0;
-            // for(unsigned int windowPosition = 0; windowPosition <
-            // lastRecordLength; ++windowPosition)
-            //*(window + windowPosition) = ;
-            // break;
-            case Dso::WindowFunction::NUTTALL:
-                for (unsigned int windowPosition = 0; windowPosition < lastRecordLength; ++windowPosition)
-                    *(lastWindowBuffer + windowPosition) = 0.355768 -
-                                                           0.487396 * cos(2 * M_PI * windowPosition / windowEnd) +
-                                                           0.144232 * cos(4 * M_PI * windowPosition / windowEnd) -
-                                                           0.012604 * cos(6 * M_PI * windowPosition / windowEnd);
-                break;
-            case Dso::WindowFunction::BLACKMANHARRIS:
-                for (unsigned int windowPosition = 0; windowPosition < lastRecordLength; ++windowPosition)
-                    *(lastWindowBuffer + windowPosition) = 0.35875 -
-                                                           0.48829 * cos(2 * M_PI * windowPosition / windowEnd) +
-                                                           0.14128 * cos(4 * M_PI * windowPosition / windowEnd) -
-                                                           0.01168 * cos(6 * M_PI * windowPosition / windowEnd);
-                break;
-            case Dso::WindowFunction::BLACKMANNUTTALL:
-                for (unsigned int windowPosition = 0; windowPosition < lastRecordLength; ++windowPosition)
-                    *(lastWindowBuffer + windowPosition) = 0.3635819 -
-                                                           0.4891775 * cos(2 * M_PI * windowPosition / windowEnd) +
-                                                           0.1365995 * cos(4 * M_PI * windowPosition / windowEnd) -
-                                                           0.0106411 * cos(6 * M_PI * windowPosition / windowEnd);
-                break;
-            case Dso::WindowFunction::FLATTOP:
-                for (unsigned int windowPosition = 0; windowPosition < lastRecordLength; ++windowPosition)
-                    *(lastWindowBuffer + windowPosition) = 1.0 - 1.93 * cos(2 * M_PI * windowPosition / windowEnd) +
-                                                           1.29 * cos(4 * M_PI * windowPosition / windowEnd) -
-                                                           0.388 * cos(6 * M_PI * windowPosition / windowEnd) +
-                                                           0.032 * cos(8 * M_PI * windowPosition / windowEnd);
-                break;
-            default: // Dso::WINDOW_RECTANGULAR
-                for (unsigned int windowPosition = 0; windowPosition < lastRecordLength; ++windowPosition)
-                    *(lastWindowBuffer + windowPosition) = 1.0;
-            }
-        }
-
-        // Set sampling interval
-        channelData->spectrum.interval = 1.0 / channelData->voltage.interval / sampleCount;
-
-        // Number of real/complex samples
-        unsigned int dftLength = sampleCount / 2;
+        // The autocorrelation needs the spectrum, the zero crossing estimator doesn't
+        const bool autocorrelation = postprocessing->frequencyEstimator == Dso::FrequencyEstimator::AUTOCORRELATION;
+        if (!autocorrelation)
+            channelData->frequency =
+                FrequencyEstimator::zeroCrossing(channelData->voltage.sample, channelData->voltage.interval);
 
-        // Reallocate memory for samples if the sample count has changed
-        channelData->spectrum.sample.resize(sampleCount);
+        const bool spectrumUsed = scope->spectrum[channel].used;
+        if (!autocorrelation && !spectrumUsed) {
+            channelData->spectrum.interval = 0;
+            channelData->spectrum.sample.clear();
+            continue;
+        }
 
-        // Create sample buffer and apply window
-        std::unique_ptr<double[]> windowedValues = std::unique_ptr<double[]>(new double[sampleCount]);
+        // The band between the markers is analyzed by the zoom-FFT
+        channelData->spectrum.start = 0.0;
+        bool spectrumDone = false;
+        if (spectrumUsed && postprocessing->spectrumZoom) {
+            if (!zoomFfts[channel]) zoomFfts[channel].reset(new ZoomFft);
+            const double frequencybase = scope->horizontal.frequencybase;
+            const double lowFrequency = (scope->getMarker(0) + DIVS_TIME / 2) * frequencybase;
+            const double highFrequency = (scope->getMarker(1) + DIVS_TIME / 2) * frequencybase;
+            spectrumDone = zoomFfts[channel]->process(
+                channelData->voltage.sample, channelData->voltage.interval, lowFrequency, highFrequency,
+                postprocessing->spectrumWindow, channelData->spectrum.sample, channelData->spectrum.start,
+                channelData->spectrum.interval);
+        }
 
+        // Long and streamed records are split into segments by the Welch method
+        const unsigned segmentLength = postprocessing->spectrumSegment;
+        const bool welch = !spectrumDone && spectrumUsed && segmentLength > 0 &&
+                           (result->append || channelData->voltage.sample.size() >= segmentLength);
+        if (welch) {
+            if (!welchEstimators[channel]) welchEstimators[channel].reset(new WelchEstimator);
+            if (welchEstimators[channel]->process(channelData->voltage.sample, result->append, segmentLength,
+                                                  postprocessing->spectrumOverlap, postprocessing->spectrumWindow,
+                                                  &pool, channelData->spectrum.sample)) {
+                channelData->spectrum.interval = 1.0 / channelData->voltage.interval / segmentLength;
+                channelData->spectrumSamples = segmentLength;
+            } else {
+                // Not enough samples for a single segment yet
+                channelData->spectrum.interval = 0;
+                channelData->spectrum.sample.clear();
+            }
+            spectrumDone = true;
+        } else if (welchEstimators[channel]) {
+            welchEstimators[channel]->reset();
+        }
+        if (spectrumDone && !autocorrelation) continue;
+
+        // Fit the record to a length that has only small prime factors
+        const unsigned recordLength = (unsigned)channelData->voltage.sample.size();
+        unsigned sampleCount = recordLength;
+        unsigned transformLength = recordLength;
+        if (postprocessing->spectrumLength == Dso::SpectrumLength::TRUNCATE)
+            sampleCount = transformLength = FftSize::below(recordLength);
+        else if (postprocessing->spectrumLength == Dso::SpectrumLength::ZEROPAD)
+            transformLength = FftSize::above(recordLength);
+
+        // Get the window, it's only calculated on the first use for this length
+        const std::shared_ptr<const WindowCache::Table> window =
+            WindowCache::get()->table(postprocessing->spectrumWindow, sampleCount);
+        const double *windowValues = window->data();
+
+        // Number of frequency bins, the real to complex transformation only returns the non-redundant half
+        const unsigned int binCount = transformLength / 2 + 1;
+
+        // The buffers and plans are only recreated if the transformation length has changed
+        if (!transforms[channel]) transforms[channel].reset(new Transform);
+        Transform &transform = *transforms[channel];
+        transform.resize(transformLength,
+                         FftThreads::get()->threadsFor(transformLength, postprocessing->spectrumThreadThreshold));
+
+        // Apply window, the padding is zero
+        const double *samples = channelData->voltage.sample.data();
         for (unsigned int position = 0; position < sampleCount; ++position)
-            windowedValues[position] = lastWindowBuffer[position] * channelData->voltage.sample[position];
-
-        {
-            // Do discrete real to half-complex transformation
-            /// \todo Check if record length is multiple of 2
-            /// \todo Reuse plan and use FFTW_MEASURE to get fastest algorithm
-            fftw_plan fftPlan = fftw_plan_r2r_1d(sampleCount, windowedValues.get(),
-                                                 &channelData->spectrum.sample.front(), FFTW_R2HC, FFTW_ESTIMATE);
-            fftw_execute(fftPlan);
-            fftw_destroy_plan(fftPlan);
+            transform.real[position] = windowValues[position] * samples[position];
+        std::fill(transform.real + sampleCount, transform.real + transformLength, 0.0);
+
+        // Do discrete real to complex transformation
+        fftw_execute(transform.forward);
+
+        // Calculate the power spectrum if we want it, the SpectrumAverager converts it into dB.
+        // The magnitude of a tone only depends on the windowed samples, not on the padding.
+        const double dftLength = sampleCount / 2;
+        const double correctionFactor = 1.0 / dftLength / dftLength;
+        if (spectrumUsed && !spectrumDone) {
+            // Set sampling interval, the bins are spaced by the transformation length
+            channelData->spectrum.interval = 1.0 / channelData->voltage.interval / transformLength;
+            channelData->spectrumSamples = sampleCount;
+
+            channelData->spectrum.sample.resize(binCount);
+            binPower(transform.bins, binCount, correctionFactor, channelData->spectrum.sample.data());
+        } else if (!spectrumUsed) {
+            channelData->spectrum.interval = 0;
+            channelData->spectrum.sample.clear();
         }
 
         // Do an autocorrelation to get the frequency of the signal
-        std::unique_ptr<double[]> conjugateComplex = std::move(windowedValues);
-
-        // Real values
-        unsigned int position;
-        double correctionFactor = 1.0 / dftLength / dftLength;
-        conjugateComplex[0] = (channelData->spectrum.sample[0] * channelData->spectrum.sample[0]) * correctionFactor;
-        for (position = 1; position < dftLength; ++position)
-            conjugateComplex[position] =
-                (channelData->spectrum.sample[position] * channelData->spectrum.sample[position] +
-                 channelData->spectrum.sample[sampleCount - position] *
-                     channelData->spectrum.sample[sampleCount - position]) *
-                correctionFactor;
-        // Complex values, all zero for autocorrelation
-        conjugateComplex[dftLength] =
-            (channelData->spectrum.sample[dftLength] * channelData->spectrum.sample[dftLength]) * correctionFactor;
-        for (++position; position < sampleCount; ++position) conjugateComplex[position] = 0;
-
-        // Do half-complex to real inverse transformation
-        std::unique_ptr<double[]> correlation = std::unique_ptr<double[]>(new double[sampleCount]);
-        fftw_plan fftPlan =
-            fftw_plan_r2r_1d(sampleCount, conjugateComplex.get(), correlation.get(), FFTW_HC2R, FFTW_ESTIMATE);
-        fftw_execute(fftPlan);
-        fftw_destroy_plan(fftPlan);
-
-        // Get the frequency from the correlation results
-        double minimumCorrelation = correlation[0];
-        double peakCorrelation = 0;
-        unsigned int peakPosition = 0;
-
-        for (unsigned int position = 1; position < sampleCount / 2; ++position) {
-            if (correlation[position] > peakCorrelation && correlation[position] > minimumCorrelation * 2) {
-                peakCorrelation = correlation[position];
-                peakPosition = position;
-            } else if (correlation[position] < minimumCorrelation)
-                minimumCorrelation = correlation[position];
-        }
-        correlation.reset(nullptr);
-
-        // Calculate the frequency in Hz
-        if (peakPosition)
-            channelData->frequency = 1.0 / (channelData->voltage.interval * peakPosition);
-        else
-            channelData->frequency = 0;
-
-        // Finally calculate the real spectrum if we want it
-        if (scope->spectrum[channel].used) {
-            // Convert values into dB (Relative to the reference level)
-            double offset = 60 - postprocessing->spectrumReference - 20 * log10(dftLength);
-            double offsetLimit = postprocessing->spectrumLimit - postprocessing->spectrumReference;
-            for (std::vector<double>::iterator spectrumIterator = channelData->spectrum.sample.begin();
-                 spectrumIterator != channelData->spectrum.sample.end(); ++spectrumIterator) {
-                double value = 20 * log10(fabs(*spectrumIterator)) + offset;
-
-                // Check if this value has to be limited
-                if (offsetLimit > value) value = offsetLimit;
-
-                *spectrumIterator = value;
+        if (autocorrelation) {
+            // The power spectrum replaces the bins, the imaginary parts are all zero for autocorrelation
+            for (unsigned int bin = 0; bin < binCount; ++bin) {
+                const double re = transform.bins[bin][0];
+                const double im = transform.bins[bin][1];
+                transform.bins[bin][0] = (re * re + im * im) * correctionFactor;
+                transform.bins[bin][1] = 0;
             }
+
+            // Do complex to real inverse transformation
+            fftw_execute(transform.inversePlan());
+            const double *correlation = transform.real;
+
+            // Get the frequency from the correlation results
+            double minimumCorrelation = correlation[0];
+            double peakCorrelation = 0;
+            unsigned int peakPosition = 0;
+
+            for (unsigned int position = 1; position < sampleCount / 2; ++position) {
+                if (correlation[position] > peakCorrelation && correlation[position] > minimumCorrelation * 2) {
+                    peakCorrelation = correlation[position];
+                    peakPosition = position;
+                } else if (correlation[position] < minimumCorrelation)
+                    minimumCorrelation = correlation[position];
+            }
+
+            // Calculate the frequency in Hz
+            if (peakPosition)
+                channelData->frequency = 1.0 / (channelData->voltage.interval * peakPosition);
+            else
+                channelData->frequency = 0;
         }
     }
 }
@@ -6,31 +6,56 @@
 
 #include <QMutex>
 #include <QThread>
+#include <QThreadPool>
 #include <memory>
 
+#include <fftw3.h>
+
 #include "ppresult.h"
 #include "dsosamples.h"
 #include "utils/printutils.h"
 #include "postprocessingsettings.h"
 
 #include "processor.h"
+#include "welchestimator.h"
+#include "zoomfft.h"
 
 class DsoSettings;
 struct DsoSettingsScope;
 
 /// \brief Analyzes the data from the dso.
-/// Calculates the spectrum and various data about the signal and saves the
-/// time-/frequencysteps between two values.
+/// Calculates the power spectrum and various data about the signal and saves the
+/// time-/frequencysteps between two values. The SpectrumAverager converts the spectrum into dB.
 class SpectrumGenerator : public Processor {
   public:
     SpectrumGenerator(const DsoSettingsScope* scope, const DsoSettingsPostProcessing* postprocessing);
-    virtual ~SpectrumGenerator();
     virtual void process(PPresult *data) override;
 
   private:
+    /// \brief FFTW plans and buffers of one channel.
+    /// The buffers are allocated by FFTW to get the alignment its SIMD code needs and are kept, together with
+    /// the plans, as long as the sample count doesn't change.
+    struct Transform {
+        ~Transform();
+        /// \brief Prepares the buffers and the forward plan for the given transformation length.
+        /// \param length The length of the transformation.
+        /// \param threads The number of threads of the plans.
+        void resize(unsigned length, unsigned threads);
+        /// \brief Returns the plan for the inverse transformation, it's only created on the first use.
+        fftw_plan inversePlan();
+
+        unsigned length = 0;          ///< Length of the transformation, can differ from the record length
+        unsigned threads = 1;         ///< Number of threads the plans are created for
+        double *real = nullptr;       ///< Windowed samples, later the autocorrelation
+        fftw_complex *bins = nullptr; ///< length / 2 + 1 frequency bins
+        fftw_plan forward = nullptr;  ///< real -> bins
+        fftw_plan inverse = nullptr;  ///< bins -> real
+    };
+
     const DsoSettingsScope* scope;
     const DsoSettingsPostProcessing* postprocessing;
-    unsigned int lastRecordLength = 0;                        ///< The record length of the previously analyzed data
-    Dso::WindowFunction lastWindow = (Dso::WindowFunction)-1; ///< The previously used dft window function
-    double *lastWindowBuffer = nullptr;
+    std::vector<std::unique_ptr<Transform>> transforms;           ///< One transform for each channel
+    std::vector<std::unique_ptr<WelchEstimator>> welchEstimators; ///< One estimator for each channel
+    std::vector<std::unique_ptr<ZoomFft>> zoomFfts;               ///< One zoom-FFT for each channel
+    QThreadPool pool; ///< Threads for the segments of the Welch method, limited to the FftThreads budget
 };
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+#include <cmath>
+
+#include "trendstore.h"
+
+namespace {
+/// Bucket length and ring length of each level.
+const double LEVEL_WIDTH[TrendStore::LEVELS] = {1.0, 60.0, 3600.0};
+const unsigned LEVEL_CAPACITY[TrendStore::LEVELS] = {2 * 3600, 2 * 24 * 60, 366 * 24};
+} // namespace
+
+double TrendStore::width(unsigned level) { return LEVEL_WIDTH[level]; }
+
+unsigned TrendStore::capacity(unsigned level) { return LEVEL_CAPACITY[level]; }
+
+bool TrendStore::add(unsigned index, double time, double value, Bucket &closed) {
+    QMutexLocker locker(&mutex);
+    if (series.size() <= index) series.resize(index + 1);
+
+    bool completed = false;
+    for (unsigned level = 0; level < LEVELS; ++level) {
+        Ring &ring = series[index].levels[level];
+        const double start = std::floor(time / LEVEL_WIDTH[level]) * LEVEL_WIDTH[level];
+        if (ring.open.count && ring.open.time != start) {
+            if (level == 0) {
+                closed = ring.open;
+                completed = true;
+            }
+            if (ring.buckets.size() < LEVEL_CAPACITY[level]) {
+                ring.buckets.push_back(ring.open);
+            } else {
+                ring.buckets[ring.next] = ring.open;
+                ring.next = (ring.next + 1) % ring.buckets.size();
+            }
+            ring.open.count = 0;
+        }
+        if (ring.open.count == 0) {
+            ring.open.time = start;
+            ring.open.minimum = ring.open.maximum = value;
+            ring.open.sum = 0.0;
+        }
+        ring.open.minimum = std::min(ring.open.minimum, value);
+        ring.open.maximum = std::max(ring.open.maximum, value);
+        ring.open.sum += value;
+        ++ring.open.count;
+    }
+    return completed;
+}
+
+std::vector<TrendStore::Bucket> TrendStore::query(unsigned index, double from, double to, unsigned maxBuckets,
+                                                  unsigned *usedLevel) const {
+    QMutexLocker locker(&mutex);
+    std::vector<Bucket> result;
+    if (index >= series.size() || to <= from) return result;
+
+    // The finest level that is coarse enough, a ring that has wrapped must still reach back to the start
+    unsigned level = 0;
+    for (; level + 1 < LEVELS; ++level) {
+        const Ring &ring = series[index].levels[level];
+        const bool reachesBack = ring.buckets.size() < LEVEL_CAPACITY[level] || ring.at(0).time <= from;
+        if ((to - from) / LEVEL_WIDTH[level] <= maxBuckets && reachesBack) break;
+    }
+    if (usedLevel) *usedLevel = level;
+
+    const Ring &ring = series[index].levels[level];
+    const double width = LEVEL_WIDTH[level];
+    // Binary search for the first bucket that ends after the start of the range
+    size_t first = 0, last = ring.buckets.size();
+    while (first < last) {
+        const size_t middle = (first + last) / 2;
+        if (ring.at(middle).time + width <= from)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+    for (size_t position = first; position < ring.buckets.size() && ring.at(position).time < to; ++position)
+        result.push_back(ring.at(position));
+    if (ring.open.count && ring.open.time < to && ring.open.time + width > from) result.push_back(ring.open);
+    return result;
+}
+
+void TrendStore::clear() {
+    QMutexLocker locker(&mutex);
+    series.clear();
+}
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <vector>
+
+#include <QMutex>
+
+/// \brief Multi-resolution ring store for long-term trends of several series.
+/// Every value is merged into a bucket of 1 s, 1 min and 1 h at once. Each resolution is a ring of a fixed number
+/// of buckets, so the memory stays bounded however long the recording runs: the seconds cover two hours, the
+/// minutes two days and the hours a year. A query reads only the one resolution that fits the requested range.
+/// The store is written by the post processing thread and read by the GUI, all access is locked.
+class TrendStore {
+  public:
+    /// \brief The values of one series within a time interval.
+    struct Bucket {
+        double time = 0.0; ///< Start of the interval (s)
+        double minimum = 0.0;
+        double maximum = 0.0;
+        double sum = 0.0;
+        unsigned count = 0;
+
+        double mean() const { return count ? sum / count : 0.0; }
+    };
+
+    static const unsigned LEVELS = 3;
+
+    /// \return The length of the buckets of a level (s).
+    static double width(unsigned level);
+    /// \return The number of buckets the ring of a level holds.
+    static unsigned capacity(unsigned level);
+
+    /// \brief Adds a value.
+    /// \param series The index of the series.
+    /// \param time The time of the value (s).
+    /// \param value The value.
+    /// \param closed Receives the 1 s bucket that was completed by this value.
+    /// \return true, if a 1 s bucket was completed.
+    bool add(unsigned series, double time, double value, Bucket &closed);
+
+    /// \brief Returns the buckets of a series that overlap a range, oldest first.
+    /// \param series The index of the series.
+    /// \param from The start of the range (s).
+    /// \param to The end of the range (s).
+    /// \param maxBuckets The finest level with at most this number of buckets in the range is used, if it still
+    /// reaches back to the start of the range.
+    /// \param level Receives the level that was used.
+    std::vector<Bucket> query(unsigned series, double from, double to, unsigned maxBuckets,
+                              unsigned *level = nullptr) const;
+
+    /// \brief Removes all series.
+    void clear();
+
+  private:
+    /// \brief The buckets of one level of a series.
+    struct Ring {
+        std::vector<Bucket> buckets; ///< Completed buckets, grows up to the capacity and wraps around
+        size_t next = 0;             ///< The position of the oldest bucket once the ring is full
+        Bucket open;                 ///< The bucket that is still filled, empty if its count is 0
+
+        const Bucket &at(size_t index) const { return buckets[(next + index) % buckets.size()]; }
+    };
+
+    /// \brief All levels of a series.
+    struct Series {
+        Ring levels[LEVELS];
+    };
+
+    mutable QMutex mutex;
+    std::vector<Series> series;
+};
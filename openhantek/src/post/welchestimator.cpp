@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+#include <cmath>
+
+#include <QThreadPool>
+
+#include "pooltask.h"
+#include "welchestimator.h"
+
+namespace {
+/// A thread is only worth starting if it gets at least this number of segments.
+const unsigned MIN_SEGMENTS_PER_THREAD = 4;
+} // namespace
+
+WelchEstimator::~WelchEstimator() {
+    if (plan) fftw_destroy_plan(plan);
+}
+
+WelchEstimator::Worker::~Worker() {
+    fftw_free(real);
+    fftw_free(bins);
+}
+
+void WelchEstimator::reset() {
+    pending.clear();
+    lastPower.clear();
+}
+
+void WelchEstimator::prepare(Dso::WindowFunction window, unsigned workerCount) {
+    this->window = WindowCache::get()->table(window, segmentLength);
+
+    while (workers.size() < workerCount) {
+        std::unique_ptr<Worker> worker(new Worker);
+        worker->real = fftw_alloc_real(segmentLength);
+        worker->bins = fftw_alloc_complex(segmentLength / 2 + 1);
+        worker->power.resize(segmentLength / 2 + 1);
+        workers.push_back(std::move(worker));
+    }
+
+    // All buffers come from fftw_alloc, so the plan can be executed on the buffers of every worker
+    if (!plan) plan = fftw_plan_dft_r2c_1d((int)segmentLength, workers[0]->real, workers[0]->bins, FFTW_ESTIMATE);
+}
+
+void WelchEstimator::transform(Worker &worker, const double *samples, unsigned step, unsigned first,
+                               unsigned last) const {
+    const unsigned binCount = segmentLength / 2 + 1;
+    const double *windowValues = window->data();
+    std::fill(worker.power.begin(), worker.power.end(), 0.0);
+
+    for (unsigned segment = first; segment < last; ++segment) {
+        const double *segmentSamples = samples + (size_t)segment * step;
+        for (unsigned position = 0; position < segmentLength; ++position)
+            worker.real[position] = windowValues[position] * segmentSamples[position];
+
+        fftw_execute_dft_r2c(plan, worker.real, worker.bins);
+
+        for (unsigned bin = 0; bin < binCount; ++bin)
+            worker.power[bin] += worker.bins[bin][0] * worker.bins[bin][0] + worker.bins[bin][1] * worker.bins[bin][1];
+    }
+}
+
+bool WelchEstimator::process(const std::vector<double> &samples, bool append, unsigned segmentLength,
+                             double overlap, Dso::WindowFunction window, QThreadPool *pool,
+                             std::vector<double> &power) {
+    if (segmentLength < 2) return false;
+    if (segmentLength != this->segmentLength) {
+        // The plan and the buffers are only valid for one segment length
+        if (plan) fftw_destroy_plan(plan);
+        plan = nullptr;
+        workers.clear();
+        reset();
+        this->segmentLength = segmentLength;
+    } else if (!append) {
+        reset();
+    }
+
+    // Streamed records continue the samples that are left from the previous one
+    const std::vector<double> *input = &samples;
+    if (append) {
+        pending.insert(pending.end(), samples.begin(), samples.end());
+        input = &pending;
+    }
+
+    const unsigned step =
+        std::max(1u, segmentLength - (unsigned)std::lround(segmentLength * std::min(std::max(overlap, 0.0), 0.99)));
+    const size_t sampleCount = input->size();
+    const unsigned segmentCount =
+        sampleCount < segmentLength ? 0 : (unsigned)((sampleCount - segmentLength) / step + 1);
+
+    if (segmentCount == 0) {
+        if (lastPower.empty()) return false;
+        power = lastPower;
+        return true;
+    }
+
+    // Distribute the segments over the calling thread and the pool
+    const unsigned maxWorkers = (unsigned)std::max(1, pool->maxThreadCount()) + 1;
+    const unsigned workerCount = std::max(1u, std::min(maxWorkers, segmentCount / MIN_SEGMENTS_PER_THREAD));
+    prepare(window, workerCount);
+
+    const double *data = input->data();
+    std::vector<std::unique_ptr<PoolTask>> tasks;
+    for (unsigned worker = 1; worker < workerCount; ++worker) {
+        const unsigned first = segmentCount * worker / workerCount;
+        const unsigned last = segmentCount * (worker + 1) / workerCount;
+        Worker *target = workers[worker].get();
+        tasks.emplace_back(new PoolTask([this, target, data, step, first, last]() {
+            transform(*target, data, step, first, last);
+        }));
+        pool->start(tasks.back().get());
+    }
+    transform(*workers[0], data, step, 0, segmentCount / workerCount);
+    if (!tasks.empty()) pool->waitForDone();
+
+    // Average the segments, scaled like a single transformation of the whole record
+    const unsigned binCount = segmentLength / 2 + 1;
+    const double dftLength = segmentLength / 2;
+    const double scale = 1.0 / dftLength / dftLength / segmentCount;
+    power.resize(binCount);
+    for (unsigned bin = 0; bin < binCount; ++bin) {
+        double sum = workers[0]->power[bin];
+        for (unsigned worker = 1; worker < workerCount; ++worker) sum += workers[worker]->power[bin];
+        power[bin] = sum * scale;
+    }
+
+    if (append) {
+        // Keep the samples of the next segment for the next record
+        pending.erase(pending.begin(), pending.begin() + (size_t)segmentCount * step);
+        lastPower = power;
+    }
+    return true;
+}
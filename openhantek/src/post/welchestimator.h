@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <fftw3.h>
+
+#include "postprocessingsettings.h"
+#include "windowcache.h"
+
+class QThreadPool;
+
+/// \brief Power spectral density by the Welch method.
+/// The record is split into overlapping segments of a fixed length, each segment is windowed and transformed
+/// and the powers of all segments are averaged. This needs far less memory than a transformation of the whole
+/// record, the result has only as many bins as the screen can show and a lower variance.
+///
+/// The segments are distributed over the threads of a pool, every thread sums the powers of its segments in
+/// its own buffer. The plan and the window are kept as long as the segment length doesn't change.
+///
+/// Records that continue the previous one (roll mode) are streamed: samples that don't fill a segment yet are
+/// kept and the segmentation continues with the next record.
+class WelchEstimator {
+  public:
+    ~WelchEstimator();
+
+    /// \brief Calculates the power spectrum of a record.
+    /// \param samples The samples of the record.
+    /// \param append true, if the record continues the previous one.
+    /// \param segmentLength The number of samples per segment.
+    /// \param overlap The overlap of neighbouring segments (0 <= overlap < 1).
+    /// \param window The window function that is applied to each segment.
+    /// \param pool The threads the segments are distributed over.
+    /// \param power The normalized power of segmentLength / 2 + 1 bins.
+    /// \return false, if the samples don't fill a single segment and there is no previous result.
+    bool process(const std::vector<double> &samples, bool append, unsigned segmentLength, double overlap,
+                 Dso::WindowFunction window, QThreadPool *pool, std::vector<double> &power);
+
+    /// \brief Discards the streaming state.
+    void reset();
+
+  private:
+    /// \brief Buffers of one thread.
+    struct Worker {
+        ~Worker();
+        double *real = nullptr;       ///< The windowed segment
+        fftw_complex *bins = nullptr; ///< The transformed segment
+        std::vector<double> power;    ///< Sum of the powers of all segments of this thread
+    };
+
+    /// \brief Prepares the plan, the window and the thread buffers for the current segment length.
+    void prepare(Dso::WindowFunction window, unsigned workerCount);
+
+    /// \brief Transforms the segments [first, last) and adds their powers to the buffer of the worker.
+    void transform(Worker &worker, const double *samples, unsigned step, unsigned first, unsigned last) const;
+
+    unsigned segmentLength = 0;
+    fftw_plan plan = nullptr;
+    std::shared_ptr<const WindowCache::Table> window;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::vector<double> pending;   ///< Streaming, samples that haven't been part of a segment yet
+    std::vector<double> lastPower; ///< Streaming, result of the last record that completed a segment
+};
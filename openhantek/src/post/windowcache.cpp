@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+
+#include <QMutexLocker>
+
+#include "windowcache.h"
+
+namespace {
+/// Number of table entries that are generated side by side. The lanes are rotated independently of each other,
+/// so the loops over them have no dependency between iterations and can be vectorized.
+const unsigned LANES = 64;
+/// The lanes are seeded with exact values again after this number of rotations to bound the rounding error.
+const unsigned RESEED_BLOCKS = 64;
+/// Tables that are not in use anymore are dropped when the cache grows beyond this size.
+const size_t MAX_TABLES = 32;
+
+/// \brief Generates cos(position * angle) and sin(position * angle) for all positions by a rotation recurrence.
+void rotation(double angle, unsigned length, std::vector<double> &cosine, std::vector<double> &sine) {
+    cosine.resize(length);
+    sine.resize(length);
+
+    double laneCos[LANES];
+    double laneSin[LANES];
+    const double stepCos = cos(LANES * angle);
+    const double stepSin = sin(LANES * angle);
+
+    for (unsigned blockStart = 0, block = 0; blockStart < length; blockStart += LANES, ++block) {
+        if (block % RESEED_BLOCKS == 0) {
+            for (unsigned lane = 0; lane < LANES; ++lane) {
+                laneCos[lane] = cos((blockStart + lane) * angle);
+                laneSin[lane] = sin((blockStart + lane) * angle);
+            }
+        }
+
+        const unsigned lanes = std::min(LANES, length - blockStart);
+        for (unsigned lane = 0; lane < lanes; ++lane) {
+            cosine[blockStart + lane] = laneCos[lane];
+            sine[blockStart + lane] = laneSin[lane];
+        }
+
+        // Advance every lane by LANES positions
+        for (unsigned lane = 0; lane < LANES; ++lane) {
+            const double c = laneCos[lane];
+            const double s = laneSin[lane];
+            laneCos[lane] = c * stepCos - s * stepSin;
+            laneSin[lane] = s * stepCos + c * stepSin;
+        }
+    }
+}
+
+/// \brief Fills a generalized cosine window a0 - a1 cos(x) + a2 cos(2x) - a3 cos(3x) + a4 cos(4x).
+/// The harmonics are derived from cos(x) with the Chebyshev recurrence.
+void cosineSum(std::vector<double> &table, const std::vector<double> &cosine, double a0, double a1, double a2 = 0.0,
+               double a3 = 0.0, double a4 = 0.0) {
+    for (size_t position = 0; position < table.size(); ++position) {
+        const double c1 = cosine[position];
+        const double c2 = 2.0 * c1 * c1 - 1.0;
+        const double c3 = 2.0 * c1 * c2 - c1;
+        const double c4 = 2.0 * c1 * c3 - c2;
+        table[position] = a0 - a1 * c1 + a2 * c2 - a3 * c3 + a4 * c4;
+    }
+}
+} // namespace
+
+WindowCache *WindowCache::get() {
+    static WindowCache inst;
+    return &inst;
+}
+
+std::shared_ptr<const WindowCache::Table> WindowCache::table(Dso::WindowFunction window, unsigned length) {
+    const unsigned long long key = ((unsigned long long)(unsigned)window << 32) | length;
+
+    QMutexLocker locker(&mutex);
+    auto existing = tables.find(key);
+    if (existing != tables.end()) return existing->second;
+
+    if (tables.size() >= MAX_TABLES) {
+        for (auto it = tables.begin(); it != tables.end();) {
+            if (it->second.use_count() == 1)
+                it = tables.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    std::shared_ptr<const Table> created = create(window, length);
+    tables[key] = created;
+    return created;
+}
+
+std::shared_ptr<const WindowCache::Table> WindowCache::create(Dso::WindowFunction window, unsigned length) {
+    std::shared_ptr<Table> table = std::make_shared<Table>(length, 1.0);
+    if (length < 2) return table;
+
+    Table &values = *table;
+    const double windowEnd = length - 1;
+    std::vector<double> cosine;
+    std::vector<double> sine;
+
+    switch (window) {
+    case Dso::WindowFunction::HAMMING:
+        rotation(2.0 * M_PI / windowEnd, length, cosine, sine);
+        cosineSum(values, cosine, 0.54, 0.46);
+        break;
+    case Dso::WindowFunction::HANN:
+        rotation(2.0 * M_PI / windowEnd, length, cosine, sine);
+        cosineSum(values, cosine, 0.5, 0.5);
+        break;
+    case Dso::WindowFunction::COSINE:
+        rotation(M_PI / windowEnd, length, cosine, sine);
+        values = sine;
+        break;
+    case Dso::WindowFunction::LANCZOS:
+        // sin((2n/N - 1) pi) == -sin(2 pi n/N)
+        rotation(2.0 * M_PI / windowEnd, length, cosine, sine);
+        for (unsigned position = 0; position < length; ++position) {
+            const double sincParameter = (2.0 * position / windowEnd - 1.0) * M_PI;
+            values[position] = sincParameter == 0 ? 1.0 : -sine[position] / sincParameter;
+        }
+        break;
+    case Dso::WindowFunction::BARTLETT:
+        for (unsigned position = 0; position < length; ++position)
+            values[position] = 2.0 / windowEnd * (windowEnd / 2.0 - std::abs(position - windowEnd / 2.0));
+        break;
+    case Dso::WindowFunction::TRIANGULAR:
+        for (unsigned position = 0; position < length; ++position)
+            values[position] = 2.0 / length * (length / 2.0 - std::abs(position - windowEnd / 2.0));
+        break;
+    case Dso::WindowFunction::GAUSS: {
+        const double sigma = 0.4;
+        for (unsigned position = 0; position < length; ++position) {
+            const double x = (position - windowEnd / 2.0) / (sigma * windowEnd / 2.0);
+            values[position] = exp(-0.5 * x * x);
+        }
+    } break;
+    case Dso::WindowFunction::BARTLETTHANN:
+        rotation(2.0 * M_PI / windowEnd, length, cosine, sine);
+        for (unsigned position = 0; position < length; ++position)
+            values[position] =
+                0.62 - 0.48 * std::abs(position / windowEnd - 0.5) - 0.38 * cosine[position];
+        break;
+    case Dso::WindowFunction::BLACKMAN: {
+        const double alpha = 0.16;
+        rotation(2.0 * M_PI / windowEnd, length, cosine, sine);
+        cosineSum(values, cosine, (1.0 - alpha) / 2.0, 0.5, alpha / 2.0);
+    } break;
+    case Dso::WindowFunction::NUTTALL:
+        rotation(2.0 * M_PI / windowEnd, length, cosine, sine);
+        cosineSum(values, cosine, 0.355768, 0.487396, 0.144232, 0.012604);
+        break;
+    case Dso::WindowFunction::BLACKMANHARRIS:
+        rotation(2.0 * M_PI / windowEnd, length, cosine, sine);
+        cosineSum(values, cosine, 0.35875, 0.48829, 0.14128, 0.01168);
+        break;
+    case Dso::WindowFunction::BLACKMANNUTTALL:
+        rotation(2.0 * M_PI / windowEnd, length, cosine, sine);
+        cosineSum(values, cosine, 0.3635819, 0.4891775, 0.1365995, 0.0106411);
+        break;
+    case Dso::WindowFunction::FLATTOP:
+        rotation(2.0 * M_PI / windowEnd, length, cosine, sine);
+        cosineSum(values, cosine, 1.0, 1.93, 1.29, 0.388, 0.032);
+        break;
+    default: // Dso::WindowFunction::RECTANGULAR
+        break;
+    }
+    return table;
+}
@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <QMutex>
+
+#include "postprocessingsettings.h"
+
+/// \brief Cache of window function tables, shared by all channels and processors.
+/// A table is created on the first request for a (window function, length) pair and never modified afterwards,
+/// so it can be used from several threads at once. The cosine terms are generated by a rotation recurrence
+/// instead of calling cos() for each sample.
+class WindowCache {
+  public:
+    typedef std::vector<double> Table;
+
+    static WindowCache *get();
+
+    /// \brief Returns the table of a window function.
+    /// \param window The window function.
+    /// \param length The number of samples the window is applied to.
+    /// \return The window table with length entries.
+    std::shared_ptr<const Table> table(Dso::WindowFunction window, unsigned length);
+
+  private:
+    /// \brief Calculates the window function table.
+    static std::shared_ptr<const Table> create(Dso::WindowFunction window, unsigned length);
+
+    QMutex mutex;
+    std::unordered_map<unsigned long long, std::shared_ptr<const Table>> tables;
+};
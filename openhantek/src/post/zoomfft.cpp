@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+
+#include "fftsize.h"
+#include "windowcache.h"
+#include "zoomfft.h"
+
+namespace {
+/// Filter taps for each output sample (taps per polyphase branch), sets the steepness of the filter.
+const unsigned TAPS_PER_PHASE = 32;
+/// The decimated samplerate is this factor above the bandwidth to leave room for the filter transition.
+const double OVERSAMPLING = 1.25;
+/// The decimation is reduced if the record wouldn't give at least this number of output samples.
+const unsigned MIN_OUTPUT = 64;
+} // namespace
+
+ZoomFft::~ZoomFft() {
+    if (plan) fftw_destroy_plan(plan);
+    fftw_free(buffer);
+}
+
+void ZoomFft::design() {
+    const unsigned tapCount = TAPS_PER_PHASE * decimation;
+    const double middle = (tapCount - 1) / 2.0;
+    tapsRe.resize(tapCount);
+    tapsIm.resize(tapCount);
+
+    // Blackman windowed sinc low-pass with unity gain at DC
+    double sum = 0.0;
+    for (unsigned tap = 0; tap < tapCount; ++tap) {
+        const double x = tap - middle;
+        const double sinc = x == 0.0 ? 2.0 * cutoff : sin(2.0 * M_PI * cutoff * x) / (M_PI * x);
+        const double phase = 2.0 * M_PI * tap / (tapCount - 1);
+        tapsRe[tap] = sinc * (0.42 - 0.5 * cos(phase) + 0.08 * cos(2.0 * phase));
+        sum += tapsRe[tap];
+    }
+
+    // Mix with the centre frequency, the tap at position t multiplies the input sample at m * D + t
+    for (unsigned tap = 0; tap < tapCount; ++tap) {
+        const double lowPass = tapsRe[tap] / sum;
+        tapsRe[tap] = lowPass * cos(2.0 * M_PI * centre * tap);
+        tapsIm[tap] = -lowPass * sin(2.0 * M_PI * centre * tap);
+    }
+}
+
+bool ZoomFft::process(const std::vector<double> &samples, double interval, double lowFrequency,
+                      double highFrequency, Dso::WindowFunction window, std::vector<double> &power, double &start,
+                      double &binInterval) {
+    if (interval <= 0 || samples.empty()) return false;
+
+    // Band in cycles per sample
+    const double low = std::min(std::max(std::min(lowFrequency, highFrequency) * interval, 0.0), 0.5);
+    const double high = std::min(std::max(std::max(lowFrequency, highFrequency) * interval, 0.0), 0.5);
+    const double bandwidth = high - low;
+    if (bandwidth <= 0.0) return false;
+
+    const size_t sampleCount = samples.size();
+    unsigned decimation = (unsigned)std::min(1.0 / (OVERSAMPLING * bandwidth), 1e9);
+    decimation = std::min(decimation, (unsigned)(sampleCount / (TAPS_PER_PHASE + MIN_OUTPUT)));
+    if (decimation < 2) return false;
+
+    // The filter only has to be designed again if the band or the decimation has changed
+    const double centre = (low + high) / 2.0;
+    const double cutoff = 0.5 / decimation;
+    if (decimation != this->decimation || centre != this->centre || cutoff != this->cutoff) {
+        this->decimation = decimation;
+        this->centre = centre;
+        this->cutoff = cutoff;
+        design();
+    }
+
+    const unsigned tapCount = (unsigned)tapsRe.size();
+    // Only as many outputs are calculated as the next fast transformation length needs
+    const unsigned outputCount = FftSize::below((unsigned)((sampleCount - tapCount) / decimation + 1));
+    if (outputCount != length) {
+        if (plan) fftw_destroy_plan(plan);
+        fftw_free(buffer);
+        length = outputCount;
+        buffer = fftw_alloc_complex(length);
+        plan = fftw_plan_dft_1d((int)length, buffer, buffer, FFTW_FORWARD, FFTW_ESTIMATE);
+    }
+
+    // Filter, decimate and apply the window to the decimated sequence
+    const std::shared_ptr<const WindowCache::Table> windowTable = WindowCache::get()->table(window, length);
+    const double *windowValues = windowTable->data();
+    const double *taps[2] = {tapsRe.data(), tapsIm.data()};
+    for (unsigned output = 0; output < length; ++output) {
+        const double *input = samples.data() + (size_t)output * decimation;
+        double re = 0.0;
+        double im = 0.0;
+        for (unsigned tap = 0; tap < tapCount; ++tap) {
+            re += taps[0][tap] * input[tap];
+            im += taps[1][tap] * input[tap];
+        }
+
+        // Mixer phase of the first sample within the filter
+        const double phase = 2.0 * M_PI * fmod(centre * output * decimation, 1.0);
+        const double c = cos(phase);
+        const double s = -sin(phase);
+        buffer[output][0] = (re * c - im * s) * windowValues[output];
+        buffer[output][1] = (re * s + im * c) * windowValues[output];
+    }
+
+    fftw_execute(plan);
+
+    // Keep the bins within the band, negative offsets to the centre are in the upper half
+    binInterval = 1.0 / (interval * decimation * length);
+    const double binStep = 1.0 / (decimation * (double)length);
+    const int firstBin = (int)std::ceil((low - centre) / binStep);
+    const int lastBin = (int)std::floor((high - centre) / binStep);
+    const double scale = 4.0 / length / length;
+    power.resize((size_t)(lastBin - firstBin + 1));
+    for (int bin = firstBin; bin <= lastBin; ++bin) {
+        const unsigned index = (unsigned)((bin + (int)length) % (int)length);
+        power[bin - firstBin] = (buffer[index][0] * buffer[index][0] + buffer[index][1] * buffer[index][1]) * scale;
+    }
+    start = (centre + firstBin * binStep) / interval;
+    return true;
+}
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <fftw3.h>
+
+#include "postprocessingsettings.h"
+
+/// \brief Zoom-FFT, high resolution spectrum of a narrow frequency band.
+/// The band is mixed down to baseband, low-pass filtered and decimated and only the reduced sequence is
+/// transformed. The mixer is folded into the filter taps and the decimating filter only evaluates the outputs
+/// that are kept (the polyphase form of the filter), so a record costs a fixed number of multiplications per
+/// input sample and a transformation with about as many bins as the band contains.
+class ZoomFft {
+  public:
+    ~ZoomFft();
+
+    /// \brief Calculates the power spectrum of a frequency band.
+    /// \param samples The samples of the record.
+    /// \param interval The time between two samples in seconds.
+    /// \param lowFrequency The lower edge of the band in Hz.
+    /// \param highFrequency The upper edge of the band in Hz.
+    /// \param window The window function that is applied to the decimated sequence.
+    /// \param power The normalized power of the bins within the band.
+    /// \param start The frequency of the first bin in Hz.
+    /// \param binInterval The frequency step between two bins in Hz.
+    /// \return false, if the band is too wide to gain anything or the record is too short.
+    bool process(const std::vector<double> &samples, double interval, double lowFrequency, double highFrequency,
+                 Dso::WindowFunction window, std::vector<double> &power, double &start, double &binInterval);
+
+  private:
+    /// \brief Calculates the band-pass taps for the current decimation, centre and cutoff.
+    void design();
+
+    // Filter
+    unsigned decimation = 0;    ///< Ratio between input and output samplerate
+    double centre = 0.0;        ///< Centre of the band in cycles per sample
+    double cutoff = 0.0;        ///< Cutoff of the low-pass filter in cycles per sample
+    std::vector<double> tapsRe; ///< Real part of the low-pass taps mixed with the centre frequency
+    std::vector<double> tapsIm; ///< Imaginary part of the low-pass taps mixed with the centre frequency
+
+    // Transformation of the decimated sequence
+    unsigned length = 0;
+    fftw_complex *buffer = nullptr;
+    fftw_plan plan = nullptr;
+};
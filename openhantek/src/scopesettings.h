@@ -12,6 +12,7 @@
 
 #define MARKER_COUNT 2 ///< Number of markers
 #define MARKER_STEP (DIVS_TIME / 100.0)
+#define MATH_CHANNELS_MAX 8 ///< Maximum number of math channels
 
 /// \brief Holds the cursor parameters
 struct DsoSettingsScopeCursor {
@@ -36,6 +37,7 @@ struct DsoSettingsScopeHorizontal {
     double timebase = 1e-3;  ///< Timebase in s/div
     double samplerate = 1e6; ///< The samplerate of the oscilloscope in S
     enum SamplerateSource { Samplerrate, Duration } samplerateSource = Samplerrate;
+    unsigned segments = 0; ///< Records per sequence of the segmented acquisition, 0 if disabled
 };
 
 /// \brief Holds the settings for the trigger.
@@ -46,8 +48,11 @@ struct DsoSettingsScopeTrigger {
     Dso::Slope slope = Dso::Slope::Positive;                     ///< Rising or falling edge causes trigger
     unsigned int source = 0;                                     ///< Channel that is used as trigger source
     bool special = false;             ///< true if the trigger source is not a standard channel
-    unsigned swTriggerThreshold = 7;  ///< Software trigger, threshold
-    unsigned swTriggerSampleSet = 11; ///< Software trigger, sample set
+    Dso::TriggerType type = Dso::TriggerType::Edge;                   ///< Signal condition that causes a trigger
+    Dso::TriggerCondition condition = Dso::TriggerCondition::Greater; ///< Comparison of the measured duration
+    double time = 1e-6;                                               ///< Time for width, timeout and slew rate
+    double timeMax = 1e-5;                                            ///< Upper time limit for the range condition
+    double levelSpan = 0.5;                                           ///< Upper level above the trigger level in V
 };
 
 /// \brief Base for DsoSettingsScopeSpectrum and DsoSettingsScopeVoltage
@@ -66,11 +71,12 @@ struct DsoSettingsScopeSpectrum : public DsoSettingsScopeChannel {
 /// \brief Holds the settings for the normal voltage graphs.
 /// TODO Use ControlSettingsVoltage
 struct DsoSettingsScopeVoltage : public DsoSettingsScopeChannel {
-    double offset = 0.0;              ///< Vertical offset in divs
-    double trigger = 0.0;             ///< Trigger level in V
-    unsigned gainStepIndex = 6;       ///< The vertical resolution in V/div (default = 1.0)
-    unsigned couplingOrMathIndex = 0; ///< Different index: coupling for real- and mode for math-channels
-    bool inverted = false;            ///< true if the channel is inverted (mirrored on cross-axis)
+    double offset = 0.0;                ///< Vertical offset in divs
+    double trigger = 0.0;               ///< Trigger level in V
+    unsigned gainStepIndex = 6;         ///< The vertical resolution in V/div (default = 1.0)
+    unsigned couplingOrMathIndex = 0;   ///< Different index: coupling for real- and mode for math-channels
+    bool inverted = false;              ///< true if the channel is inverted (mirrored on cross-axis)
+    QString mathExpression = "CH1*CH2"; ///< Expression of a math-channel in the EXPRESSION mode
 };
 
 /// \brief Holds the settings for the oscilloscope.
@@ -81,9 +87,10 @@ struct DsoSettingsScope {
     std::vector<DsoSettingsScopeVoltage> voltage;                   ///< Settings for the normal graphs
     DsoSettingsScopeHorizontal horizontal;                          ///< Settings for the horizontal axis
     DsoSettingsScopeTrigger trigger;                                ///< Settings for the trigger
+    unsigned mathChannels = 2; ///< Number of math channels, a change is applied on the next start
 
     double gain(unsigned channel) const { return gainSteps[voltage[channel].gainStepIndex]; }
-    bool anyUsed(ChannelID channel) { return voltage[channel].used | spectrum[channel].used; }
+    bool anyUsed(ChannelID channel) const { return voltage[channel].used | spectrum[channel].used; }
 
     Dso::Coupling coupling(ChannelID channel, const Dso::ControlSpecification *deviceSpecification) const {
         return deviceSpecification->couplings[voltage[channel].couplingOrMathIndex];
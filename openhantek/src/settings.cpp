@@ -30,20 +30,33 @@ DsoSettings::DsoSettings(const Dso::ControlSpecification* deviceSpecification) {
         view.print.spectrum.push_back(view.screen.voltage.back().darker());
     }
 
-    DsoSettingsScopeSpectrum newSpectrum;
-    newSpectrum.name = QApplication::tr("SPM");
-    scope.spectrum.push_back(newSpectrum);
+    post.filter.resize(deviceSpecification->channels);
 
-    DsoSettingsScopeVoltage newVoltage;
-    newVoltage.couplingOrMathIndex = (unsigned)Dso::MathMode::ADD_CH1_CH2;
-    newVoltage.name = QApplication::tr("MATH");
-    scope.voltage.push_back(newVoltage);
+    // The math channels follow the physical channels, their number can't change while the program runs
+    scope.mathChannels =
+        qBound(1u, store->value("scope/mathChannels", scope.mathChannels).toUInt(), (unsigned)MATH_CHANNELS_MAX);
+    for (unsigned math = 0; math < scope.mathChannels; ++math) {
+        DsoSettingsScopeSpectrum newSpectrum;
+        newSpectrum.name = QApplication::tr("SPM%1").arg(math + 1);
+        scope.spectrum.push_back(newSpectrum);
 
-    view.screen.voltage.push_back(QColor(0x7f, 0x7f, 0x7f, 0xff));
-    view.screen.spectrum.push_back(view.screen.voltage.back().lighter());
-    view.print.voltage.push_back(view.screen.voltage.back());
-    view.print.spectrum.push_back(view.print.voltage.back().darker());
+        DsoSettingsScopeVoltage newVoltage;
+        newVoltage.couplingOrMathIndex =
+            (unsigned)(math == 0 ? Dso::MathMode::ADD_CH1_CH2 : Dso::MathMode::EXPRESSION);
+        newVoltage.name = QApplication::tr("M%1").arg(math + 1);
+        scope.voltage.push_back(newVoltage);
 
+        // The first math channel is gray, the others get pale colors between the ones of the channels
+        if (math == 0) {
+            view.screen.voltage.push_back(QColor(0x7f, 0x7f, 0x7f, 0xff));
+            view.print.voltage.push_back(view.screen.voltage.back());
+        } else {
+            view.screen.voltage.push_back(QColor::fromHsv((int)(math * 60 + 30) % 360, 0x60, 0xe0));
+            view.print.voltage.push_back(view.screen.voltage.back().darker(120));
+        }
+        view.screen.spectrum.push_back(view.screen.voltage.back().lighter());
+        view.print.spectrum.push_back(view.print.voltage.back().darker());
+    }
 
     load();
 }
@@ -83,6 +96,7 @@ void DsoSettings::load() {
     if (store->contains("timebase")) scope.horizontal.timebase = store->value("timebase").toDouble();
     if (store->contains("recordLength")) scope.horizontal.recordLength = store->value("recordLength").toUInt();
     if (store->contains("samplerate")) scope.horizontal.samplerate = store->value("samplerate").toDouble();
+    if (store->contains("segments")) scope.horizontal.segments = store->value("segments").toUInt();
     if (store->contains("samplerateSet")) scope.horizontal.samplerateSource = (DsoSettingsScopeHorizontal::SamplerateSource)store->value("samplerateSet").toInt();
     store->endGroup();
     // Trigger
@@ -92,6 +106,12 @@ void DsoSettings::load() {
     if (store->contains("slope")) scope.trigger.slope = (Dso::Slope)store->value("slope").toUInt();
     if (store->contains("source")) scope.trigger.source = store->value("source").toUInt();
     if (store->contains("special")) scope.trigger.special = store->value("special").toInt();
+    if (store->contains("type")) scope.trigger.type = (Dso::TriggerType)store->value("type").toUInt();
+    if (store->contains("condition"))
+        scope.trigger.condition = (Dso::TriggerCondition)store->value("condition").toUInt();
+    if (store->contains("time")) scope.trigger.time = store->value("time").toDouble();
+    if (store->contains("timeMax")) scope.trigger.timeMax = store->value("timeMax").toDouble();
+    if (store->contains("levelSpan")) scope.trigger.levelSpan = store->value("levelSpan").toDouble();
     store->endGroup();
     // Spectrum
     for (ChannelID channel = 0; channel < scope.spectrum.size(); ++channel) {
@@ -120,6 +140,8 @@ void DsoSettings::load() {
         if (store->contains("couplingOrMathIndex")) scope.voltage[channel].couplingOrMathIndex =
                 store->value("couplingOrMathIndex").toUInt();
         if (store->contains("inverted")) scope.voltage[channel].inverted = store->value("inverted").toBool();
+        if (store->contains("mathExpression"))
+            scope.voltage[channel].mathExpression = store->value("mathExpression").toString();
         if (store->contains("offset")) scope.voltage[channel].offset = store->value("offset").toDouble();
         if (store->contains("trigger")) scope.voltage[channel].trigger = store->value("trigger").toDouble();
         if (store->contains("used")) scope.voltage[channel].used = store->value("used").toBool();
@@ -143,6 +165,90 @@ void DsoSettings::load() {
         post.spectrumReference = store->value("spectrumReference").toDouble();
     if (store->contains("spectrumWindow"))
         post.spectrumWindow = (Dso::WindowFunction)store->value("spectrumWindow").toInt();
+    if (store->contains("spectrumLength"))
+        post.spectrumLength = (Dso::SpectrumLength)store->value("spectrumLength").toInt();
+    if (store->contains("spectrumThreadThreshold"))
+        post.spectrumThreadThreshold = store->value("spectrumThreadThreshold").toUInt();
+    if (store->contains("spectrumSegment")) post.spectrumSegment = store->value("spectrumSegment").toUInt();
+    if (store->contains("spectrumOverlap"))
+        post.spectrumOverlap = qBound(0.0, store->value("spectrumOverlap").toDouble(), 0.9);
+    if (store->contains("spectrumZoom")) post.spectrumZoom = store->value("spectrumZoom").toBool();
+    if (store->contains("spectrumAveraging"))
+        post.spectrumAveraging = (Dso::SpectrumAveraging)store->value("spectrumAveraging").toInt();
+    if (store->contains("spectrumAverages"))
+        post.spectrumAverages = qMax(1u, store->value("spectrumAverages").toUInt());
+    if (store->contains("frequencyEstimator"))
+        post.frequencyEstimator = (Dso::FrequencyEstimator)store->value("frequencyEstimator").toInt();
+    if (store->contains("harmonics")) post.harmonics = store->value("harmonics").toUInt();
+    if (store->contains("mathChannels"))
+        scope.mathChannels = qBound(1u, store->value("mathChannels").toUInt(), (unsigned)MATH_CHANNELS_MAX);
+    for (ChannelID channel = 0; channel < post.filter.size(); ++channel) {
+        DsoSettingsFilter &filter = post.filter[channel];
+        store->beginGroup(QString("filter%1").arg(channel));
+        if (store->contains("type")) filter.type = (Dso::FilterType)store->value("type").toInt();
+        if (store->contains("design")) filter.design = (Dso::FilterDesign)store->value("design").toInt();
+        if (store->contains("low")) filter.low = store->value("low").toDouble();
+        if (store->contains("high")) filter.high = store->value("high").toDouble();
+        if (store->contains("taps")) filter.taps = qBound(3u, store->value("taps").toUInt(), 4095u) | 1u;
+        if (store->contains("order")) filter.order = qBound(2u, store->value("order").toUInt(), 16u) & ~1u;
+        if (store->contains("coefficients")) filter.coefficients = store->value("coefficients").toString();
+        store->endGroup();
+    }
+    if (store->contains("histogram")) post.histogram = (Dso::HistogramMode)store->value("histogram").toInt();
+    store->beginGroup("datalogger");
+    if (store->contains("enabled")) post.datalogger.enabled = store->value("enabled").toBool();
+    if (store->contains("measurements")) post.datalogger.measurements = store->value("measurements").toUInt();
+    if (store->contains("file")) post.datalogger.file = store->value("file").toString();
+    store->endGroup();
+    store->beginGroup("mask");
+    DsoSettingsMask &mask = post.mask;
+    if (store->contains("mode")) mask.mode = (Dso::MaskMode)store->value("mode").toInt();
+    if (store->contains("channel")) mask.channel = store->value("channel").toUInt();
+    if (store->contains("timeTolerance")) mask.timeTolerance = store->value("timeTolerance").toDouble();
+    if (store->contains("voltageTolerance")) mask.voltageTolerance = store->value("voltageTolerance").toDouble();
+    if (store->contains("polygons")) mask.polygons = store->value("polygons").toString();
+    if (store->contains("action")) mask.action = (Dso::MaskAction)store->value("action").toInt();
+    if (store->contains("folder")) mask.folder = store->value("folder").toString();
+    if (store->contains("goldenTimebase")) mask.goldenTimebase = store->value("goldenTimebase").toDouble();
+    const QVariantList goldenMinimum = store->value("goldenMinimum").toList();
+    const QVariantList goldenMaximum = store->value("goldenMaximum").toList();
+    // A file without a complete golden waveform drops the one of the previous file
+    mask.goldenMinimum.clear();
+    mask.goldenMaximum.clear();
+    if (!goldenMinimum.isEmpty() && goldenMinimum.size() == goldenMaximum.size()) {
+        for (int column = 0; column < goldenMinimum.size(); ++column) {
+            mask.goldenMinimum.push_back(goldenMinimum[column].toDouble());
+            mask.goldenMaximum.push_back(goldenMaximum[column].toDouble());
+        }
+    } else {
+        mask.goldenTimebase = 0.0;
+    }
+    store->endGroup();
+    store->beginGroup("eye");
+    if (store->contains("channel")) post.eye.channel = store->value("channel").toUInt();
+    if (store->contains("recoverBitRate")) post.eye.recoverBitRate = store->value("recoverBitRate").toBool();
+    if (store->contains("bitRate")) post.eye.bitRate = store->value("bitRate").toDouble();
+    if (store->contains("unitIntervals"))
+        post.eye.unitIntervals = qBound(1u, store->value("unitIntervals").toUInt(), 2u);
+    if (store->contains("persistence")) post.eye.persistence = store->value("persistence").toUInt();
+    store->endGroup();
+    store->beginGroup("decoder");
+    DsoSettingsDecoder &decoder = post.decoder;
+    if (store->contains("protocol")) decoder.protocol = (Dso::Protocol)store->value("protocol").toInt();
+    if (store->contains("dataChannel")) decoder.dataChannel = store->value("dataChannel").toUInt();
+    if (store->contains("clockChannel")) decoder.clockChannel = store->value("clockChannel").toUInt();
+    if (store->contains("automaticThreshold"))
+        decoder.automaticThreshold = store->value("automaticThreshold").toBool();
+    if (store->contains("threshold")) decoder.threshold = store->value("threshold").toDouble();
+    if (store->contains("baudRate")) decoder.baudRate = qMax(store->value("baudRate").toUInt(), 1u);
+    if (store->contains("dataBits")) decoder.dataBits = qBound(5u, store->value("dataBits").toUInt(), 9u);
+    if (store->contains("parity")) decoder.parity = (Dso::Parity)store->value("parity").toInt();
+    if (store->contains("stopBits")) decoder.stopBits = qBound(1u, store->value("stopBits").toUInt(), 2u);
+    if (store->contains("uartInverted")) decoder.uartInverted = store->value("uartInverted").toBool();
+    if (store->contains("spiRisingEdge")) decoder.spiRisingEdge = store->value("spiRisingEdge").toBool();
+    if (store->contains("spiMsbFirst")) decoder.spiMsbFirst = store->value("spiMsbFirst").toBool();
+    if (store->contains("spiWordBits")) decoder.spiWordBits = qBound(4u, store->value("spiWordBits").toUInt(), 32u);
+    store->endGroup();
     store->endGroup();
 
     // View
@@ -182,6 +288,7 @@ void DsoSettings::load() {
         view.interpolation = (Dso::InterpolationMode)store->value("interpolation").toInt();
     if (store->contains("screenColorImages")) view.screenColorImages = store->value("screenColorImages").toBool();
     if (store->contains("zoom")) view.zoom = store->value("zoom").toBool();
+    if (store->contains("spectrogram")) view.spectrogram = store->value("spectrogram").toBool();
     if (store->contains("cursorGridPosition"))
         view.cursorGridPosition = (Qt::ToolBarArea)store->value("cursorGridPosition").toUInt();
     if (store->contains("cursorsVisible")) view.cursorsVisible = store->value("cursorsVisible").toBool();
@@ -215,6 +322,7 @@ void DsoSettings::save() {
     store->setValue("recordLength", scope.horizontal.recordLength);
     store->setValue("samplerate", scope.horizontal.samplerate);
     store->setValue("samplerateSet", (int)scope.horizontal.samplerateSource);
+    store->setValue("segments", scope.horizontal.segments);
     store->endGroup();
     // Trigger
     store->beginGroup("trigger");
@@ -223,6 +331,11 @@ void DsoSettings::save() {
     store->setValue("slope", (unsigned)scope.trigger.slope);
     store->setValue("source", scope.trigger.source);
     store->setValue("special", scope.trigger.special);
+    store->setValue("type", (unsigned)scope.trigger.type);
+    store->setValue("condition", (unsigned)scope.trigger.condition);
+    store->setValue("time", scope.trigger.time);
+    store->setValue("timeMax", scope.trigger.timeMax);
+    store->setValue("levelSpan", scope.trigger.levelSpan);
     store->endGroup();
     // Spectrum
     for (ChannelID channel = 0; channel < scope.spectrum.size(); ++channel) {
@@ -248,6 +361,7 @@ void DsoSettings::save() {
         store->setValue("gainStepIndex", scope.voltage[channel].gainStepIndex);
         store->setValue("couplingOrMathIndex", scope.voltage[channel].couplingOrMathIndex);
         store->setValue("inverted", scope.voltage[channel].inverted);
+        store->setValue("mathExpression", scope.voltage[channel].mathExpression);
         store->setValue("offset", scope.voltage[channel].offset);
         store->setValue("trigger", scope.voltage[channel].trigger);
         store->setValue("used", scope.voltage[channel].used);
@@ -268,6 +382,73 @@ void DsoSettings::save() {
     store->setValue("spectrumLimit", post.spectrumLimit);
     store->setValue("spectrumReference", post.spectrumReference);
     store->setValue("spectrumWindow", (int)post.spectrumWindow);
+    store->setValue("spectrumLength", (int)post.spectrumLength);
+    store->setValue("spectrumThreadThreshold", post.spectrumThreadThreshold);
+    store->setValue("spectrumSegment", post.spectrumSegment);
+    store->setValue("spectrumOverlap", post.spectrumOverlap);
+    store->setValue("spectrumZoom", post.spectrumZoom);
+    store->setValue("spectrumAveraging", (int)post.spectrumAveraging);
+    store->setValue("spectrumAverages", post.spectrumAverages);
+    store->setValue("frequencyEstimator", (int)post.frequencyEstimator);
+    store->setValue("harmonics", post.harmonics);
+    store->setValue("mathChannels", scope.mathChannels);
+    for (ChannelID channel = 0; channel < post.filter.size(); ++channel) {
+        const DsoSettingsFilter &filter = post.filter[channel];
+        store->beginGroup(QString("filter%1").arg(channel));
+        store->setValue("type", (int)filter.type);
+        store->setValue("design", (int)filter.design);
+        store->setValue("low", filter.low);
+        store->setValue("high", filter.high);
+        store->setValue("taps", filter.taps);
+        store->setValue("order", filter.order);
+        store->setValue("coefficients", filter.coefficients);
+        store->endGroup();
+    }
+    store->setValue("histogram", (int)post.histogram);
+    store->beginGroup("datalogger");
+    store->setValue("enabled", post.datalogger.enabled);
+    store->setValue("measurements", post.datalogger.measurements);
+    store->setValue("file", post.datalogger.file);
+    store->endGroup();
+    store->beginGroup("mask");
+    store->setValue("mode", (int)post.mask.mode);
+    store->setValue("channel", post.mask.channel);
+    store->setValue("timeTolerance", post.mask.timeTolerance);
+    store->setValue("voltageTolerance", post.mask.voltageTolerance);
+    store->setValue("polygons", post.mask.polygons);
+    store->setValue("action", (int)post.mask.action);
+    store->setValue("folder", post.mask.folder);
+    store->setValue("goldenTimebase", post.mask.goldenTimebase);
+    QVariantList goldenMinimum, goldenMaximum;
+    for (size_t column = 0; column < post.mask.goldenMinimum.size(); ++column) {
+        goldenMinimum.append(post.mask.goldenMinimum[column]);
+        goldenMaximum.append(post.mask.goldenMaximum[column]);
+    }
+    store->setValue("goldenMinimum", goldenMinimum);
+    store->setValue("goldenMaximum", goldenMaximum);
+    store->endGroup();
+    store->beginGroup("eye");
+    store->setValue("channel", post.eye.channel);
+    store->setValue("recoverBitRate", post.eye.recoverBitRate);
+    store->setValue("bitRate", post.eye.bitRate);
+    store->setValue("unitIntervals", post.eye.unitIntervals);
+    store->setValue("persistence", post.eye.persistence);
+    store->endGroup();
+    store->beginGroup("decoder");
+    store->setValue("protocol", (int)post.decoder.protocol);
+    store->setValue("dataChannel", post.decoder.dataChannel);
+    store->setValue("clockChannel", post.decoder.clockChannel);
+    store->setValue("automaticThreshold", post.decoder.automaticThreshold);
+    store->setValue("threshold", post.decoder.threshold);
+    store->setValue("baudRate", post.decoder.baudRate);
+    store->setValue("dataBits", post.decoder.dataBits);
+    store->setValue("parity", (int)post.decoder.parity);
+    store->setValue("stopBits", post.decoder.stopBits);
+    store->setValue("uartInverted", post.decoder.uartInverted);
+    store->setValue("spiRisingEdge", post.decoder.spiRisingEdge);
+    store->setValue("spiMsbFirst", post.decoder.spiMsbFirst);
+    store->setValue("spiWordBits", post.decoder.spiWordBits);
+    store->endGroup();
     store->endGroup();
 
     // View
@@ -304,6 +485,7 @@ void DsoSettings::save() {
     store->setValue("interpolation", view.interpolation);
     store->setValue("screenColorImages", view.screenColorImages);
     store->setValue("zoom", view.zoom);
+    store->setValue("spectrogram", view.spectrogram);
     store->setValue("cursorGridPosition", view.cursorGridPosition);
     store->setValue("cursorsVisible", view.cursorsVisible);
     store->endGroup();
@@ -5,3 +5,5 @@
 #define DIVS_TIME 10.0f   ///< Number of horizontal screen divs
 #define DIVS_VOLTAGE 8.0f ///< Number of vertical screen divs
 #define DIVS_SUB 5       ///< Number of sub-divisions per div
+#define SPECTROGRAM_COLUMNS 512 ///< Horizontal resolution of the spectrogram
+#define SPECTROGRAM_ROWS 256    ///< Number of spectrums shown by the spectrogram
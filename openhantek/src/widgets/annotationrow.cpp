@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+
+#include <QPainter>
+#include <QPolygonF>
+
+#include "annotationrow.h"
+#include "viewconstants.h"
+
+AnnotationRow::AnnotationRow(const DsoSettingsScope *scope, const DsoSettingsColorValues *colors, QWidget *parent)
+    : QWidget(parent), scope(scope), colors(colors) {
+    setFixedHeight(fontMetrics().height() + 6);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+}
+
+void AnnotationRow::setData(const ProtocolDecode &decode) {
+    packets = decode.packets;
+    acknowledges = decode.acknowledges;
+    update();
+}
+
+void AnnotationRow::paintEvent(QPaintEvent *) {
+    QPainter painter(this);
+    painter.fillRect(rect(), colors->background);
+    const double screenTime = scope->horizontal.timebase * DIVS_TIME;
+    if (packets.empty() || screenTime <= 0.0) return;
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    const double top = 2.0, bottom = height() - 2.0, middle = height() / 2.0;
+    auto x = [&](double time) { return time / screenTime * width(); };
+
+    for (const DecodedPacket &packet : packets) {
+        const double left = x(packet.start), right = x(packet.end);
+        if (right < 0.0 || left > width()) continue;
+        painter.setPen(packet.error ? QColor(Qt::red) : colors->text);
+
+        if (packet.type == DecodedPacket::Type::START || packet.type == DecodedPacket::Type::STOP) {
+            painter.drawLine(QPointF(left, top), QPointF(left, bottom));
+            const QString mark = packet.type == DecodedPacket::Type::START ? "S" : "P";
+            painter.drawText(QRectF(left + 2.0, 0, fontMetrics().size(0, mark).width() + 2.0, height()),
+                             Qt::AlignVCenter, mark);
+            continue;
+        }
+
+        // A word is a box with pointed ends, like on a logic analyzer
+        const double tip = std::min(3.0, (right - left) / 2);
+        QPolygonF box;
+        box << QPointF(left, middle) << QPointF(left + tip, top) << QPointF(right - tip, top) << QPointF(right, middle)
+            << QPointF(right - tip, bottom) << QPointF(left + tip, bottom);
+        painter.drawPolygon(box);
+
+        QString text = QString("%1").arg(packet.value, 2, 16, QChar('0')).toUpper();
+        if (packet.type == DecodedPacket::Type::ADDRESS) text += packet.read ? " R" : " W";
+        if (acknowledges && !packet.acknowledged) text += " N";
+        const QRectF textRect(left + tip, 0, right - left - 2 * tip, height());
+        if (fontMetrics().size(0, text).width() <= textRect.width()) painter.drawText(textRect, Qt::AlignCenter, text);
+    }
+}
@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <vector>
+
+#include <QWidget>
+
+#include "post/ppresult.h"
+#include "scopesettings.h"
+#include "viewsettings.h"
+
+/// \brief Shows the packets of the protocol decoder in a row below the scope screen.
+/// The row has the width of the screen, so each word is drawn below its bits. Words are boxes with their value in
+/// hex, start and stop conditions are marks. Errors are drawn red, a missing I2C acknowledge is marked N.
+class AnnotationRow : public QWidget {
+    Q_OBJECT
+
+  public:
+    /// \param scope The scope settings, for the timebase.
+    /// \param colors The colors of the background and the text.
+    AnnotationRow(const DsoSettingsScope *scope, const DsoSettingsColorValues *colors, QWidget *parent = nullptr);
+
+    /// \brief Shows the packets of a frame.
+    void setData(const ProtocolDecode &decode);
+
+  protected:
+    void paintEvent(QPaintEvent *event) override;
+
+  private:
+    const DsoSettingsScope *scope;
+    const DsoSettingsColorValues *colors;
+    std::vector<DecodedPacket> packets;
+    bool acknowledges = false; ///< A missing acknowledge is shown
+};
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <cmath>
+
+#include <QPainter>
+
+#include "eyeplot.h"
+#include "utils/printutils.h"
+
+EyePlot::EyePlot(const DsoSettingsColorValues *colors, QWidget *parent) : QWidget(parent), colors(colors) {
+    setMinimumSize(200, 150);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+}
+
+void EyePlot::setData(const EyeDiagram &eye, QColor color) {
+    unitIntervals = eye.unitIntervals;
+    if (eye.density.empty() || !eye.maximum) {
+        image = QImage();
+        text.clear();
+        update();
+        return;
+    }
+
+    // A table maps the logarithm of the count to the color between background and channel color
+    QRgb palette[256];
+    const QColor background = colors->background;
+    for (int index = 0; index < 256; ++index) {
+        const double weight = index ? 0.15 + 0.85 * index / 255.0 : 0.0;
+        palette[index] = qRgb((int)(background.red() + (color.red() - background.red()) * weight),
+                              (int)(background.green() + (color.green() - background.green()) * weight),
+                              (int)(background.blue() + (color.blue() - background.blue()) * weight));
+    }
+    const double scale = 255.0 / std::log1p((double)eye.maximum);
+
+    if (image.width() != (int)eye.columns || image.height() != (int)eye.rows)
+        image = QImage((int)eye.columns, (int)eye.rows, QImage::Format_RGB32);
+    // The density starts at the bottom of the screen, the image at the top
+    for (unsigned row = 0; row < eye.rows; ++row) {
+        const unsigned *counts = eye.density.data() + (size_t)row * eye.columns;
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine((int)(eye.rows - 1 - row)));
+        for (unsigned column = 0; column < eye.columns; ++column)
+            line[column] = palette[counts[column] ? (int)(std::log1p((double)counts[column]) * scale) : 0];
+    }
+
+    text = tr("%1 frames, UI %2").arg(eye.frames).arg(valueToString(eye.unitInterval, UNIT_SECONDS, 4));
+    if (eye.measured)
+        text += tr(", height %1, width %2, jitter %3 RMS, %4 pk-pk")
+                    .arg(valueToString(eye.height, UNIT_VOLTS, 4))
+                    .arg(valueToString(eye.width, UNIT_SECONDS, 4))
+                    .arg(valueToString(eye.jitterRms, UNIT_SECONDS, 3))
+                    .arg(valueToString(eye.jitterPeakToPeak, UNIT_SECONDS, 3));
+    update();
+}
+
+void EyePlot::paintEvent(QPaintEvent *) {
+    QPainter painter(this);
+    painter.fillRect(rect(), colors->background);
+
+    const int textHeight = fontMetrics().height();
+    const QRectF area(0, 0, width(), height() - textHeight);
+    painter.setPen(colors->text);
+    if (image.isNull()) {
+        painter.drawText(area, Qt::AlignCenter, tr("No data"));
+        return;
+    }
+    painter.drawText(QRectF(0, height() - textHeight, width(), textHeight), Qt::AlignLeft, text);
+    painter.drawImage(area, image);
+
+    // The borders of the unit intervals and the center line of the screen
+    painter.setPen(colors->grid);
+    for (unsigned interval = 1; interval < unitIntervals; ++interval) {
+        const double x = area.left() + area.width() * interval / unitIntervals;
+        painter.drawLine(QPointF(x, area.top()), QPointF(x, area.bottom()));
+    }
+    painter.drawLine(QPointF(area.left(), area.center().y()), QPointF(area.right(), area.center().y()));
+    painter.setPen(colors->border);
+    painter.drawRect(area.adjusted(0, 0, -1, -1));
+}
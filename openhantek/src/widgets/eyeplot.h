@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <QColor>
+#include <QImage>
+#include <QWidget>
+
+#include "post/ppresult.h"
+#include "viewsettings.h"
+
+/// \brief Plots the hit density of an eye diagram as intensity.
+/// The counts are scaled logarithmically, so rare hits at the edges of the eye stay visible next to the levels.
+class EyePlot : public QWidget {
+    Q_OBJECT
+
+  public:
+    /// \param colors The colors of the background, the grid and the text.
+    explicit EyePlot(const DsoSettingsColorValues *colors, QWidget *parent = nullptr);
+
+    /// \brief Shows the density and the measurements of an eye diagram.
+    /// \param eye The accumulated eye diagram.
+    /// \param color The color of the most frequent hits.
+    void setData(const EyeDiagram &eye, QColor color);
+
+  protected:
+    void paintEvent(QPaintEvent *event) override;
+
+  private:
+    const DsoSettingsColorValues *colors;
+    QImage image;               ///< The density, one pixel per bin
+    unsigned unitIntervals = 1; ///< Shown unit intervals, for the grid
+    QString text;               ///< The measurements
+};
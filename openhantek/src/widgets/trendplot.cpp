@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+#include <cmath>
+
+#include <QDateTime>
+#include <QPainter>
+#include <QPolygonF>
+
+#include "post/measurementstatistics.h"
+#include "trendplot.h"
+
+TrendPlot::TrendPlot(const DsoSettingsColorValues *colors, QWidget *parent) : QWidget(parent), colors(colors) {
+    setMinimumSize(200, 120);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+}
+
+void TrendPlot::setData(std::vector<TrendStore::Bucket> buckets, double bucketWidth, double from, double to,
+                        Dso::Measurement measurement, QColor color) {
+    this->buckets = std::move(buckets);
+    this->bucketWidth = bucketWidth;
+    this->from = from;
+    this->to = to;
+    this->measurement = measurement;
+    this->color = color;
+    update();
+}
+
+void TrendPlot::paintEvent(QPaintEvent *) {
+    QPainter painter(this);
+    painter.fillRect(rect(), colors->background);
+
+    const int textHeight = fontMetrics().height();
+    const QRectF area(0, textHeight, width(), height() - 2 * textHeight);
+    painter.setPen(colors->text);
+    painter.drawText(QRectF(0, height() - textHeight, width(), textHeight), Qt::AlignLeft,
+                     QDateTime::fromMSecsSinceEpoch((qint64)(from * 1000.0)).toString(Qt::SystemLocaleShortDate));
+    painter.drawText(QRectF(0, height() - textHeight, width(), textHeight), Qt::AlignRight,
+                     QDateTime::fromMSecsSinceEpoch((qint64)(to * 1000.0)).toString(Qt::SystemLocaleShortDate));
+    if (buckets.empty() || to <= from) {
+        painter.drawText(area, Qt::AlignCenter, tr("No data"));
+        return;
+    }
+
+    // The maximum is printed above the plot, the minimum below. The vertical range covers all buckets with a small
+    // margin, a constant value is centered.
+    double minimum = buckets.front().minimum, maximum = buckets.front().maximum;
+    for (const TrendStore::Bucket &bucket : buckets) {
+        minimum = std::min(minimum, bucket.minimum);
+        maximum = std::max(maximum, bucket.maximum);
+    }
+    double margin = (maximum - minimum) * 0.05;
+    if (margin <= 0.0) margin = std::max(std::abs(maximum) * 0.05, 1e-12);
+    const double bottom = minimum - margin;
+    const double top = maximum + margin;
+
+    painter.drawText(QRectF(0, 0, width(), textHeight), Qt::AlignLeft,
+                     MeasurementStatistics::valueString(measurement, maximum));
+    painter.drawText(QRectF(0, height() - textHeight, width(), textHeight), Qt::AlignHCenter,
+                     MeasurementStatistics::valueString(measurement, minimum));
+
+    auto x = [&](double time) { return area.left() + (time - from) / (to - from) * area.width(); };
+    auto y = [&](double value) { return area.bottom() - (value - bottom) / (top - bottom) * area.height(); };
+
+    QColor bandColor = color;
+    bandColor.setAlpha(0x60);
+    QPolygonF mean;
+    for (const TrendStore::Bucket &bucket : buckets) {
+        const double left = std::max(x(bucket.time), area.left());
+        const double right = std::min(x(bucket.time + bucketWidth), area.right());
+        // A bucket is at least one pixel wide, so a short spike stays visible
+        const QPointF topLeft(left, y(bucket.maximum));
+        const QPointF bottomRight(std::max(right, left + 1.0), y(bucket.minimum));
+        painter.fillRect(QRectF(topLeft, bottomRight), bandColor);
+        mean << QPointF((left + right) / 2.0, y(bucket.mean()));
+    }
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(color, 1.5));
+    painter.drawPolyline(mean);
+}
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <vector>
+
+#include <QColor>
+#include <QWidget>
+
+#include "post/postprocessingsettings.h"
+#include "post/trendstore.h"
+#include "viewsettings.h"
+
+/// \brief Plots the long-term trend of a measurement.
+/// The range between minimum and maximum of each bucket is drawn as a band, the mean as a line over it.
+class TrendPlot : public QWidget {
+    Q_OBJECT
+
+  public:
+    /// \param colors The colors of the background and the text.
+    explicit TrendPlot(const DsoSettingsColorValues *colors, QWidget *parent = nullptr);
+
+    /// \brief Shows the buckets of a time range.
+    /// \param buckets The buckets, oldest first.
+    /// \param bucketWidth The length of the buckets (s).
+    /// \param from The time at the left edge (s).
+    /// \param to The time at the right edge (s).
+    /// \param measurement The measurement, it defines the unit of the values.
+    /// \param color The color of the graph.
+    void setData(std::vector<TrendStore::Bucket> buckets, double bucketWidth, double from, double to,
+                 Dso::Measurement measurement, QColor color);
+
+  protected:
+    void paintEvent(QPaintEvent *event) override;
+
+  private:
+    const DsoSettingsColorValues *colors;
+    std::vector<TrendStore::Bucket> buckets;
+    double bucketWidth = 1.0; ///< (s)
+    double from = 0.0;
+    double to = 1.0;
+    Dso::Measurement measurement = Dso::Measurement::PEAK_TO_PEAK;
+    QColor color;
+};